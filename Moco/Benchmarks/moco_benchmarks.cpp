@@ -0,0 +1,691 @@
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: moco_benchmarks.cpp                                          *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/// Benchmarks of Moco's hot paths and of end-to-end solves, for tracking
+/// performance across versions of Moco. The results are written as JSON; see
+/// the help message below.
+///
+/// Micro-benchmarks repeat a call until a minimum time has elapsed (after one
+/// untimed warm-up call). Solve benchmarks run once. The problems are based
+/// on exampleSlidingMass, example2DWalking, and testMocoInverse.
+
+#include <Moco/MocoCasADiSolver/MocoCasOCProblem.h>
+#include <Moco/osimMoco.h>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+#include <OpenSim/Actuators/CoordinateActuator.h>
+#include <OpenSim/Simulation/SimbodyEngine/SliderJoint.h>
+
+using namespace OpenSim;
+
+static const char helpMessage[] =
+        R"(Benchmarks of OpenSim Moco's hot paths and of end-to-end solves.
+
+Usage:
+  moco_benchmarks [--filter=<regex>] [--min-time=<seconds>] [--output=<file>]
+
+  --filter    Run only the benchmarks whose names match the regular
+              expression (e.g., 'MocoCasOCProblem|ThreadsafeJar' or '^solve/').
+  --min-time  Minimum time to repeat each micro-benchmark (default: 0.5).
+  --output    The JSON file to write (default: moco_benchmarks.json).
+
+Run this program from the directory containing the benchmark data files (the
+build directory for this program). Solves use the number of threads given by
+the OPENSIM_MOCO_PARALLEL environment variable.
+
+Benchmarks:
+  DeGrooteFregly2016Muscle/{curves,computeActuation}
+  MocoCasOCProblem/{explicit,implicit}/{createCasOCProblem,createGuess,
+      calcMultibodySystem,calcCostIntegrand/<goal>}
+  ThreadsafeJar/{take_leave,take_leave_contended}
+  MocoTrajectory/{write,read,resample}
+  solve/{exampleSlidingMass,example2DWalking_tracking,MocoInverse}
+)";
+
+namespace {
+
+struct BenchmarkResult {
+    std::string name;
+    bool success = true;
+    std::string error;
+    int repetitions = 0;
+    /// Total wall time of all timed repetitions (seconds).
+    double wallTime = 0;
+    /// Solver iterations (solves only).
+    int numIterations = -1;
+    /// Solver threads (solves only).
+    int numThreads = -1;
+    /// For micro-benchmarks, the total number of calls to the benchmarked
+    /// function; for solves, the optimizer's function evaluations.
+    std::vector<std::pair<std::string, long long>> evaluations;
+};
+
+class BenchmarkRunner {
+public:
+    BenchmarkRunner(std::string filter, double minTime)
+            : m_filter(std::move(filter)), m_regex(m_filter),
+              m_minTime(minTime) {}
+
+    bool isSelected(const std::string& name) const {
+        return m_filter.empty() || std::regex_search(name, m_regex);
+    }
+    /// Use this to skip the setup for a group of benchmarks.
+    bool isAnySelected(const std::vector<std::string>& names) const {
+        for (const auto& name : names) {
+            if (isSelected(name)) return true;
+        }
+        return false;
+    }
+
+    /// Each call to `func` performs `callsPerRepetition` calls of the
+    /// benchmarked function. The return value of `func` is accumulated so
+    /// that the compiler cannot optimize away the calls.
+    void runMicro(const std::string& name, int callsPerRepetition,
+            const std::function<double()>& func) {
+        if (!isSelected(name)) return;
+        std::cout << "Running " << name << "..." << std::endl;
+        BenchmarkResult result;
+        result.name = name;
+        try {
+            m_sink += func();
+            int numRepetitions = 1;
+            while (true) {
+                const Stopwatch stopwatch;
+                for (int i = 0; i < numRepetitions; ++i) m_sink += func();
+                const double elapsed = stopwatch.getElapsedTime();
+                if (elapsed >= m_minTime || numRepetitions >= (1 << 29)) {
+                    result.repetitions = numRepetitions;
+                    result.wallTime = elapsed;
+                    break;
+                }
+                numRepetitions *= 2;
+            }
+            result.evaluations.emplace_back("calls",
+                    (long long)result.repetitions * callsPerRepetition);
+        } catch (const std::exception& e) {
+            result.success = false;
+            result.error = e.what();
+        }
+        report(std::move(result));
+    }
+
+    void runSolve(const std::string& name,
+            const std::function<MocoSolution()>& solve) {
+        if (!isSelected(name)) return;
+        std::cout << "Running " << name << "..." << std::endl;
+        BenchmarkResult result;
+        result.name = name;
+        try {
+            const Stopwatch stopwatch;
+            MocoSolution solution = solve();
+            result.wallTime = stopwatch.getElapsedTime();
+            result.repetitions = 1;
+            result.success = solution.success();
+            if (!result.success) result.error = solution.getStatus();
+            solution.unseal();
+            result.numIterations = solution.getNumIterations();
+            result.numThreads = solution.getNumThreads();
+            for (const auto& function :
+                    solution.getFunctionEvaluationNames()) {
+                result.evaluations.emplace_back(function,
+                        solution.getNumFunctionEvaluations(function));
+            }
+        } catch (const std::exception& e) {
+            result.success = false;
+            result.error = e.what();
+        }
+        report(std::move(result));
+    }
+
+    void writeJSON(std::ostream& out) const {
+        out << std::setprecision(9);
+        out << "{\n";
+        out << "  \"moco_version\": " << quote(GetMocoVersion()) << ",\n";
+        out << "  \"date\": " << quote(getMocoFormattedDateTime()) << ",\n";
+        out << "  \"hardware_concurrency\": "
+            << std::thread::hardware_concurrency() << ",\n";
+        out << "  \"min_time\": " << m_minTime << ",\n";
+        out << "  \"benchmarks\": [";
+        for (int i = 0; i < (int)m_results.size(); ++i) {
+            const auto& result = m_results[i];
+            out << (i ? ",\n" : "\n") << "    {\n";
+            out << "      \"name\": " << quote(result.name) << ",\n";
+            out << "      \"success\": "
+                << (result.success ? "true" : "false") << ",\n";
+            if (!result.error.empty()) {
+                out << "      \"error\": " << quote(result.error) << ",\n";
+            }
+            out << "      \"repetitions\": " << result.repetitions << ",\n";
+            out << "      \"wall_time\": " << result.wallTime << ",\n";
+            out << "      \"wall_time_per_repetition\": "
+                << (result.repetitions ? result.wallTime / result.repetitions
+                                       : 0)
+                << ",\n";
+            if (result.numIterations != -1) {
+                out << "      \"iterations\": " << result.numIterations
+                    << ",\n";
+            }
+            if (result.numThreads != -1) {
+                out << "      \"num_threads\": " << result.numThreads
+                    << ",\n";
+            }
+            out << "      \"evaluations\": {";
+            for (int j = 0; j < (int)result.evaluations.size(); ++j) {
+                out << (j ? ", " : "") << quote(result.evaluations[j].first)
+                    << ": " << result.evaluations[j].second;
+            }
+            out << "}\n    }";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    bool allSucceeded() const {
+        for (const auto& result : m_results) {
+            if (!result.success) return false;
+        }
+        return true;
+    }
+
+private:
+    static std::string quote(const std::string& string) {
+        std::ostringstream ss;
+        ss << '"';
+        for (const char c : string) {
+            switch (c) {
+            case '"': ss << "\\\""; break;
+            case '\\': ss << "\\\\"; break;
+            case '\n': ss << "\\n"; break;
+            case '\t': ss << "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    ss << "\\u" << std::hex << std::setw(4)
+                       << std::setfill('0') << (int)c << std::dec;
+                } else {
+                    ss << c;
+                }
+            }
+        }
+        ss << '"';
+        return ss.str();
+    }
+
+    void report(BenchmarkResult result) {
+        if (result.success) {
+            std::cout << "  " << result.repetitions << " repetition(s) in "
+                      << result.wallTime << " s." << std::endl;
+        } else {
+            std::cout << "  FAILED: " << result.error << std::endl;
+        }
+        m_results.push_back(std::move(result));
+    }
+
+    std::string m_filter;
+    std::regex m_regex;
+    double m_minTime;
+    std::vector<BenchmarkResult> m_results;
+    double m_sink = 0;
+};
+
+/// Gives access to the CasOC problem that MocoCasADiSolver solves.
+class BenchmarkCasADiSolver : public MocoCasADiSolver {
+public:
+    using MocoCasADiSolver::createCasOCProblem;
+};
+
+/// The first row of a trajectory, or zeros if the trajectory does not have
+/// the expected number of columns.
+std::vector<double> getFirstRow(const SimTK::Matrix& matrix, int size) {
+    std::vector<double> row(size, 0.0);
+    if (matrix.nrow() && matrix.ncol() == size) {
+        for (int i = 0; i < size; ++i) row[i] = matrix(0, i);
+    }
+    return row;
+}
+
+CasOC::InputVector viewInput(const std::vector<double>& vec) {
+    return {vec.data(), (casadi_int)vec.size()};
+}
+
+CasOC::OutputVector viewOutput(std::vector<double>& vec) {
+    return {vec.data(), (casadi_int)vec.size()};
+}
+
+/// The problem from example2DWalking's gaitTracking(), without the
+/// periodicity goal and bounds, which do not affect the cost of evaluating
+/// the problem's functions.
+void setGaitTrackingProblem(MocoProblem& problem) {
+    problem.setModelProcessor(ModelProcessor("2D_gait.osim"));
+    problem.setTimeBounds(0, 0.47008941);
+    problem.addGoal<MocoControlGoal>("effort", 10);
+    auto* tracking = problem.addGoal<MocoStateTrackingGoal>("tracking");
+    tracking->setReference(TableProcessor("referenceCoordinates.sto") |
+                           TabOpLowPassFilter(6));
+    tracking->setAllowUnusedReferences(true);
+    auto* contact = problem.addGoal<MocoContactTrackingGoal>("contact");
+    contact->setExternalLoadsFile("referenceGRF.xml");
+    contact->addContactGroup({"contactHeel_r", "contactFront_r"}, "Right_GRF");
+    contact->addContactGroup({"contactHeel_l", "contactFront_l"}, "Left_GRF");
+    contact->setProjection("plane");
+    contact->setProjectionVector(SimTK::Vec3(0, 0, 1));
+}
+
+void benchmarkDeGrooteFregly2016Muscle(BenchmarkRunner& runner) {
+    const std::string prefix = "DeGrooteFregly2016Muscle/";
+    if (!runner.isAnySelected(
+                {prefix + "curves", prefix + "computeActuation"})) {
+        return;
+    }
+    Model model;
+    auto* body = new Body("body", 0.5, SimTK::Vec3(0), SimTK::Inertia(0));
+    model.addComponent(body);
+    auto* joint = new SliderJoint("joint", model.getGround(), *body);
+    auto& coord = joint->updCoordinate(SliderJoint::Coord::TranslationX);
+    coord.setName("x");
+    coord.setDefaultValue(0.3);
+    model.addComponent(joint);
+    auto* muscle = new DeGrooteFregly2016Muscle();
+    muscle->setName("muscle");
+    muscle->set_optimal_fiber_length(0.1);
+    muscle->set_tendon_slack_length(0.2);
+    muscle->set_max_isometric_force(1000);
+    muscle->addNewPathPoint("origin", model.updGround(), SimTK::Vec3(0));
+    muscle->addNewPathPoint("insertion", *body, SimTK::Vec3(0));
+    model.addComponent(muscle);
+    model.finalizeConnections();
+    SimTK::State state = model.initSystem();
+
+    // Each repetition evaluates each curve at 100 points.
+    const int numPoints = 100;
+    runner.runMicro(prefix + "curves", 4 * numPoints, [&]() {
+        double sum = 0;
+        for (int i = 0; i < numPoints; ++i) {
+            const double x = (double)i / numPoints;
+            sum += muscle->calcActiveForceLengthMultiplier(0.5 + x);
+            sum += muscle->calcPassiveForceMultiplier(0.5 + x);
+            sum += DeGrooteFregly2016Muscle::calcForceVelocityMultiplier(
+                    x - 0.5);
+            sum += muscle->calcTendonForceMultiplier(0.98 + 0.04 * x);
+        }
+        return sum;
+    });
+
+    // The model contains only the muscle, so realizing the model mostly
+    // measures the muscle's length, velocity, and dynamics calculations.
+    // Changing the speed ensures that these calculations are not cached.
+    int count = 0;
+    runner.runMicro(prefix + "computeActuation", 1, [&]() {
+        state.updU()[0] = 1e-3 * (count++ % 100);
+        model.realizeDynamics(state);
+        return muscle->computeActuation(state);
+    });
+}
+
+void benchmarkMocoCasOCProblem(
+        BenchmarkRunner& runner, const std::string& dynamicsMode) {
+    const std::string prefix = "MocoCasOCProblem/" + dynamicsMode + "/";
+    if (!runner.isAnySelected({prefix + "createCasOCProblem",
+                prefix + "createGuess", prefix + "calcMultibodySystem",
+                prefix + "calcCostIntegrand/effort",
+                prefix + "calcCostIntegrand/tracking",
+                prefix + "calcCostIntegrand/contact"})) {
+        return;
+    }
+    MocoProblem problem;
+    setGaitTrackingProblem(problem);
+    BenchmarkCasADiSolver solver;
+    solver.set_multibody_dynamics_mode(dynamicsMode);
+    solver.set_num_mesh_intervals(50);
+    solver.set_verbosity(0);
+    solver.resetProblem(problem);
+
+    runner.runMicro(prefix + "createCasOCProblem", 1, [&]() {
+        return (double)solver.createCasOCProblem(1)->getNumStates();
+    });
+    // This constructs the CasOC problem and the transcription.
+    runner.runMicro(prefix + "createGuess", 1,
+            [&]() { return solver.createGuess("bounds").getInitialTime(); });
+
+    // Evaluate the functions at the first point of the guess.
+    const auto casProblem = solver.createCasOCProblem(1);
+    const CasOC::Problem& cas = *casProblem;
+    const MocoTrajectory guess = solver.createGuess("bounds");
+    const double time = guess.getInitialTime();
+    const auto states =
+            getFirstRow(guess.getStatesTrajectory(), cas.getNumStates());
+    const auto controls =
+            getFirstRow(guess.getControlsTrajectory(), cas.getNumControls());
+    const auto multipliers = getFirstRow(
+            guess.getMultipliersTrajectory(), cas.getNumMultipliers());
+    const auto derivatives = getFirstRow(
+            guess.getDerivativesTrajectory(), cas.getNumDerivatives());
+    std::vector<double> parameters(cas.getNumParameters(), 0.0);
+    if (guess.getParameters().size() == cas.getNumParameters()) {
+        for (int i = 0; i < cas.getNumParameters(); ++i) {
+            parameters[i] = guess.getParameters()[i];
+        }
+    }
+    const CasOC::Problem::ContinuousInput input{time, viewInput(states),
+            viewInput(controls), viewInput(multipliers),
+            viewInput(derivatives), viewInput(parameters)};
+
+    const int numMultibody = cas.isDynamicsModeImplicit()
+                                     ? cas.getNumMultibodyDynamicsEquations()
+                                     : cas.getNumSpeeds();
+    std::vector<double> multibody(numMultibody);
+    std::vector<double> auxiliaryDerivatives(cas.getNumAuxiliaryStates());
+    std::vector<double> auxiliaryResiduals(
+            cas.getNumAuxiliaryResidualEquations());
+    std::vector<double> kinematicConstraintErrors(
+            cas.getNumKinematicConstraintEquations());
+    if (cas.isDynamicsModeImplicit()) {
+        CasOC::Problem::MultibodySystemImplicitOutput output{
+                viewOutput(multibody), viewOutput(auxiliaryDerivatives),
+                viewOutput(auxiliaryResiduals),
+                viewOutput(kinematicConstraintErrors)};
+        runner.runMicro(prefix + "calcMultibodySystem", 1, [&]() {
+            cas.calcMultibodySystemImplicit(input, true, output);
+            return multibody.empty() ? 0.0 : multibody[0];
+        });
+    } else {
+        CasOC::Problem::MultibodySystemExplicitOutput output{
+                viewOutput(multibody), viewOutput(auxiliaryDerivatives),
+                viewOutput(auxiliaryResiduals),
+                viewOutput(kinematicConstraintErrors)};
+        runner.runMicro(prefix + "calcMultibodySystem", 1, [&]() {
+            cas.calcMultibodySystemExplicit(input, true, output);
+            return multibody.empty() ? 0.0 : multibody[0];
+        });
+    }
+
+    // Goals in algebraic form are evaluated by CasADi rather than through
+    // calcCostIntegrand().
+    const auto& costInfos = cas.getCostInfos();
+    for (int i = 0; i < (int)costInfos.size(); ++i) {
+        if (!costInfos[i].integrand_function || costInfos[i].algebraic) {
+            continue;
+        }
+        runner.runMicro(prefix + "calcCostIntegrand/" + costInfos[i].name, 1,
+                [&, i]() {
+                    double integrand = 0;
+                    cas.calcCostIntegrand(i, input, integrand);
+                    return integrand;
+                });
+    }
+}
+
+void benchmarkThreadsafeJar(BenchmarkRunner& runner) {
+    const int numThreads =
+            std::max(2, (int)std::thread::hardware_concurrency());
+    ThreadsafeJar<int> jar;
+    for (int i = 0; i < numThreads; ++i) {
+        jar.leave(OpenSim::make_unique<int>(i));
+    }
+    const int numCalls = 1000;
+    auto takeAndLeave = [&jar, numCalls]() {
+        double sum = 0;
+        for (int i = 0; i < numCalls; ++i) {
+            auto entry = jar.take();
+            sum += *entry;
+            jar.leave(std::move(entry));
+        }
+        return sum;
+    };
+    runner.runMicro("ThreadsafeJar/take_leave", numCalls, takeAndLeave);
+    // All threads use the jar at once, as when CasADi evaluates the problem's
+    // functions in parallel. This includes the cost of creating the threads.
+    runner.runMicro("ThreadsafeJar/take_leave_contended",
+            numThreads * numCalls, [&]() {
+                std::vector<std::thread> threads;
+                for (int i = 0; i < numThreads; ++i) {
+                    threads.emplace_back(takeAndLeave);
+                }
+                for (auto& thread : threads) thread.join();
+                return 0.0;
+            });
+}
+
+void benchmarkMocoTrajectory(BenchmarkRunner& runner) {
+    const std::string prefix = "MocoTrajectory/";
+    if (!runner.isAnySelected(
+                {prefix + "write", prefix + "read", prefix + "resample"})) {
+        return;
+    }
+    MocoProblem problem;
+    setGaitTrackingProblem(problem);
+    MocoCasADiSolver solver;
+    solver.set_num_mesh_intervals(50);
+    solver.set_verbosity(0);
+    solver.resetProblem(problem);
+    MocoTrajectory trajectory = solver.createGuess("bounds");
+    trajectory.resampleWithNumTimes(501);
+
+    const std::string filename = "moco_benchmarks_trajectory.sto";
+    runner.runMicro(prefix + "write", 1, [&]() {
+        trajectory.write(filename);
+        return 0.0;
+    });
+    trajectory.write(filename);
+    runner.runMicro(prefix + "read", 1,
+            [&]() { return MocoTrajectory(filename).getFinalTime(); });
+    runner.runMicro(prefix + "resample", 1, [&]() {
+        MocoTrajectory copy = trajectory;
+        return copy.resampleWithNumTimes(1001);
+    });
+}
+
+MocoSolution solveSlidingMass() {
+    MocoStudy study;
+    study.setName("sliding_mass");
+    study.set_write_solution("false");
+    MocoProblem& problem = study.updProblem();
+    auto model = OpenSim::make_unique<Model>();
+    model->setName("sliding_mass");
+    model->set_gravity(SimTK::Vec3(0, 0, 0));
+    auto* body = new Body("body", 2.0, SimTK::Vec3(0), SimTK::Inertia(0));
+    model->addComponent(body);
+    auto* joint = new SliderJoint("slider", model->getGround(), *body);
+    auto& coord = joint->updCoordinate(SliderJoint::Coord::TranslationX);
+    coord.setName("position");
+    model->addComponent(joint);
+    auto* actu = new CoordinateActuator();
+    actu->setCoordinate(&coord);
+    actu->setName("actuator");
+    actu->setOptimalForce(1);
+    model->addComponent(actu);
+    model->finalizeConnections();
+    problem.setModel(std::move(model));
+    problem.setTimeBounds(MocoInitialBounds(0), MocoFinalBounds(0, 5));
+    problem.setStateInfo("/slider/position/value", MocoBounds(-5, 5),
+            MocoInitialBounds(0), MocoFinalBounds(1));
+    problem.setStateInfo("/slider/position/speed", {-50, 50}, 0, 0);
+    problem.setControlInfo("/actuator", MocoBounds(-50, 50));
+    problem.addGoal<MocoFinalTimeGoal>();
+    MocoCasADiSolver& solver = study.initCasADiSolver();
+    solver.set_num_mesh_intervals(50);
+    solver.set_verbosity(0);
+    return study.solve();
+}
+
+/// example2DWalking's gaitTracking().
+MocoSolution solve2DWalkingTracking() {
+    using SimTK::Pi;
+    MocoTrack track;
+    track.setName("gaitTracking");
+    ModelProcessor modelprocessor = ModelProcessor("2D_gait.osim");
+    track.setModel(modelprocessor);
+    track.setStatesReference(
+            TableProcessor("referenceCoordinates.sto") | TabOpLowPassFilter(6));
+    track.set_allow_unused_references(true);
+    track.set_track_reference_position_derivatives(true);
+    track.set_apply_tracked_states_to_guess(true);
+    track.set_initial_time(0.0);
+    track.set_final_time(0.47008941);
+    MocoStudy study = track.initialize();
+    study.set_write_solution("false");
+    MocoProblem& problem = study.updProblem();
+
+    auto* symmetryGoal = problem.addGoal<MocoPeriodicityGoal>("symmetryGoal");
+    Model model = modelprocessor.process();
+    model.initSystem();
+    auto swapSide = [](const std::string& name, const std::string& from,
+                            const std::string& to) {
+        return std::regex_replace(name, std::regex(from), to);
+    };
+    for (const auto& coord : model.getComponentList<Coordinate>()) {
+        const auto names = coord.getStateVariableNames();
+        for (int i = 0; i < 2; ++i) {
+            if (endsWith(coord.getName(), "_r")) {
+                symmetryGoal->addStatePair(
+                        {names[i], swapSide(names[i], "_r", "_l")});
+            } else if (endsWith(coord.getName(), "_l")) {
+                symmetryGoal->addStatePair(
+                        {names[i], swapSide(names[i], "_l", "_r")});
+            } else if (!endsWith(coord.getName(), "_tx")) {
+                symmetryGoal->addStatePair({names[i], names[i]});
+            }
+        }
+    }
+    symmetryGoal->addStatePair({"/jointset/groundPelvis/pelvis_tx/speed"});
+    symmetryGoal->addControlPair({"/lumbarAct"});
+    for (const auto& muscle : model.getComponentList<Muscle>()) {
+        const auto name = muscle.getStateVariableNames()[0];
+        if (endsWith(muscle.getName(), "_r")) {
+            symmetryGoal->addStatePair({name, swapSide(name, "_r", "_l")});
+        } else if (endsWith(muscle.getName(), "_l")) {
+            symmetryGoal->addStatePair({name, swapSide(name, "_l", "_r")});
+        }
+    }
+    auto& effort =
+            dynamic_cast<MocoControlGoal&>(problem.updGoal("control_effort"));
+    effort.setWeight(10);
+    auto* contactTracking =
+            problem.addGoal<MocoContactTrackingGoal>("contact", 1);
+    contactTracking->setExternalLoadsFile("referenceGRF.xml");
+    contactTracking->addContactGroup(
+            {"contactHeel_r", "contactFront_r"}, "Right_GRF");
+    contactTracking->addContactGroup(
+            {"contactHeel_l", "contactFront_l"}, "Left_GRF");
+    contactTracking->setProjection("plane");
+    contactTracking->setProjectionVector(SimTK::Vec3(0, 0, 1));
+
+    problem.setStateInfo("/jointset/groundPelvis/pelvis_tilt/value",
+            {-20 * Pi / 180, -10 * Pi / 180});
+    problem.setStateInfo("/jointset/groundPelvis/pelvis_tx/value", {0, 1});
+    problem.setStateInfo(
+            "/jointset/groundPelvis/pelvis_ty/value", {0.75, 1.25});
+    problem.setStateInfo("/jointset/hip_l/hip_flexion_l/value",
+            {-10 * Pi / 180, 60 * Pi / 180});
+    problem.setStateInfo("/jointset/hip_r/hip_flexion_r/value",
+            {-10 * Pi / 180, 60 * Pi / 180});
+    problem.setStateInfo(
+            "/jointset/knee_l/knee_angle_l/value", {-50 * Pi / 180, 0});
+    problem.setStateInfo(
+            "/jointset/knee_r/knee_angle_r/value", {-50 * Pi / 180, 0});
+    problem.setStateInfo("/jointset/ankle_l/ankle_angle_l/value",
+            {-15 * Pi / 180, 25 * Pi / 180});
+    problem.setStateInfo("/jointset/ankle_r/ankle_angle_r/value",
+            {-15 * Pi / 180, 25 * Pi / 180});
+    problem.setStateInfo("/jointset/lumbar/lumbar/value", {0, 20 * Pi / 180});
+
+    auto& solver = study.updSolver<MocoCasADiSolver>();
+    solver.set_num_mesh_intervals(50);
+    solver.set_verbosity(0);
+    solver.set_optim_solver("ipopt");
+    solver.set_optim_convergence_tolerance(1e-4);
+    solver.set_optim_constraint_tolerance(1e-4);
+    solver.set_optim_max_iterations(1000);
+    return study.solve();
+}
+
+/// The problem from testMocoInverse.
+MocoSolution solveMocoInverse() {
+    MocoInverse inverse;
+    ModelProcessor modelProcessor =
+            ModelProcessor("subject_walk_armless_18musc.osim") |
+            ModOpReplaceJointsWithWelds(
+                    {"subtalar_r", "subtalar_l", "mtp_r", "mtp_l"}) |
+            ModOpReplaceMusclesWithDeGrooteFregly2016() |
+            ModOpIgnorePassiveFiberForcesDGF() |
+            ModOpTendonComplianceDynamicsModeDGF("implicit") |
+            ModOpAddExternalLoads("subject_walk_armless_external_loads.xml");
+    inverse.setModel(modelProcessor);
+    inverse.setKinematics(
+            TableProcessor("subject_walk_armless_coordinates.mot") |
+            TabOpLowPassFilter(6));
+    inverse.set_initial_time(0.450);
+    inverse.set_final_time(1.0);
+    inverse.set_kinematics_allow_extra_columns(true);
+    inverse.set_mesh_interval(0.05);
+    return inverse.solve().getMocoSolution();
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        std::string filter;
+        double minTime = 0.5;
+        std::string output = "moco_benchmarks.json";
+        for (int iarg = 1; iarg < argc; ++iarg) {
+            const std::string arg(argv[iarg]);
+            const std::string value = arg.substr(arg.find("=") + 1);
+            if (arg == "-h" || arg == "--help") {
+                std::cout << helpMessage << std::endl;
+                return EXIT_SUCCESS;
+            } else if (startsWith(arg, "--filter=")) {
+                filter = value;
+            } else if (startsWith(arg, "--min-time=")) {
+                minTime = std::stod(value);
+            } else if (startsWith(arg, "--output=")) {
+                output = value;
+            } else {
+                OPENSIM_THROW(Exception,
+                        format("Unrecognized argument '%s'. See usage with "
+                               "-h or --help.",
+                                arg));
+            }
+        }
+
+        BenchmarkRunner runner(filter, minTime);
+        benchmarkDeGrooteFregly2016Muscle(runner);
+        benchmarkMocoCasOCProblem(runner, "explicit");
+        benchmarkMocoCasOCProblem(runner, "implicit");
+        benchmarkThreadsafeJar(runner);
+        benchmarkMocoTrajectory(runner);
+        runner.runSolve("solve/exampleSlidingMass", solveSlidingMass);
+        runner.runSolve(
+                "solve/example2DWalking_tracking", solve2DWalkingTracking);
+        runner.runSolve("solve/MocoInverse", solveMocoInverse);
+
+        std::ofstream file(output);
+        OPENSIM_THROW_IF(!file, Exception,
+                format("Could not open '%s' for writing.", output));
+        runner.writeJSON(file);
+        std::cout << "Wrote '" << output << "'." << std::endl;
+        return runner.allSucceeded() ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -32,6 +32,7 @@
 #include <Moco/MocoInverse.h>
 #include <Moco/MocoParameter.h>
 #include <Moco/MocoProblem.h>
+#include <Moco/MocoStage.h>
 #include <Moco/MocoStudy.h>
 #include <Moco/MocoStudyFactory.h>
 #include <Moco/MocoTrack.h>
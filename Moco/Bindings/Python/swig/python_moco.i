@@ -1,5 +1,4 @@
-%module(package="opensim", directors="1") moco
-// %module(package="opensim", directors="1", threads="1") moco
+%module(package="opensim", directors="1", threads="1") moco
 #pragma SWIG nowarn=822,451,503,516,325
 #pragma SWIG nowarn=401
 
@@ -47,6 +46,16 @@ using namespace SimTK;
     }
 }
 
+// Thread support
+// ==============
+// The module is built with thread support so that long-running calls release
+// the Global Interpreter Lock (GIL), allowing other Python threads (e.g., other
+// solves in a concurrent.futures.ThreadPoolExecutor) to run. Releasing the GIL
+// has a small cost, so by default, calls keep the GIL; the calls that release
+// it are listed below, before the OpenSim headers are included. SWIG's
+// director methods re-acquire the GIL before calling Python code.
+%nothread;
+
 // Typemaps
 // ========
 // None.
@@ -392,6 +401,169 @@ using namespace SimTK;
 %};
 }
 
+// Zero-copy NumPy views
+// =====================
+// The get...View() functions return read-only NumPy arrays that share memory
+// with the C++ object instead of copying the data. Each array holds a
+// reference to the Python object that owns the data, so the data remains
+// valid as long as the array exists. However, the array is invalidated if the
+// C++ object resizes its data (e.g., MocoTrajectory::setNumTimes() or
+// resample()).
+%{
+PyObject* mocoCreateNumPyView(PyObject* owner, const double* data,
+        int nrow, int ncol, npy_intp rowStride, npy_intp colStride) {
+    npy_intp dims[2] = {nrow, ncol};
+    npy_intp strides[2] = {rowStride * (npy_intp)sizeof(double),
+                           colStride * (npy_intp)sizeof(double)};
+    const int nd = ncol == -1 ? 1 : 2;
+    if (nrow == 0 || ncol == 0 || !data) {
+        return PyArray_ZEROS(nd, dims, NPY_DOUBLE, 1);
+    }
+    PyObject* array = PyArray_New(&PyArray_Type, nd, dims, NPY_DOUBLE,
+            strides, const_cast<double*>(data), 0, NPY_ARRAY_ALIGNED, NULL);
+    if (!array) return NULL;
+    Py_INCREF(owner);
+    if (PyArray_SetBaseObject((PyArrayObject*)array, owner) < 0) {
+        Py_DECREF(array);
+        return NULL;
+    }
+    return array;
+}
+PyObject* mocoCreateNumPyView(PyObject* owner, const SimTK::MatrixView& m) {
+    const int nrow = m.nrow();
+    const int ncol = m.ncol();
+    if (nrow == 0 || ncol == 0) {
+        return mocoCreateNumPyView(owner, NULL, nrow, ncol, 1, 1);
+    }
+    const double* data = &m(0, 0);
+    return mocoCreateNumPyView(owner, data, nrow, ncol,
+            nrow > 1 ? &m(1, 0) - data : ncol,
+            ncol > 1 ? &m(0, 1) - data : 1);
+}
+PyObject* mocoCreateNumPyView(PyObject* owner, const SimTK::VectorView& v) {
+    const int size = v.size();
+    if (size == 0) return mocoCreateNumPyView(owner, NULL, 0, -1, 1, 1);
+    return mocoCreateNumPyView(owner, &v[0], size, -1,
+            size > 1 ? &v[1] - &v[0] : 1, 1);
+}
+// Copy a C-ordered NumPy matrix into the trajectory, one variable (column)
+// at a time.
+template <typename SetFunc>
+void mocoSetTrajectoryFromNumPy(const OpenSim::MocoTrajectory& traj,
+        const std::vector<std::string>& names, int nrow, int ncol,
+        const double* data, SetFunc set) {
+    OPENSIM_THROW_IF(nrow != traj.getNumTimes(), OpenSim::Exception,
+            "Expected the number of rows to be getNumTimes().");
+    OPENSIM_THROW_IF(ncol != (int)names.size(), OpenSim::Exception,
+            "Expected the number of columns to be the number of variables.");
+    SimTK::Vector column(nrow);
+    for (int icol = 0; icol < ncol; ++icol) {
+        for (int irow = 0; irow < nrow; ++irow) {
+            column[irow] = data[irow * ncol + icol];
+        }
+        set(names[icol], column);
+    }
+}
+%}
+%extend OpenSim::MocoTrajectory {
+    PyObject* _getTimeView(PyObject* owner) const {
+        return mocoCreateNumPyView(owner, $self->getTime());
+    }
+    PyObject* _getStatesTrajectoryView(PyObject* owner) const {
+        return mocoCreateNumPyView(owner, $self->getStatesTrajectory());
+    }
+    PyObject* _getControlsTrajectoryView(PyObject* owner) const {
+        return mocoCreateNumPyView(owner, $self->getControlsTrajectory());
+    }
+    PyObject* _getMultipliersTrajectoryView(PyObject* owner) const {
+        return mocoCreateNumPyView(owner, $self->getMultipliersTrajectory());
+    }
+    PyObject* _getDerivativesTrajectoryView(PyObject* owner) const {
+        return mocoCreateNumPyView(owner, $self->getDerivativesTrajectory());
+    }
+    void setTimeMat(int ntime, double* time) {
+        $self->setTime(SimTK::Vector(ntime, time, true));
+    }
+    void setStatesTrajectoryMat(
+            int nrowstates, int ncolstates, double* states) {
+        auto* traj = $self;
+        mocoSetTrajectoryFromNumPy(*traj, traj->getStateNames(), nrowstates,
+                ncolstates, states,
+                [traj](const std::string& name, const SimTK::Vector& v) {
+                    traj->setState(name, v);
+                });
+    }
+    void setControlsTrajectoryMat(
+            int nrowcontrols, int ncolcontrols, double* controls) {
+        auto* traj = $self;
+        mocoSetTrajectoryFromNumPy(*traj, traj->getControlNames(),
+                nrowcontrols, ncolcontrols, controls,
+                [traj](const std::string& name, const SimTK::Vector& v) {
+                    traj->setControl(name, v);
+                });
+    }
+    void setMultipliersTrajectoryMat(
+            int nrowmults, int ncolmults, double* mults) {
+        auto* traj = $self;
+        mocoSetTrajectoryFromNumPy(*traj, traj->getMultiplierNames(),
+                nrowmults, ncolmults, mults,
+                [traj](const std::string& name, const SimTK::Vector& v) {
+                    traj->setMultiplier(name, v);
+                });
+    }
+    void setDerivativesTrajectoryMat(
+            int nrowderivs, int ncolderivs, double* derivs) {
+        auto* traj = $self;
+        mocoSetTrajectoryFromNumPy(*traj, traj->getDerivativeNames(),
+                nrowderivs, ncolderivs, derivs,
+                [traj](const std::string& name, const SimTK::Vector& v) {
+                    traj->setDerivative(name, v);
+                });
+    }
+%pythoncode %{
+    def getTimeView(self):
+        """Read-only NumPy view of the time vector (no copy)."""
+        return self._getTimeView(self)
+    def getStatesTrajectoryView(self):
+        """Read-only NumPy view (time x states) of the states (no copy)."""
+        return self._getStatesTrajectoryView(self)
+    def getControlsTrajectoryView(self):
+        """Read-only NumPy view (time x controls) of the controls (no
+        copy)."""
+        return self._getControlsTrajectoryView(self)
+    def getMultipliersTrajectoryView(self):
+        """Read-only NumPy view (time x multipliers) of the multipliers (no
+        copy)."""
+        return self._getMultipliersTrajectoryView(self)
+    def getDerivativesTrajectoryView(self):
+        """Read-only NumPy view (time x derivatives) of the derivatives (no
+        copy)."""
+        return self._getDerivativesTrajectoryView(self)
+%};
+}
+%inline %{
+PyObject* _getTableMatrixView(
+        const OpenSim::TimeSeriesTable& table, PyObject* owner) {
+    return mocoCreateNumPyView(owner, table.getMatrix());
+}
+PyObject* _getTableIndependentColumnView(
+        const OpenSim::TimeSeriesTable& table, PyObject* owner) {
+    const auto& time = table.getIndependentColumn();
+    return mocoCreateNumPyView(
+            owner, time.data(), (int)time.size(), -1, 1, 1);
+}
+%}
+%pythoncode %{
+def getTableMatrixView(table):
+    """Read-only NumPy view (rows x columns) of a TimeSeriesTable's data (no
+    copy). The view is invalidated if rows or columns are added to or removed
+    from the table."""
+    return _getTableMatrixView(table, table)
+def getTableIndependentColumnView(table):
+    """Read-only NumPy view of a TimeSeriesTable's times (no copy)."""
+    return _getTableIndependentColumnView(table, table)
+%}
+
 // Memory management
 // =================
 
@@ -427,9 +599,24 @@ using namespace SimTK;
 %}
 
 
+// Release the GIL during these calls (see "Thread support" above).
+%thread OpenSim::MocoStudy::solve;
+%thread OpenSim::MocoStudy::visualize;
+%thread OpenSim::MocoStudy::analyze;
+%thread OpenSim::MocoTrack::initialize;
+%thread OpenSim::MocoTrack::solve;
+%thread OpenSim::MocoInverse::initialize;
+%thread OpenSim::MocoInverse::solve;
+%thread OpenSim::MocoCasADiSolver::createGuess;
+%thread OpenSim::MocoTropterSolver::createGuess;
+%thread OpenSim::TableProcessor::process;
+%thread OpenSim::ModelProcessor::process;
+%thread OpenSim::simulateTrajectoryWithTimeStepping;
+%thread OpenSim::simulateTrajectoriesWithTimeStepping;
+%thread OpenSim::analyze;
+%thread OpenSim::visualize;
+
 // Include all the OpenSim code.
 // =============================
 %include <Bindings/preliminaries.i>
 %include <Bindings/moco.i>
-
-// %thread OpenSim::MocoStudy::solve;
@@ -4,6 +4,8 @@ make to the C++ API, via the SWIG interface (*.i) file.
 """
 
 import os
+import threading
+import time
 import unittest
 from math import isnan
 
@@ -216,6 +218,63 @@ class TestSwigAddtlInterface(unittest.TestCase):
         assert (it.getDerivativesTrajectoryMat() == dt).all()
         assert (it.getParametersMat() == p).all()
 
+    def test_MocoTrajectory_numpy_views(self):
+        try:
+            import numpy as np
+        except ImportError as e:
+            print("Could not import numpy; skipping test.")
+            return
+        import gc
+
+        time = np.linspace(0, 0.2, 3)
+        st = np.random.rand(3, 2)
+        ct = np.random.rand(3, 3)
+        mt = np.random.rand(3, 1)
+        p = np.random.rand(2)
+        it = osim.MocoTrajectory(time, ['s0', 's1'], ['c0', 'c1', 'c2'],
+                                 ['m0'], ['p0', 'p1'], st, ct, mt, p)
+        timeView = it.getTimeView()
+        statesView = it.getStatesTrajectoryView()
+        assert (timeView == time).all()
+        assert (statesView == st).all()
+        assert (it.getControlsTrajectoryView() == ct).all()
+        assert (it.getMultipliersTrajectoryView() == mt).all()
+        assert not statesView.flags.writeable
+        # The views share memory with the trajectory.
+        assert np.shares_memory(statesView, it.getStatesTrajectoryView())
+
+        # Bulk setters are reflected in existing views.
+        newStates = np.random.rand(3, 2)
+        it.setStatesTrajectoryMat(newStates)
+        assert (statesView == newStates).all()
+        newControls = np.asfortranarray(np.random.rand(3, 3))
+        it.setControlsTrajectoryMat(newControls)
+        assert (it.getControlsTrajectoryMat() == newControls).all()
+        newTime = np.linspace(0, 0.4, 3)
+        it.setTimeMat(newTime)
+        assert (timeView == newTime).all()
+        with self.assertRaises(RuntimeError):
+            it.setStatesTrajectoryMat(np.random.rand(3, 5))
+
+        # The views keep the trajectory alive.
+        del it
+        gc.collect()
+        assert (statesView == newStates).all()
+        assert (timeView == newTime).all()
+
+        table = osim.TimeSeriesTable()
+        table.setColumnLabels(['a', 'b'])
+        row = osim.RowVector(2)
+        for i in range(4):
+            row[0] = i
+            row[1] = 10 * i
+            table.appendRow(0.1 * i, row)
+        tableView = osim.getTableMatrixView(table)
+        assert tableView.shape == (4, 2)
+        assert (tableView[:, 1] == 10 * np.arange(4)).all()
+        assert np.allclose(osim.getTableIndependentColumnView(table),
+                           0.1 * np.arange(4))
+
     def test_createRep(self):
         model = osim.Model()
         model.setName('sliding_mass')
@@ -366,3 +425,52 @@ class TestWorkflow(unittest.TestCase):
         # Change the weights of the costs.
         effort.setWeight(0.1)
         assert(study.solve().getFinalTime() < 0.8 * finalTime0)
+
+    def test_solve_releases_gil(self):
+        try:
+            from concurrent.futures import ThreadPoolExecutor
+        except ImportError:
+            # Python 2 without the futures backport.
+            return
+
+        def create_study():
+            study = osim.MocoStudy()
+            problem = study.updProblem()
+            problem.setModel(createSlidingMassModel())
+            problem.setTimeBounds(0, [0, 10])
+            problem.setStateInfo("/slider/position/value", [0, 1], 0, 1)
+            problem.setStateInfo("/slider/position/speed", [-100, 100], 0, 0)
+            problem.addGoal(osim.MocoFinalTimeGoal())
+            solver = study.initCasADiSolver()
+            solver.set_num_mesh_intervals(50)
+            solver.set_parallel(0)
+            solver.set_verbosity(0)
+            return study
+
+        # Another Python thread runs while the main thread is solving.
+        stamps = []
+        done = threading.Event()
+        def record():
+            while not done.is_set():
+                stamps.append(time.time())
+                time.sleep(0.001)
+        recorder = threading.Thread(target=record)
+        study = create_study()
+        recorder.start()
+        start = time.time()
+        solution = study.solve()
+        end = time.time()
+        done.set()
+        recorder.join()
+        assert(solution.success())
+        third = (end - start) / 3.0
+        assert(any(start + third < t < end - third for t in stamps))
+
+        # Solves run concurrently from a thread pool.
+        studies = [create_study() for i in range(3)]
+        with ThreadPoolExecutor(max_workers=3) as executor:
+            solutions = list(executor.map(lambda s: s.solve(), studies))
+        for sol in solutions:
+            assert(sol.success())
+            self.assertAlmostEqual(sol.getFinalTime(),
+                                   solution.getFinalTime(), places=6)
@@ -24,6 +24,7 @@ namespace OpenSim {
 namespace OpenSim {
     %ignore MocoGoal::GoalInput;
     %ignore MocoGoal::calcGoal;
+    %ignore MocoGoal::getAlgebraicForm;
 }
 %include <Moco/MocoGoal/MocoGoal.h>
 %template(SetMocoWeight) OpenSim::Set<OpenSim::MocoWeight, OpenSim::Object>;
@@ -56,6 +57,7 @@ namespace OpenSim {
 %ignore OpenSim::MocoConstraintInfo::getBounds;
 %ignore OpenSim::MocoConstraintInfo::setBounds;
 %ignore OpenSim::MocoProblemRep::getMultiplierInfos;
+%ignore OpenSim::MocoPathConstraint::getAlgebraicForm;
 
 %include <Moco/MocoConstraint.h>
 
@@ -204,11 +206,13 @@ namespace OpenSim {
 }
 %include <Moco/MocoTropterSolver.h>
 %include <Moco/MocoCasADiSolver/MocoCasADiSolver.h>
+%include <Moco/MocoStage.h>
 %include <Moco/MocoStudy.h>
 %include <Moco/MocoStudyFactory.h>
 
 %include <Moco/MocoTool.h>
 %include <Moco/MocoInverse.h>
+%ignore OpenSim::MocoTrack::solveRecedingHorizon;
 %include <Moco/MocoTrack.h>
 
 %include <Moco/Components/DeGrooteFregly2016Muscle.h>
@@ -18,8 +18,23 @@
 #include <Moco/About.h>
 #include <Moco/MocoProblem.h>
 #include <Moco/MocoStudy.h>
+#include <Moco/MocoThreadBudget.h>
 #include <Moco/MocoUtilities.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#ifndef _WIN32
+#    include <csignal>
+#    include <glob.h>
+#    include <sys/wait.h>
+#endif
 
 #include <OpenSim/Common/Object.h>
 #include <OpenSim/Common/LoadOpenSimLibrary.h>
@@ -37,8 +52,26 @@ Usage:
   opensim-moco -V | --version
     Print Moco's version.
 
-  opensim-moco [--library=<path>] run [--visualize] <.omoco-file>
+  opensim-moco [--library=<path>] run [--visualize] [--cache-dir=<dir>]
+          [--num-threads=<n>] <.omoco-file>
     Run the MocoStudy in the provided .omoco file.
+    With --cache-dir, successful solutions are stored in the given directory,
+    and a solution is read from the directory instead of solving if the
+    study (including the files it references) has been solved before.
+    With --num-threads, the study uses at most n threads.
+
+  opensim-moco [--library=<path>] batch [--cores=<n>] [--threads-per-study=<n>]
+          [--log=<file>] [--cache-dir=<dir>] <input>...
+    Run many MocoStudy files, each in its own process. An input is an .omoco
+    file, a glob pattern (e.g., 'subject*/*.omoco'; not on Windows), or a
+    .txt file listing one .omoco file per line (relative to the working
+    directory).
+    Studies run concurrently, each with --threads-per-study threads (default:
+    1), such that at most --cores cores (default: all) are used in total.
+    The output of each study is written to <.omoco-file>.log.
+    Completed studies are recorded in the job log (default:
+    opensim-moco-batch.log); rerunning the same command skips them, so an
+    interrupted batch resumes where it stopped. Delete the log to rerun all.
 
   opensim-moco [--library=<path>] print-xml
     Print a template XML .omoco file for a MocoStudy.
@@ -53,7 +86,10 @@ Usage:
 
 )";
 
-void run_tool(std::string setupFile, bool visualize) {
+void run_tool(std::string setupFile, bool visualize, std::string cacheDir,
+        int numThreads) {
+
+    if (numThreads != -1) MocoThreadBudget::setNumCores(numThreads);
 
     auto obj = std::unique_ptr<Object>(Object::makeObjectFromFile(setupFile));
 
@@ -61,7 +97,8 @@ void run_tool(std::string setupFile, bool visualize) {
             format("A problem occurred when trying to load file '%s'.",
                     setupFile));
 
-    if (const auto* moco = dynamic_cast<const MocoStudy*>(obj.get())) {
+    if (auto* moco = dynamic_cast<MocoStudy*>(obj.get())) {
+        moco->setCacheDir(cacheDir);
         auto solution = moco->solve();
         if (visualize) moco->visualize(solution);
     } else {
@@ -71,6 +108,197 @@ void run_tool(std::string setupFile, bool visualize) {
     }
 }
 
+int parse_positive_int(const std::string& option) {
+    const std::string value = option.substr(option.find("=") + 1);
+    int number = 0;
+    try {
+        number = std::stoi(value);
+    } catch (const std::exception&) {}
+    OPENSIM_THROW_IF(number < 1, Exception,
+            format("Expected a positive integer in '%s'.", option));
+    return number;
+}
+
+/// Quote an argument for the shell used by std::system(), so that the shell
+/// passes it on unchanged.
+std::string quote(const std::string& arg) {
+#ifdef _WIN32
+    // cmd.exe has no way to escape a double quote within a quoted argument.
+    OPENSIM_THROW_IF(arg.find('"') != std::string::npos, Exception,
+            format("Arguments cannot contain double quotes: '%s'.", arg));
+    return "\"" + arg + "\"";
+#else
+    // Nothing is special within single quotes; a single quote is written by
+    // closing the quotes, escaping the quote, and reopening the quotes.
+    std::string quoted = "'";
+    for (const char c : arg) {
+        if (c == '\'') {
+            quoted += "'\\''";
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "'";
+#endif
+}
+
+std::vector<std::string> expand_batch_inputs(
+        const std::vector<std::string>& inputs) {
+    std::vector<std::string> files;
+    for (const auto& input : inputs) {
+        if (endsWith(input, ".txt")) {
+            std::ifstream list(input);
+            OPENSIM_THROW_IF(!list, Exception,
+                    format("Could not open the list file '%s'.", input));
+            std::string line;
+            while (std::getline(list, line)) {
+                const auto begin = line.find_first_not_of(" \t\r");
+                if (begin == std::string::npos || line[begin] == '#') continue;
+                const auto end = line.find_last_not_of(" \t\r");
+                files.push_back(line.substr(begin, end - begin + 1));
+            }
+#ifndef _WIN32
+        } else if (input.find_first_of("*?[") != std::string::npos) {
+            // The shell did not expand the pattern (e.g., it was quoted).
+            glob_t matches;
+            if (glob(input.c_str(), 0, nullptr, &matches) == 0) {
+                for (size_t i = 0; i < matches.gl_pathc; ++i) {
+                    files.push_back(matches.gl_pathv[i]);
+                }
+            }
+            globfree(&matches);
+#endif
+        } else {
+            files.push_back(input);
+        }
+    }
+    // Use absolute paths so that the job log does not depend on how a file
+    // was specified, and remove duplicates.
+    std::vector<std::string> unique;
+    std::set<std::string> seen;
+    for (const auto& file : files) {
+        auto path = SimTK::Pathname::getAbsolutePathname(file);
+        if (seen.insert(path).second) unique.push_back(path);
+    }
+    return unique;
+}
+
+/// Returns true if all studies succeeded.
+bool batch(const std::string& executable, const std::string& library,
+        const std::vector<std::string>& inputs, int numCores,
+        int threadsPerStudy, const std::string& logFile,
+        const std::string& cacheDir) {
+    using Clock = std::chrono::steady_clock;
+    const auto files = expand_batch_inputs(inputs);
+    OPENSIM_THROW_IF(files.empty(), Exception, "No .omoco files provided.");
+
+    // Each line of the job log is "done<tab><seconds><tab><file>".
+    std::set<std::string> done;
+    {
+        std::ifstream log(logFile);
+        std::string status, file;
+        double seconds;
+        while (log >> status >> seconds && std::getline(log >> std::ws, file)) {
+            if (status == "done") done.insert(file);
+        }
+    }
+    std::vector<std::string> pending;
+    for (const auto& file : files) {
+        if (!done.count(file)) pending.push_back(file);
+    }
+    const int numSkipped = (int)(files.size() - pending.size());
+    const int numWorkers = std::max(1,
+            std::min((int)pending.size(), numCores / threadsPerStudy));
+    std::cout << "Running " << pending.size() << " of " << files.size()
+              << " studies (" << numSkipped << " already done according to '"
+              << logFile << "') with " << numWorkers << " processes of "
+              << threadsPerStudy << " thread(s) each." << std::endl;
+
+    std::ofstream log(logFile, std::ios::app);
+    OPENSIM_THROW_IF(!log, Exception,
+            format("Could not open the job log '%s'.", logFile));
+    std::mutex mutex;
+    std::atomic<int> next(0);
+    std::atomic<bool> interrupted(false);
+    int numFinished = 0;
+    int numFailed = 0;
+    double totalStudySeconds = 0;
+    auto worker = [&]() {
+        int index;
+        while (!interrupted && (index = next++) < (int)pending.size()) {
+            const auto& file = pending[index];
+            std::string command = quote(executable);
+            if (!library.empty()) {
+                command += " " + quote("--library=" + library);
+            }
+            command += " run --num-threads=" + std::to_string(threadsPerStudy);
+            if (!cacheDir.empty()) {
+                command += " " + quote("--cache-dir=" + cacheDir);
+            }
+            command += " " + quote(file) + " > " + quote(file + ".log") +
+                       " 2>&1";
+#ifdef _WIN32
+            // cmd.exe strips the first and last quotes of the command.
+            command = "\"" + command + "\"";
+#endif
+            const auto start = Clock::now();
+            const int status = std::system(command.c_str());
+            const double seconds =
+                    std::chrono::duration<double>(Clock::now() - start)
+                            .count();
+#ifndef _WIN32
+            // std::system() ignores SIGINT in this process while the study
+            // runs; stop the batch if the user interrupted the study.
+            if (status != -1 &&
+                    ((WIFSIGNALED(status) && WTERMSIG(status) == SIGINT) ||
+                            (WIFEXITED(status) &&
+                                    WEXITSTATUS(status) == 128 + SIGINT))) {
+                interrupted = true;
+                return;
+            }
+#endif
+            const bool success = status == 0;
+            std::lock_guard<std::mutex> lock(mutex);
+            ++numFinished;
+            totalStudySeconds += seconds;
+            if (success) {
+                log << "done\t" << seconds << "\t" << file << std::endl;
+            } else {
+                ++numFailed;
+            }
+            std::cout << "[" << numFinished << "/" << pending.size() << "] "
+                      << (success ? "done" : "FAILED") << " in " << seconds
+                      << " s: " << file << std::endl;
+        }
+    };
+    const auto start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < numWorkers; ++i) workers.emplace_back(worker);
+    for (auto& thread : workers) thread.join();
+    const double wallSeconds =
+            std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << "\nFinished " << numFinished << " studies (" << numFailed
+              << " failed) in " << wallSeconds << " s." << std::endl;
+    if (numFinished) {
+        std::cout << "Mean time per study: "
+                  << totalStudySeconds / numFinished << " s." << std::endl;
+        std::cout << "Throughput: " << 3600.0 * numFinished / wallSeconds
+                  << " studies per hour." << std::endl;
+        std::cout << "Mean number of concurrent studies: "
+                  << totalStudySeconds / wallSeconds << "." << std::endl;
+    }
+    if (interrupted) {
+        std::cout << "Interrupted; rerun the command to resume." << std::endl;
+    }
+    if (numFailed) {
+        std::cout << "Failed studies are not recorded in '" << logFile
+                  << "' and are rerun when resuming; see their .log files."
+                  << std::endl;
+    }
+    return numFailed == 0 && !interrupted;
+}
+
 void print_xml() {
     const auto* obj = Object::getDefaultInstanceOfType("MocoStudy");
     if (!obj) {
@@ -118,6 +346,7 @@ int main(int argc, char* argv[]) {
 
         std::string arg1(argv[1]);
         std::string subcommand;
+        std::string library;
         int offset = 0;
         if (arg1 == "-h" || arg1 == "--help") {
             std::cout << helpMessage << std::endl;
@@ -126,7 +355,8 @@ int main(int argc, char* argv[]) {
             std::cout << OpenSim::GetMocoVersion() << std::endl;
             return EXIT_SUCCESS;
         } else if (startsWith(arg1, "--library=")) {
-            OpenSim::LoadOpenSimLibraryExact(arg1.substr(arg1.find("=") + 1));
+            library = arg1.substr(arg1.find("=") + 1);
+            OpenSim::LoadOpenSimLibraryExact(library);
             subcommand = argv[2];
             // Pretend we didn't get a library argument.
             --argc;
@@ -136,23 +366,63 @@ int main(int argc, char* argv[]) {
         }
 
         if (subcommand == "run") {
-            OPENSIM_THROW_IF(argc < 3 || argc > 4, Exception,
+            OPENSIM_THROW_IF(argc < 3 || argc > 6, Exception,
                     "Incorrect number of arguments.");
 
-            std::string arg2(argv[2 + offset]);
-            OPENSIM_THROW_IF(argc == 4 && arg2 != "--visualize", Exception,
-                    format("Unrecognized option '%s'; did you mean "
-                           "'--visualize'?",
-                            arg2));
-            std::string setupFile;
             bool visualize = false;
-            if (argc == 3) {
-                setupFile = arg2;
-            } else {
-                setupFile = std::string(argv[3 + offset]);
-                visualize = true;
+            std::string cacheDir;
+            int numThreads = -1;
+            for (int iarg = 2; iarg < argc - 1; ++iarg) {
+                std::string option(argv[iarg + offset]);
+                if (option == "--visualize") {
+                    visualize = true;
+                } else if (startsWith(option, "--cache-dir=")) {
+                    cacheDir = option.substr(option.find("=") + 1);
+                    OPENSIM_THROW_IF(cacheDir.empty(), Exception,
+                            "Expected a directory after '--cache-dir='.");
+                } else if (startsWith(option, "--num-threads=")) {
+                    numThreads = parse_positive_int(option);
+                } else {
+                    OPENSIM_THROW(Exception,
+                            format("Unrecognized option '%s'; did you mean "
+                                   "'--visualize', '--cache-dir=<dir>', or "
+                                   "'--num-threads=<n>'?",
+                                    option));
+                }
+            }
+            std::string setupFile(argv[argc - 1 + offset]);
+            run_tool(setupFile, visualize, cacheDir, numThreads);
+
+        } else if (subcommand == "batch") {
+            OPENSIM_THROW_IF(argc < 3, Exception,
+                    "Incorrect number of arguments.");
+
+            int numCores = MocoThreadBudget::getNumCores();
+            int threadsPerStudy = 1;
+            std::string logFile = "opensim-moco-batch.log";
+            std::string cacheDir;
+            std::vector<std::string> inputs;
+            for (int iarg = 2; iarg < argc; ++iarg) {
+                std::string arg(argv[iarg + offset]);
+                if (startsWith(arg, "--cores=")) {
+                    numCores = parse_positive_int(arg);
+                } else if (startsWith(arg, "--threads-per-study=")) {
+                    threadsPerStudy = parse_positive_int(arg);
+                } else if (startsWith(arg, "--log=")) {
+                    logFile = arg.substr(arg.find("=") + 1);
+                } else if (startsWith(arg, "--cache-dir=")) {
+                    cacheDir = arg.substr(arg.find("=") + 1);
+                } else if (startsWith(arg, "--")) {
+                    OPENSIM_THROW(Exception,
+                            format("Unrecognized option '%s'.", arg));
+                } else {
+                    inputs.push_back(arg);
+                }
+            }
+            if (!batch(argv[0], library, inputs, numCores, threadsPerStudy,
+                        logFile, cacheDir)) {
+                return EXIT_FAILURE;
             }
-            run_tool(setupFile, visualize);
 
         } else if (subcommand == "print-xml") {
             OPENSIM_THROW_IF(
@@ -0,0 +1,170 @@
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: TableProcessor.cpp                                           *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia, Nicholas Bianco, Prasanna Sritharan         *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "TableProcessor.h"
+
+using namespace OpenSim;
+
+TimeSeriesTable TableProcessor::process(
+        std::string relativeToDirectory, const Model* model) const {
+    TimeSeriesTable table;
+    if (get_filepath().empty()) {
+        if (m_tableProvided) {
+            table = m_table;
+        } else {
+            OPENSIM_THROW_FRMOBJ(Exception, "No source table.");
+        }
+    } else {
+        OPENSIM_THROW_IF_FRMOBJ(m_tableProvided, Exception,
+                "Expected either an in-memory table or a filepath, but "
+                "both were provided.");
+        std::string path = get_filepath();
+        if (!relativeToDirectory.empty()) {
+            using SimTK::Pathname;
+            path = Pathname::getAbsolutePathnameUsingSpecifiedWorkingDirectory(
+                    relativeToDirectory, path);
+        }
+        table = TimeSeriesTable(path);
+    }
+
+    if (table.hasTableMetaDataKey("inDegrees") &&
+            table.getTableMetaDataAsString("inDegrees") == "yes") {
+        model->getSimbodyEngine().convertDegreesToRadians(table);
+    }
+
+    const int numOperators = getProperty_operators().size();
+    int i = 0;
+    while (i < numOperators) {
+        if (!get_operators(i).isColumnwise()) {
+            get_operators(i).operate(table, model);
+            ++i;
+            continue;
+        }
+        int end = i + 1;
+        while (end < numOperators && get_operators(end).isColumnwise()) {
+            ++end;
+        }
+        applyColumnwiseOperators(table, i, end);
+        i = end;
+    }
+    return table;
+}
+
+void TableProcessor::applyColumnwiseOperators(
+        TimeSeriesTable& table, int begin, int end) const {
+    // times[k] is the time column before applying operator begin + k.
+    const int numOperators = end - begin;
+    std::vector<std::vector<double>> times(numOperators + 1);
+    times[0] = table.getIndependentColumn();
+    for (int k = 0; k < numOperators; ++k) {
+        times[k + 1] = times[k];
+        get_operators(begin + k).operateOnTime(times[k + 1]);
+    }
+    const int numRowsIn = (int)times.front().size();
+    const int numRowsOut = (int)times.back().size();
+    const int numColumns = (int)table.getNumColumns();
+
+    // If the number of rows does not change, the columns are written back into
+    // the table's matrix in place.
+    const bool inPlace = numRowsIn == numRowsOut;
+    SimTK::Matrix out;
+    if (!inPlace) out.resize(numRowsOut, numColumns);
+    auto& matrix = table.updMatrix();
+
+    auto processColumns = [&](int beginCol, int endCol) {
+        std::vector<double> column;
+        for (int icol = beginCol; icol < endCol; ++icol) {
+            column.resize(numRowsIn);
+            for (int irow = 0; irow < numRowsIn; ++irow) {
+                column[irow] = matrix(irow, icol);
+            }
+            for (int k = 0; k < numOperators; ++k) {
+                const auto& op = get_operators(begin + k);
+                op.operateOnColumn(times[k], column);
+                OPENSIM_THROW_IF(column.size() != times[k + 1].size(),
+                        Exception,
+                        format("Expected operator '%s' to produce a column "
+                               "with %i rows, but it has %i rows.",
+                                op.getConcreteClassName(),
+                                (int)times[k + 1].size(), (int)column.size()));
+            }
+            auto& dest = inPlace ? matrix : out;
+            for (int irow = 0; irow < numRowsOut; ++irow) {
+                dest(irow, icol) = column[irow];
+            }
+        }
+    };
+    parallelForBlocks(numColumns,
+            getMocoNumThreadsForColumns(numRowsOut, numColumns),
+            [&](int, int begin, int end) { processColumns(begin, end); });
+
+    if (inPlace) {
+        for (int irow = 0; irow < numRowsOut; ++irow) {
+            table.setIndependentValueAtIndex(irow, times.back()[irow]);
+        }
+    } else {
+        TimeSeriesTable result(times.back(), out, table.getColumnLabels());
+        result.updTableMetaData() = table.getTableMetaData();
+        table = std::move(result);
+    }
+}
+
+namespace {
+double calcSamplingInterval(const std::vector<double>& time) {
+    double samplingInterval = SimTK::Infinity;
+    for (int i = 1; i < (int)time.size(); ++i) {
+        samplingInterval = std::min(samplingInterval, time[i] - time[i - 1]);
+    }
+    OPENSIM_THROW_IF(samplingInterval <= 0, Exception,
+            "Expected the times in the table to be strictly increasing.");
+    return samplingInterval;
+}
+} // anonymous namespace
+
+void TabOpLowPassFilter::operateOnTime(std::vector<double>& time) const {
+    if (get_cutoff_frequency() == -1) return;
+    if (time.size() >= 2) {
+        // Warn once here rather than for each column. Like
+        // Storage::lowpassIIR(), the columns are then padded but not
+        // filtered.
+        const double nyquist = 0.5 / calcSamplingInterval(time);
+        if (get_cutoff_frequency() >= nyquist) {
+            std::cout << format("Warning: TabOpLowPassFilter's cutoff "
+                                "frequency (%g Hz) is not less than half the "
+                                "sampling frequency (%g Hz); the table was "
+                                "not filtered.",
+                                 get_cutoff_frequency(), nyquist)
+                      << std::endl;
+        }
+    }
+    padSignal((int)time.size() / 2, time);
+}
+
+void TabOpLowPassFilter::operateOnColumn(
+        const std::vector<double>& time, std::vector<double>& column) const {
+    if (get_cutoff_frequency() == -1) return;
+    OPENSIM_THROW_IF(get_cutoff_frequency() <= 0, Exception,
+            format("Expected cutoff frequency to be positive, but got %f.",
+                    get_cutoff_frequency()));
+    if (time.size() < 2) return;
+    const double samplingInterval = calcSamplingInterval(time);
+    padSignal((int)column.size() / 2, column);
+    if (get_cutoff_frequency() < 0.5 / samplingInterval) {
+        filterLowpassInPlace(samplingInterval, get_cutoff_frequency(), column);
+    }
+}
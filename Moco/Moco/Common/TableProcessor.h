@@ -35,6 +35,30 @@ public:
     /// This function may or may not be provided with a model. If the operation
     /// requires a model and model == nullptr, an exception is thrown.
     virtual void operate(TimeSeriesTable& table, const Model* model) const = 0;
+
+    /// @name Column-wise operation
+    /// Operators that modify each column independently of the other columns
+    /// (and do not require a model) can override these functions.
+    /// TableProcessor applies consecutive column-wise operators in a single
+    /// pass over each column, processing the columns in parallel, instead of
+    /// invoking operate() on the entire table for each operator.
+    /// @{
+
+    /// Return true if this operator implements operateOnTime() and
+    /// operateOnColumn() to give the same result as operate().
+    virtual bool isColumnwise() const { return false; }
+    /// Modify the time column as operate() would (e.g., to add padding). The
+    /// default implementation does nothing.
+    virtual void operateOnTime(std::vector<double>& /*time*/) const {}
+    /// Modify a single column as operate() would. `time` is the time column
+    /// before operateOnTime() is applied, and the modified column must have
+    /// the same length as the time column after operateOnTime() is applied.
+    /// This function is invoked from multiple threads at once.
+    virtual void operateOnColumn(const std::vector<double>& /*time*/,
+            std::vector<double>& /*column*/) const {
+        OPENSIM_THROW_FRMOBJ(Exception, "Not implemented.");
+    }
+    /// @}
 };
 
 /// This class describes a workflow for processing a table using
@@ -77,39 +101,11 @@ public:
     /// radians (if the table has a header with inDegrees=yes) before any
     /// operations are performed. This model is accessible by any
     /// TableOperator%s that require it.
+    /// Consecutive column-wise operators (see TableOperator::isColumnwise())
+    /// are fused into a single pass over each column, and the columns are
+    /// processed in parallel (see getMocoNumThreads()).
     TimeSeriesTable process(std::string relativeToDirectory,
-            const Model* model = nullptr) const {
-        TimeSeriesTable table;
-        if (get_filepath().empty()) {
-            if (m_tableProvided) {
-                table = m_table;
-            } else {
-                OPENSIM_THROW_FRMOBJ(Exception, "No source table.");
-            }
-        } else {
-            OPENSIM_THROW_IF_FRMOBJ(m_tableProvided, Exception,
-                    "Expected either an in-memory table or a filepath, but "
-                    "both were provided.");
-            std::string path = get_filepath();
-            if (!relativeToDirectory.empty()) {
-                using SimTK::Pathname;
-                path = Pathname::
-                        getAbsolutePathnameUsingSpecifiedWorkingDirectory(
-                                relativeToDirectory, path);
-            }
-            table = TimeSeriesTable(path);
-        }
-
-        if (table.hasTableMetaDataKey("inDegrees") &&
-                table.getTableMetaDataAsString("inDegrees") == "yes") {
-            model->getSimbodyEngine().convertDegreesToRadians(table);
-        }
-
-        for (int i = 0; i < getProperty_operators().size(); ++i) {
-            get_operators(i).operate(table, model);
-        }
-        return table;
-    }
+            const Model* model = nullptr) const;
     /// Same as above, but paths are evaluated with respect to the current
     /// working directory.
     TimeSeriesTable process(const Model* model = nullptr) const {
@@ -120,6 +116,16 @@ public:
     bool empty() const {
         return !m_tableProvided && get_filepath().empty();
     }
+    /// Returns true if the source table was provided in memory (rather than
+    /// through the filepath property). The in-memory table is not serialized.
+    bool hasInMemoryTable() const { return m_tableProvided; }
+    /// Get the in-memory source table. This throws an exception if the source
+    /// table was not provided in memory (see hasInMemoryTable()).
+    const TimeSeriesTable& getInMemoryTable() const {
+        OPENSIM_THROW_IF_FRMOBJ(!m_tableProvided, Exception,
+                "No in-memory source table.");
+        return m_table;
+    }
     /// Append an operation to the end of the operations in this processor.
     TableProcessor& append(const TableOperator& op) {
         append_operators(op);
@@ -143,6 +149,10 @@ public:
     }
 
 private:
+    /// Apply operators [begin, end), which must be column-wise.
+    void applyColumnwiseOperators(
+            TimeSeriesTable& table, int begin, int end) const;
+
     bool m_tableProvided = false;
     TimeSeriesTable m_table;
 };
@@ -170,6 +180,10 @@ public:
             table = filterLowpass(table, get_cutoff_frequency(), true);
         }
     }
+    bool isColumnwise() const override { return true; }
+    void operateOnTime(std::vector<double>& time) const override;
+    void operateOnColumn(const std::vector<double>& time,
+            std::vector<double>& column) const override;
 };
 
 /// Update table column labels to use post-4.0 state paths instead of pre-4.0
@@ -19,9 +19,12 @@
 #include "ModelFactory.h"
 
 #include "../MocoUtilities.h"
+#include "DeGrooteFregly2016Muscle.h"
+#include "StationPlaneContactForce.h"
 
 #include <OpenSim/Actuators/CoordinateActuator.h>
 #include <OpenSim/Simulation/SimbodyEngine/PinJoint.h>
+#include <OpenSim/Simulation/SimbodyEngine/PointOnLineConstraint.h>
 #include <OpenSim/Simulation/SimbodyEngine/SliderJoint.h>
 #include <OpenSim/Simulation/SimbodyEngine/WeldJoint.h>
 
@@ -155,6 +158,114 @@ Model ModelFactory::createSlidingPointMass() {
     return model;
 }
 
+Model ModelFactory::createSyntheticModel(int numLinks, int numMusclesPerJoint,
+        int numLoopConstraints, int numContactStations) {
+    OPENSIM_THROW_IF(numLinks < 1, Exception,
+            format("Expected numLinks to be positive, but got %i.",
+                    numLinks));
+    OPENSIM_THROW_IF(numMusclesPerJoint < 0, Exception,
+            format("Expected numMusclesPerJoint to be nonnegative, but got "
+                   "%i.",
+                    numMusclesPerJoint));
+    OPENSIM_THROW_IF(numLoopConstraints < 0 ||
+                             numLoopConstraints > numLinks / 2,
+            Exception,
+            format("Expected numLoopConstraints to be in [0, %i], but got "
+                   "%i.",
+                    numLinks / 2, numLoopConstraints));
+    OPENSIM_THROW_IF(numContactStations < 0, Exception,
+            format("Expected numContactStations to be nonnegative, but got "
+                   "%i.",
+                    numContactStations));
+
+    Model model;
+    model.setName(format("synthetic_%ilinks_%imuscles_%iloops_%icontacts",
+            numLinks, numMusclesPerJoint, numLoopConstraints,
+            numContactStations));
+    const auto& ground = model.getGround();
+    const Vec3 base(0, numLinks, 0);
+
+    Ellipsoid bodyGeometry(0.5, 0.05, 0.05);
+    bodyGeometry.setColor(SimTK::Gray);
+
+    std::vector<OpenSim::Body*> bodies;
+    const PhysicalFrame* prevBody = &ground;
+    for (int i = 0; i < numLinks; ++i) {
+        const std::string istr = std::to_string(i);
+        // The mass center is at the center of the link.
+        auto* bi = new OpenSim::Body("b" + istr, 1, Vec3(-0.5, 0, 0),
+                Inertia(0.001, 1.0 / 12.0, 1.0 / 12.0));
+        model.addBody(bi);
+        bodies.push_back(bi);
+
+        // The x axis of the first joint's parent frame points down, so the
+        // chain hangs straight down when all coordinates are 0.
+        auto* ji = i == 0 ? new PinJoint("j" + istr, ground, base,
+                                    Vec3(0, 0, -0.5 * SimTK::Pi), *bi,
+                                    Vec3(-1, 0, 0), Vec3(0))
+                          : new PinJoint("j" + istr, *prevBody, Vec3(0),
+                                    Vec3(0), *bi, Vec3(-1, 0, 0), Vec3(0));
+        auto& qi = ji->updCoordinate();
+        qi.setName("q" + istr);
+        model.addJoint(ji);
+
+        auto* taui = new CoordinateActuator();
+        taui->setCoordinate(&qi);
+        taui->setName("tau" + istr);
+        taui->setOptimalForce(100);
+        model.addForce(taui);
+
+        // Each muscle attaches 0.3 m on either side of the joint. Points in
+        // the parent's frame are expressed in ground for the first joint.
+        for (int m = 0; m < numMusclesPerJoint; ++m) {
+            const double side = m % 2 == 0 ? 1 : -1;
+            const double offset = side * 0.05 * (1 + m / 2);
+            auto* muscle = new DeGrooteFregly2016Muscle();
+            muscle->setName("muscle" + istr + "_" + std::to_string(m));
+            muscle->set_max_isometric_force(500);
+            muscle->set_optimal_fiber_length(0.3);
+            muscle->set_tendon_slack_length(0.3);
+            muscle->set_ignore_tendon_compliance(true);
+            muscle->addNewPathPoint("origin", *prevBody,
+                    i == 0 ? base + Vec3(offset, 0.3, 0)
+                           : Vec3(-0.3, offset, 0));
+            muscle->addNewPathPoint(
+                    "insertion", *bi, Vec3(-0.7, offset, 0));
+            model.addForce(muscle);
+        }
+
+        auto* bicenter = new PhysicalOffsetFrame(
+                "b" + istr + "center", *bi, SimTK::Transform(Vec3(-0.5, 0, 0)));
+        bi->addComponent(bicenter);
+        bicenter->attachGeometry(bodyGeometry.clone());
+
+        prevBody = bi;
+    }
+
+    for (int k = 0; k < numLoopConstraints; ++k) {
+        auto* constraint = new PointOnLineConstraint(ground, Vec3(0, 1, 0),
+                base, *bodies[2 * k + 1], Vec3(0));
+        constraint->setName("loop" + std::to_string(k));
+        model.addConstraint(constraint);
+    }
+
+    for (int k = 0; k < numContactStations; ++k) {
+        const std::string kstr = std::to_string(k);
+        auto* station = new Station(*bodies.back(),
+                Vec3(-(double)k / numContactStations, 0, 0));
+        station->setName("contact_station" + kstr);
+        model.addComponent(station);
+        auto* contact = new AckermannVanDenBogert2010Force();
+        contact->setName("contact" + kstr);
+        contact->connectSocket_station(*station);
+        model.addForce(contact);
+    }
+
+    model.finalizeConnections();
+
+    return model;
+}
+
 void ModelFactory::replaceMusclesWithPathActuators(OpenSim::Model &model) {
 
     // Create path actuators from muscle properties and add to the model. Save
@@ -54,6 +54,30 @@ public:
     /// - 2 coordinate actuators: "force_x" and "force_y".
     /// Gravity is default; that is, (0, -g, 0).
     static Model createPlanarPointMass();
+    /// Create a planar chain whose size is set by the arguments, for
+    /// measuring how solver performance scales with the size of a model. The
+    /// chain hangs from the ground point (0, numLinks, 0), so that its tip
+    /// touches the ground plane (y = 0) when all coordinates are 0. Gravity is
+    /// default; that is, (0, -g, 0). The model contains:
+    /// - For each link: a 1 kg, 1 m body `/bodyset/b#` (where `#` is the link
+    ///   index starting at 0) whose origin is at the distal end of the link,
+    ///   a PinJoint `/jointset/j#` with coordinate `/jointset/j#/q#` at the
+    ///   proximal end of the link, and a CoordinateActuator `/forceset/tau#`
+    ///   (optimal force 100).
+    /// - For each joint, `numMusclesPerJoint` DeGrooteFregly2016Muscle%s
+    ///   `/forceset/muscle#_$` (where `$` is the muscle index starting at 0)
+    ///   with rigid tendons, crossing the joint on alternating sides with
+    ///   moment arms that increase with the muscle index.
+    /// - `numLoopConstraints` PointOnLineConstraint%s; constraint `k` keeps the
+    ///   distal end of link `2k + 1` on the vertical line through the chain's
+    ///   base, forming a closed loop with the ground. `numLoopConstraints`
+    ///   must be at most `numLinks / 2`.
+    /// - `numContactStations` Station%s `/contact_station#`, evenly spaced
+    ///   along the distal link starting at its tip, each with an
+    ///   AckermannVanDenBogert2010Force `/forceset/contact#`.
+    /// @see MocoStudyFactory::createSyntheticTrackingStudy()
+    static Model createSyntheticModel(int numLinks, int numMusclesPerJoint,
+            int numLoopConstraints = 0, int numContactStations = 0);
 
 
     /// @}
@@ -18,8 +18,62 @@
 
 #include "StationPlaneContactForce.h"
 
+#include "../MocoUtilities.h"
+
 using namespace OpenSim;
 
+static const std::string CACHE_FORCE_ON_STATION_NAME = "force_on_station";
+static const std::string CACHE_CONTACT_FORCES_NAME = "contact_forces";
+
+void StationPlaneContactForce::extendConnectToModel(Model& model) {
+    Super::extendConnectToModel(model);
+    // Groups list their forces by path, which is available regardless of
+    // the order in which the model's components are connected.
+    m_group.reset();
+    for (const auto& group :
+            model.getComponentList<StationPlaneContactForceGroup>()) {
+        for (int i = 0; i < group.getNumContactForces(); ++i) {
+            const auto& path = group.get_contact_force_paths(i);
+            if (model.hasComponent<StationPlaneContactForce>(path) &&
+                    &model.getComponent<StationPlaneContactForce>(path) ==
+                            this) {
+                m_group.reset(&group);
+                return;
+            }
+        }
+    }
+}
+
+void StationPlaneContactForce::extendAddToSystem(
+        SimTK::MultibodySystem& system) const {
+    Super::extendAddToSystem(system);
+    addCacheVariable(CACHE_FORCE_ON_STATION_NAME, SimTK::Vec3(0),
+            SimTK::Stage::Velocity);
+}
+
+bool StationPlaneContactForce::isContactForceOnStationCached(
+        const SimTK::State& s) const {
+    return isCacheVariableValid(s, CACHE_FORCE_ON_STATION_NAME);
+}
+
+void StationPlaneContactForce::cacheContactForceOnStation(
+        const SimTK::State& s, const SimTK::Vec3& force) const {
+    setCacheVariableValue(s, CACHE_FORCE_ON_STATION_NAME, force);
+    markCacheVariableValid(s, CACHE_FORCE_ON_STATION_NAME);
+}
+
+const SimTK::Vec3& StationPlaneContactForce::getContactForceOnStation(
+        const SimTK::State& s) const {
+    if (!isContactForceOnStationCached(s)) {
+        // The group caches the forces of all of its members.
+        if (!m_group.empty()) m_group->getContactForces(s);
+        if (!isContactForceOnStationCached(s)) {
+            cacheContactForceOnStation(s, calcContactForceOnStation(s));
+        }
+    }
+    return getCacheVariableValue<SimTK::Vec3>(s, CACHE_FORCE_ON_STATION_NAME);
+}
+
 void StationPlaneContactForce::generateDecorations(
         bool fixed, const ModelDisplayHints& hints,
         const SimTK::State& s,
@@ -33,10 +87,9 @@ void StationPlaneContactForce::generateDecorations(
         const double arrowLengthPerForce = 1.0 / 1000.0; // meters / Newton
         //const double mg =
         //        getModel().getTotalMass(s) * getModel().getGravity().norm();
-        // TODO avoid recalculating.
         const auto& pt = getConnectee<Station>("station");
         const auto pt1 = pt.getLocationInGround(s);
-        const SimTK::Vec3 force = calcContactForceOnStation(s);
+        const SimTK::Vec3& force = getContactForceOnStation(s);
         // std::cout << "DEBUGgd force " << force << std::endl;
         const SimTK::Vec3 pt2 = pt1 + force * arrowLengthPerForce; // mg;
         SimTK::DecorativeLine line(pt1, pt2);
@@ -54,3 +107,68 @@ void StationPlaneContactForce::generateDecorations(
         geoms.push_back(sphere);
     }
 }
+
+void StationPlaneContactForceGroup::extendConnectToModel(Model& model) {
+    Super::extendConnectToModel(model);
+    m_contactForces.clear();
+    for (int i = 0; i < getProperty_contact_force_paths().size(); ++i) {
+        const auto& path = get_contact_force_paths(i);
+        OPENSIM_THROW_IF_FRMOBJ(
+                !model.hasComponent<StationPlaneContactForce>(path),
+                Exception,
+                format("Could not find StationPlaneContactForce '%s'.", path));
+        m_contactForces.emplace_back(
+                &model.getComponent<StationPlaneContactForce>(path));
+    }
+}
+
+void StationPlaneContactForceGroup::extendAddToSystem(
+        SimTK::MultibodySystem& system) const {
+    Super::extendAddToSystem(system);
+    addCacheVariable(CACHE_CONTACT_FORCES_NAME,
+            SimTK::Vector_<SimTK::Vec3>(getNumContactForces(), SimTK::Vec3(0)),
+            SimTK::Stage::Velocity);
+}
+
+const SimTK::Vector_<SimTK::Vec3>&
+StationPlaneContactForceGroup::getContactForces(const SimTK::State& s) const {
+    if (!isCacheVariableValid(s, CACHE_CONTACT_FORCES_NAME)) {
+        auto& forces = updCacheVariableValue<SimTK::Vector_<SimTK::Vec3>>(
+                s, CACHE_CONTACT_FORCES_NAME);
+        const int numForces = (int)m_contactForces.size();
+        forces.resize(numForces);
+
+        // Gather the kinematics of all stations whose force is not yet
+        // cached, then compute the forces in one pass.
+        std::vector<int> toCompute;
+        SimTK::Vector_<SimTK::Vec3> positions(numForces);
+        SimTK::Vector_<SimTK::Vec3> velocities(numForces);
+        for (int i = 0; i < numForces; ++i) {
+            const auto& contactForce = *m_contactForces[i];
+            if (contactForce.isContactForceOnStationCached(s)) {
+                forces[i] = contactForce.getContactForceOnStation(s);
+            } else {
+                const auto& pt = contactForce.getConnectee<Station>("station");
+                positions[i] = pt.getLocationInGround(s);
+                velocities[i] = pt.getVelocityInGround(s);
+                toCompute.push_back(i);
+            }
+        }
+        for (const auto& i : toCompute) {
+            forces[i] = m_contactForces[i]->calcContactForce(
+                    positions[i], velocities[i]);
+            m_contactForces[i]->cacheContactForceOnStation(s, forces[i]);
+        }
+        markCacheVariableValid(s, CACHE_CONTACT_FORCES_NAME);
+    }
+    return getCacheVariableValue<SimTK::Vector_<SimTK::Vec3>>(
+            s, CACHE_CONTACT_FORCES_NAME);
+}
+
+SimTK::Vec3 StationPlaneContactForceGroup::getNetContactForce(
+        const SimTK::State& s) const {
+    const auto& forces = getContactForces(s);
+    SimTK::Vec3 netForce(0);
+    for (int i = 0; i < forces.size(); ++i) { netForce += forces[i]; }
+    return netForce;
+}
@@ -24,13 +24,21 @@
 
 namespace OpenSim {
 
+class StationPlaneContactForceGroup;
+
 /// This class models compliant point contact with a ground plane y=0.
+/// The contact force is computed at most once per state (at
+/// Stage::Velocity) and cached; computeForce(), getRecordValues(), the
+/// force_on_station output, and StationPlaneContactForceGroup all use the
+/// cached value. If this force belongs to a StationPlaneContactForceGroup in
+/// the same model, the force is computed by the group, along with the
+/// forces of the rest of the group, the first time any of them is needed.
 /// This class is still under development.
 class OSIMMOCO_API StationPlaneContactForce : public Force {
 OpenSim_DECLARE_ABSTRACT_OBJECT(StationPlaneContactForce, Force);
 public:
     OpenSim_DECLARE_OUTPUT(force_on_station, SimTK::Vec3,
-            calcContactForceOnStation, SimTK::Stage::Velocity);
+            getContactForceOnStation, SimTK::Stage::Velocity);
 
     OpenSim_DECLARE_SOCKET(station, Station,
             "The body-fixed point that can contact the plane.");
@@ -38,7 +46,7 @@ public:
     void computeForce(const SimTK::State& s,
             SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
             SimTK::Vector& /*generalizedForces*/) const override {
-        const SimTK::Vec3 force = calcContactForceOnStation(s);
+        const SimTK::Vec3& force = getContactForceOnStation(s);
         const auto& pt = getConnectee<Station>("station");
         const auto& pos = pt.getLocationInGround(s);
         const auto& frame = pt.getParentFrame();
@@ -57,8 +65,7 @@ public:
     OpenSim::Array<double> getRecordValues(const SimTK::State& s)
     const override {
         OpenSim::Array<double> values;
-        // TODO cache.
-        const SimTK::Vec3 force = calcContactForceOnStation(s);
+        const SimTK::Vec3& force = getContactForceOnStation(s);
         values.append(force[0]);
         values.append(force[1]);
         values.append(force[2]);
@@ -68,9 +75,42 @@ public:
             const SimTK::State& s,
             SimTK::Array_<SimTK::DecorativeGeometry>& geoms) const override;
 
+    /// Obtain the force applied to the body to which the station is
+    /// attached, at the station, expressed in ground. The force is computed
+    /// only if it is not already cached in the state (through this force's
+    /// StationPlaneContactForceGroup, if any).
+    const SimTK::Vec3& getContactForceOnStation(const SimTK::State& s) const;
+
+    /// Compute the force applied to the body to which the station is
+    /// attached, at the station, expressed in ground. Unlike
+    /// getContactForceOnStation(), this does not use the cache.
     // TODO rename to computeContactForceOnStation
-    virtual SimTK::Vec3 calcContactForceOnStation(
-            const SimTK::State& s) const = 0;
+    SimTK::Vec3 calcContactForceOnStation(const SimTK::State& s) const {
+        const auto& pt = getConnectee<Station>("station");
+        return calcContactForce(
+                pt.getLocationInGround(s), pt.getVelocityInGround(s));
+    }
+
+    /// Compute the contact force for a station with the given location and
+    /// velocity, both expressed in ground. This depends only on the
+    /// properties of this force, so StationPlaneContactForceGroup can
+    /// evaluate many stations in one pass.
+    virtual SimTK::Vec3 calcContactForce(const SimTK::Vec3& pos,
+            const SimTK::Vec3& vel) const = 0;
+
+protected:
+    void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
+
+private:
+    friend class StationPlaneContactForceGroup;
+    bool isContactForceOnStationCached(const SimTK::State& s) const;
+    void cacheContactForceOnStation(
+            const SimTK::State& s, const SimTK::Vec3& force) const;
+
+    /// The first StationPlaneContactForceGroup in the model that lists this
+    /// force, if any.
+    SimTK::ReferencePtr<const StationPlaneContactForceGroup> m_group;
 };
 
 /// This class is still under development.
@@ -95,12 +135,9 @@ public:
 
     /// Compute the force applied to body to which the station is attached, at
     /// the station, expressed in ground.
-    SimTK::Vec3 calcContactForceOnStation(const SimTK::State& s)
-    const override {
+    SimTK::Vec3 calcContactForce(const SimTK::Vec3& pos,
+            const SimTK::Vec3& vel) const override {
         SimTK::Vec3 force(0);
-        const auto& pt = getConnectee<Station>("station");
-        const auto& pos = pt.getLocationInGround(s);
-        const auto& vel = pt.getVelocityInGround(s);
         const SimTK::Real y = pos[1];
         const SimTK::Real velNormal = vel[1];
         // TODO should project vel into ground.
@@ -162,12 +199,9 @@ public:
 
     /// Compute the force applied to body to which the station is attached, at
     /// the station, expressed in ground.
-    SimTK::Vec3 calcContactForceOnStation(const SimTK::State& s)
-    const override {
+    SimTK::Vec3 calcContactForce(const SimTK::Vec3& pos,
+            const SimTK::Vec3& vel) const override {
         SimTK::Vec3 force(0);
-        const auto& pt = getConnectee<Station>("station");
-        const auto& pos = pt.getLocationInGround(s);
-        const auto& vel = pt.getVelocityInGround(s);
         const SimTK::Real y = pos[1];
         const SimTK::Real velNormal = vel[1];
         // TODO should project vel into ground.
@@ -259,13 +293,10 @@ public:
 
     /// Compute the force applied to body to which the station is attached, at
     /// the station, expressed in ground.
-    SimTK::Vec3 calcContactForceOnStation(const SimTK::State& s)
-    const override {
+    SimTK::Vec3 calcContactForce(const SimTK::Vec3& pos,
+            const SimTK::Vec3& vel) const override {
         using SimTK::square;
         SimTK::Vec3 force(0);
-        const auto& pt = getConnectee<Station>("station");
-        const auto& pos = pt.getLocationInGround(s);
-        const auto& vel = pt.getVelocityInGround(s);
         const SimTK::Real height = pos[1];
         const SimTK::Real velNormal = vel[1];
         // TODO should project vel into ground.
@@ -310,6 +341,58 @@ private:
     SimTK::Real m_depthOffsetSquared;
 };
 
+/// This component evaluates the contact forces of a group of
+/// StationPlaneContactForce%s (e.g., all contact elements under one foot) in
+/// a single pass: the locations and velocities of all stations are gathered
+/// first, then the forces are computed with
+/// StationPlaneContactForce::calcContactForce(). The forces are cached in the
+/// state (at Stage::Velocity), both in this component and in each contact
+/// force. When the model applies any of the group's forces (in
+/// StationPlaneContactForce::computeForce()), all of the group's forces are
+/// computed with this component, and they are not recomputed when the model
+/// applies the rest of them or when they are reported.
+class OSIMMOCO_API StationPlaneContactForceGroup : public ModelComponent {
+OpenSim_DECLARE_CONCRETE_OBJECT(StationPlaneContactForceGroup, ModelComponent);
+public:
+    OpenSim_DECLARE_LIST_PROPERTY(contact_force_paths, std::string,
+            "Paths to StationPlaneContactForce components in the model.");
+
+    OpenSim_DECLARE_OUTPUT(net_force, SimTK::Vec3, getNetContactForce,
+            SimTK::Stage::Velocity);
+
+    StationPlaneContactForceGroup() { constructProperties(); }
+
+    void addContactForce(const std::string& path) {
+        append_contact_force_paths(path);
+    }
+    int getNumContactForces() const {
+        return getProperty_contact_force_paths().size();
+    }
+    /// This is only available after the model is connected.
+    const StationPlaneContactForce& getContactForce(int index) const {
+        return *m_contactForces.at(index);
+    }
+
+    /// The force applied to the body to which each station is attached, at
+    /// the station, expressed in ground. The forces are in the same order as
+    /// the contact_force_paths property.
+    const SimTK::Vector_<SimTK::Vec3>& getContactForces(
+            const SimTK::State& s) const;
+
+    /// The sum of the forces from getContactForces().
+    SimTK::Vec3 getNetContactForce(const SimTK::State& s) const;
+
+protected:
+    void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
+
+private:
+    void constructProperties() { constructProperty_contact_force_paths(); }
+
+    std::vector<SimTK::ReferencePtr<const StationPlaneContactForce>>
+            m_contactForces;
+};
+
 } // namespace OpenSim
 
 #endif // MOCO_STATIONPLANECONTACTFORCE_H
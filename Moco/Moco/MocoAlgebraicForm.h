@@ -0,0 +1,76 @@
+#ifndef MOCO_MOCOALGEBRAICFORM_H
+#define MOCO_MOCOALGEBRAICFORM_H
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: MocoAlgebraicForm.h                                          *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <vector>
+
+namespace OpenSim {
+
+/// A single term of a MocoAlgebraicForm: a coefficient multiplying one
+/// variable of the problem.
+/// States are identified by their index in the system's Y vector, and controls
+/// are identified by their index in the model's controls vector (see
+/// createSystemYIndexMap() and createSystemControlIndexMap()).
+struct MocoAlgebraicTerm {
+    enum class Variable {
+        State,
+        Control,
+        Time,
+        /// The integral of the integrand (only for goal outputs).
+        Integral,
+        /// The term is the coefficient itself.
+        Constant
+    };
+    MocoAlgebraicTerm(Variable variable, int index, double coefficient,
+            bool final = false)
+            : variable(variable), index(index), coefficient(coefficient),
+              final(final) {}
+    Variable variable;
+    /// The index of the state or control; ignored for other variables.
+    int index;
+    double coefficient;
+    /// For goal outputs, use the variable's value at the final time instead of
+    /// the initial time. Ignored for integrands and path constraints.
+    bool final;
+};
+
+/// For use by solvers. Goals and path constraints whose values depend on the
+/// problem's states, controls, and time only through simple algebraic
+/// expressions can describe themselves with this struct. Solvers that build
+/// symbolic expression graphs (e.g., MocoCasADiSolver) use this description to
+/// evaluate the goal without realizing the model and to obtain exact
+/// derivatives.
+///
+/// The integrand is
+/// \f[ \sum_i c_i |v_i|^p \f]
+/// where \f$ p \f$ is `integrandExponent`. Each element of `outputs` is the
+/// sum of its terms, squared if `squareOutputs` is true, and then multiplied
+/// by `scale`. For path constraints, `outputs` contains one entry per
+/// constraint equation.
+struct MocoAlgebraicForm {
+    std::vector<MocoAlgebraicTerm> integrand;
+    int integrandExponent = 2;
+    std::vector<std::vector<MocoAlgebraicTerm>> outputs;
+    bool squareOutputs = false;
+    double scale = 1;
+};
+
+} // namespace OpenSim
+
+#endif // MOCO_MOCOALGEBRAICFORM_H
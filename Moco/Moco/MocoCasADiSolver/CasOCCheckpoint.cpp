@@ -0,0 +1,122 @@
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: CasOCCheckpoint.cpp                                          *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "CasOCCheckpoint.h"
+
+#include "../MocoUtilities.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace CasOC;
+using OpenSim::Exception;
+using OpenSim::format;
+
+namespace {
+
+const char magic[] = "MOCOCKPT";
+const std::uint32_t version = 1;
+
+template <typename T>
+void writeValue(std::ofstream& stream, const T& value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+void writeVector(std::ofstream& stream, const std::vector<double>& values) {
+    writeValue(stream, (std::uint64_t)values.size());
+    stream.write(reinterpret_cast<const char*>(values.data()),
+            values.size() * sizeof(double));
+}
+
+template <typename T>
+T readValue(std::ifstream& stream) {
+    T value;
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+std::vector<double> readVector(
+        std::ifstream& stream, const std::string& filepath) {
+    const auto size = readValue<std::uint64_t>(stream);
+    // Guard against allocating a huge vector for a corrupt file.
+    OPENSIM_THROW_IF(!stream || size > (std::uint64_t(1) << 40), Exception,
+            format("Checkpoint '%s' is corrupt.", filepath));
+    std::vector<double> values(size);
+    stream.read(reinterpret_cast<char*>(values.data()),
+            values.size() * sizeof(double));
+    return values;
+}
+
+} // namespace
+
+void Checkpoint::write(const std::string& filepath) const {
+    const std::string tempFilepath = filepath + ".tmp";
+    {
+        std::ofstream stream(tempFilepath, std::ios::binary);
+        OPENSIM_THROW_IF(!stream.good(), Exception,
+                format("Could not write to '%s'.", tempFilepath));
+        stream.write(magic, sizeof(magic) - 1);
+        writeValue(stream, version);
+        writeValue(stream, (std::uint64_t)problemHash.size());
+        stream.write(problemHash.data(), problemHash.size());
+        writeValue(stream, (std::int64_t)iteration);
+        writeVector(stream, mesh);
+        writeVector(stream, scales);
+        writeValue(stream, objective);
+        writeVector(stream, x);
+        writeVector(stream, lam_x);
+        writeVector(stream, lam_g);
+        OPENSIM_THROW_IF(!stream.good(), Exception,
+                format("Could not write to '%s'.", tempFilepath));
+    }
+#ifdef _WIN32
+    // rename() does not replace existing files on Windows.
+    std::remove(filepath.c_str());
+#endif
+    OPENSIM_THROW_IF(std::rename(tempFilepath.c_str(), filepath.c_str()) != 0,
+            Exception, format("Could not create '%s'.", filepath));
+}
+
+bool Checkpoint::read(const std::string& filepath) {
+    std::ifstream stream(filepath, std::ios::binary);
+    if (!stream.good()) return false;
+    char header[sizeof(magic) - 1];
+    stream.read(header, sizeof(header));
+    OPENSIM_THROW_IF(!stream || std::memcmp(header, magic, sizeof(header)),
+            Exception,
+            format("'%s' is not a Moco checkpoint file.", filepath));
+    const auto fileVersion = readValue<std::uint32_t>(stream);
+    OPENSIM_THROW_IF(fileVersion != version, Exception,
+            format("Checkpoint '%s' has version %i, but version %i is "
+                   "expected.",
+                    filepath, (int)fileVersion, (int)version));
+    const auto hashSize = readValue<std::uint64_t>(stream);
+    OPENSIM_THROW_IF(!stream || hashSize > 1024, Exception,
+            format("Checkpoint '%s' is corrupt.", filepath));
+    problemHash.resize(hashSize);
+    stream.read(&problemHash[0], hashSize);
+    iteration = (int)readValue<std::int64_t>(stream);
+    mesh = readVector(stream, filepath);
+    scales = readVector(stream, filepath);
+    objective = readValue<double>(stream);
+    x = readVector(stream, filepath);
+    lam_x = readVector(stream, filepath);
+    lam_g = readVector(stream, filepath);
+    OPENSIM_THROW_IF(!stream, Exception,
+            format("Checkpoint '%s' is truncated.", filepath));
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef MOCO_CASOCCHECKPOINT_H
+#define MOCO_CASOCCHECKPOINT_H
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: CasOCCheckpoint.h                                            *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <string>
+#include <vector>
+
+namespace CasOC {
+
+/// The state of the optimizer at an iteration, which the Transcription
+/// writes to a file periodically so that an interrupted solve can be resumed
+/// (see Solver::setCheckpoint()). The values are those of the nonlinear
+/// program (i.e., scaled, if the variables are scaled).
+///
+/// The file is binary, in the byte order of the machine that wrote it, so
+/// checkpoints are only portable between machines with the same
+/// architecture.
+struct Checkpoint {
+    /// Identifies the problem that the checkpoint was created for.
+    std::string problemHash;
+    /// The number of iterations performed before this checkpoint, including
+    /// those performed before resuming from an earlier checkpoint.
+    int iteration = 0;
+    std::vector<double> mesh;
+    /// The scale of each variable of the nonlinear program (see
+    /// Solver::setScaleVariablesAndConstraints()). The values below are only
+    /// meaningful for a nonlinear program with the same scales.
+    std::vector<double> scales;
+    double objective = 0;
+    /// The variables of the nonlinear program.
+    std::vector<double> x;
+    /// The multipliers for the bounds on the variables.
+    std::vector<double> lam_x;
+    /// The multipliers for the constraints.
+    std::vector<double> lam_g;
+
+    /// Write the checkpoint to a temporary file and rename it to `filepath`,
+    /// so that an interruption while writing never corrupts an existing
+    /// checkpoint.
+    void write(const std::string& filepath) const;
+    /// Read a checkpoint written by write(). Returns false if the file does
+    /// not exist.
+    /// @throws OpenSim::Exception if the file is not a valid checkpoint.
+    bool read(const std::string& filepath);
+};
+
+} // namespace CasOC
+
+#endif // MOCO_CASOCCHECKPOINT_H
@@ -0,0 +1,226 @@
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: CasOCCompiledFunction.cpp                                    *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "CasOCCompiledFunction.h"
+
+#include "../MocoUtilities.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace CasOC;
+using OpenSim::Exception;
+using OpenSim::format;
+
+namespace {
+
+#ifdef _WIN32
+std::string compileToSharedLibrary(const casadi::Function& function,
+        const std::string&, const std::string&) {
+    OPENSIM_THROW(Exception,
+            format("Cannot compile CasADi function '%s': compiling CasADi "
+                   "functions is not supported on Windows.",
+                    function.name()));
+}
+#else
+/// The libraries in the cache are loaded into this process, so the cache
+/// directory and the libraries must be owned by the current user and must not
+/// be writable by other users. Symbolic links are not followed.
+void checkPrivate(const std::string& path, bool directory) {
+    struct stat info;
+    OPENSIM_THROW_IF(lstat(path.c_str(), &info) != 0, Exception,
+            format("Could not access '%s': %s.", path, std::strerror(errno)));
+    OPENSIM_THROW_IF(
+            directory ? !S_ISDIR(info.st_mode) : !S_ISREG(info.st_mode),
+            Exception,
+            format("Expected '%s' to be a %s.", path,
+                    directory ? "directory" : "regular file"));
+    OPENSIM_THROW_IF(info.st_uid != getuid(), Exception,
+            format("Expected '%s' to be owned by the current user.", path));
+    OPENSIM_THROW_IF(info.st_mode & (S_IWGRP | S_IWOTH), Exception,
+            format("Expected '%s' to not be writable by other users.", path));
+}
+
+/// Run the compiler without a shell. The compiler string is split at
+/// whitespace, so it may contain arguments (e.g., "ccache cc"), but it is
+/// never interpreted by a shell. Returns the exit status, or -1 if the
+/// compiler could not be run.
+int runCompiler(const std::string& compiler,
+        const std::vector<std::string>& arguments) {
+    std::vector<std::string> args;
+    std::istringstream words(compiler);
+    std::string word;
+    while (words >> word) args.push_back(word);
+    OPENSIM_THROW_IF(args.empty(), Exception, "Expected a compiler.");
+    args.insert(args.end(), arguments.begin(), arguments.end());
+    std::vector<char*> argv;
+    for (auto& arg : args) argv.push_back(&arg[0]);
+    argv.push_back(nullptr);
+
+    const pid_t pid = fork();
+    if (pid == 0) {
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    if (pid < 0) return -1;
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) return -1;
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/// Returns true if the file exists and contains exactly the given contents.
+bool fileContains(const std::string& path, const std::string& contents) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream.good()) return false;
+    std::stringstream buffer;
+    buffer << stream.rdbuf();
+    return buffer.str() == contents;
+}
+
+/// Generate C code for the function and compile it into a shared library in
+/// cacheDir, unless the cache already contains a library for identical code.
+/// The source is kept next to the library so that a cached library is used
+/// only if its source matches the generated code. Returns the path to the
+/// library.
+std::string compileToSharedLibrary(const casadi::Function& function,
+        const std::string& cacheDir, const std::string& compiler) {
+    casadi::CodeGenerator generator(function.name() + ".c");
+    generator.add(function);
+    const std::string code = generator.dump();
+
+    if (mkdir(cacheDir.c_str(), 0700) != 0) {
+        OPENSIM_THROW_IF(errno != EEXIST, Exception,
+                format("Could not create directory '%s': %s.", cacheDir,
+                        std::strerror(errno)));
+    }
+    checkPrivate(cacheDir, true);
+
+    OpenSim::ContentHasher hasher;
+    hasher.update(code);
+    const std::string base =
+            cacheDir + "/" + function.name() + "_" + hasher.getHexDigest();
+#ifdef __APPLE__
+    const std::string extension = ".dylib";
+#else
+    const std::string extension = ".so";
+#endif
+    const std::string library = base + extension;
+    const std::string cachedSource = base + ".c";
+    if (std::ifstream(library).good() && fileContains(cachedSource, code)) {
+        checkPrivate(cachedSource, false);
+        checkPrivate(library, false);
+        return library;
+    }
+
+    // Write to temporary files and then rename the source and the library, so
+    // that other processes never load a partially-written library. A library
+    // whose source does not match (e.g., a hash collision) is replaced.
+    const std::string tempBase =
+            base + "_" +
+            std::to_string(std::chrono::high_resolution_clock::now()
+                                   .time_since_epoch()
+                                   .count());
+    const std::string source = tempBase + ".c";
+    const std::string tempLibrary = tempBase + extension;
+    {
+        std::ofstream stream(source);
+        OPENSIM_THROW_IF(!stream.good(), Exception,
+                format("Could not write to '%s'.", source));
+        stream << code;
+    }
+    const int status = runCompiler(compiler,
+            {"-O2", "-fPIC", "-shared", source, "-o", tempLibrary});
+    if (status != 0) std::remove(source.c_str());
+    OPENSIM_THROW_IF(status != 0, Exception,
+            format("Failed to compile CasADi function '%s' with compiler "
+                   "'%s' (exit status %i).",
+                    function.name(), compiler, status));
+    OPENSIM_THROW_IF(std::rename(source.c_str(), cachedSource.c_str()) != 0,
+            Exception, format("Could not create '%s'.", cachedSource));
+    OPENSIM_THROW_IF(std::rename(tempLibrary.c_str(), library.c_str()) != 0,
+            Exception, format("Could not create '%s'.", library));
+    return library;
+}
+#endif
+
+} // namespace
+
+void CompiledFunction::constructFunction(const casadi::Function& function,
+        const std::string& cacheDir, const std::string& compiler) {
+    OPENSIM_THROW_IF(!function.is_a("SXFunction"), Exception,
+            format("Expected an SX function, but '%s' is a %s.",
+                    function.name(), function.class_name()));
+    m_function = function;
+    m_cacheDir = cacheDir;
+    m_compiler = compiler;
+    m_compiled = casadi::external(function.name(),
+            compileToSharedLibrary(function, cacheDir, compiler));
+    this->construct(function.name() + "_compiled", casadi::Dict());
+}
+
+int CompiledFunction::eval_buffer(const double** arg,
+        const std::vector<casadi_int>&, double** res,
+        const std::vector<casadi_int>&) const {
+    // Work vectors are reused across evaluations on this thread.
+    static thread_local std::vector<casadi_int> iw;
+    static thread_local std::vector<double> w;
+    iw.resize(m_compiled.sz_iw());
+    w.resize(m_compiled.sz_w());
+    const casadi_int mem = m_compiled.checkout();
+    const int status = m_compiled(arg, res, iw.data(), w.data(), mem);
+    m_compiled.release(mem);
+    return status;
+}
+
+casadi::Function CompiledFunction::compileDerivative(
+        const casadi::Function& derivative) const {
+    m_derivatives.push_back(OpenSim::make_unique<CompiledFunction>());
+    m_derivatives.back()->constructFunction(
+            derivative, m_cacheDir, m_compiler);
+    return *m_derivatives.back();
+}
+
+casadi::Function CompiledFunction::get_jacobian(const std::string&,
+        const std::vector<std::string>&, const std::vector<std::string>&,
+        const casadi::Dict&) const {
+    return compileDerivative(m_function.jacobian());
+}
+
+casadi::Function CompiledFunction::get_forward(casadi_int nfwd,
+        const std::string&, const std::vector<std::string>&,
+        const std::vector<std::string>&, const casadi::Dict&) const {
+    return compileDerivative(m_function.forward(nfwd));
+}
+
+casadi::Function CompiledFunction::get_reverse(casadi_int nadj,
+        const std::string&, const std::vector<std::string>&,
+        const std::vector<std::string>&, const casadi::Dict&) const {
+    return compileDerivative(m_function.reverse(nadj));
+}
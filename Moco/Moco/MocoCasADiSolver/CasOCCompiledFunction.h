@@ -0,0 +1,99 @@
+#ifndef MOCO_CASOCCOMPILEDFUNCTION_H
+#define MOCO_CASOCCOMPILEDFUNCTION_H
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: CasOCCompiledFunction.h                                      *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <casadi/casadi.hpp>
+#include <memory>
+
+namespace CasOC {
+
+/// This function evaluates a symbolic (SX) CasADi function using C code that
+/// is generated from the function, compiled into a shared library with the
+/// system's C compiler, and loaded at runtime. Derivatives are the
+/// derivatives of the symbolic function, compiled in the same way when CasADi
+/// first requests them.
+///
+/// Libraries are stored in a cache directory under a name that contains a
+/// hash of the generated code, next to the code itself; a library is reused
+/// only if its code matches the generated code. The code depends only on the
+/// structure of the function (e.g., the number of states), so repeated
+/// studies of a problem reuse the libraries and skip compilation. Since the
+/// libraries are loaded into this process, the cache directory is created
+/// with permissions for the current user only, and the directory and the
+/// libraries must be owned by the current user and must not be writable by
+/// other users.
+class CompiledFunction : public casadi::Callback {
+public:
+    /// The compiler is invoked, without a shell, as `<compiler> -O2 -fPIC
+    /// -shared <source> -o <library>`; `compiler` is split at whitespace.
+    void constructFunction(const casadi::Function& function,
+            const std::string& cacheDir, const std::string& compiler);
+    casadi_int get_n_in() override { return m_function.n_in(); }
+    casadi_int get_n_out() override { return m_function.n_out(); }
+    std::string get_name_in(casadi_int i) override {
+        return m_function.name_in(i);
+    }
+    std::string get_name_out(casadi_int i) override {
+        return m_function.name_out(i);
+    }
+    casadi::Sparsity get_sparsity_in(casadi_int i) override {
+        return m_function.sparsity_in(i);
+    }
+    casadi::Sparsity get_sparsity_out(casadi_int i) override {
+        return m_function.sparsity_out(i);
+    }
+    bool has_eval_buffer() const override { return true; }
+    int eval_buffer(const double** arg,
+            const std::vector<casadi_int>& sizes_arg, double** res,
+            const std::vector<casadi_int>& sizes_res) const override;
+
+    bool has_jacobian_sparsity() const override { return true; }
+    casadi::Sparsity get_jacobian_sparsity() const override {
+        return m_function.jacobian().sparsity_out(0);
+    }
+    bool has_jacobian() const override { return true; }
+    casadi::Function get_jacobian(const std::string& name,
+            const std::vector<std::string>& inames,
+            const std::vector<std::string>& onames,
+            const casadi::Dict& opts) const override;
+    bool has_forward(casadi_int) const override { return true; }
+    casadi::Function get_forward(casadi_int nfwd, const std::string& name,
+            const std::vector<std::string>& inames,
+            const std::vector<std::string>& onames,
+            const casadi::Dict& opts) const override;
+    bool has_reverse(casadi_int) const override { return true; }
+    casadi::Function get_reverse(casadi_int nadj, const std::string& name,
+            const std::vector<std::string>& inames,
+            const std::vector<std::string>& onames,
+            const casadi::Dict& opts) const override;
+
+private:
+    casadi::Function compileDerivative(
+            const casadi::Function& derivative) const;
+
+    casadi::Function m_function;
+    casadi::Function m_compiled;
+    std::string m_cacheDir;
+    std::string m_compiler;
+    mutable std::vector<std::unique_ptr<CompiledFunction>> m_derivatives;
+};
+
+} // namespace CasOC
+
+#endif // MOCO_CASOCCOMPILEDFUNCTION_H
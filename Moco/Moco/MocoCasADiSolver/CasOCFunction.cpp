@@ -19,6 +19,8 @@
 #include "CasOCFunction.h"
 
 #include "CasOCProblem.h"
+#include <algorithm>
+#include <cmath>
 
 using namespace CasOC;
 
@@ -73,7 +75,11 @@ casadi::Sparsity calcJacobianSparsityWithPerturbation(const VectorDM& x0s,
     return combinedSparsity;
 }
 
+Function::~Function() = default;
+
 casadi::Sparsity Function::get_jacobian_sparsity() const {
+    if (m_jacobianSparsityDetected) return m_jacobianSparsity;
+
     using casadi::DM;
     using casadi::Slice;
 
@@ -100,8 +106,271 @@ casadi::Sparsity Function::get_jacobian_sparsity() const {
 
     const VectorDM x0s = getSubsetPointsForSparsityDetection();
 
-    return calcJacobianSparsityWithPerturbation(
+    m_jacobianSparsity = calcJacobianSparsityWithPerturbation(
             x0s, (int)this->nnz_out(), function);
+    m_jacobianSparsityDetected = true;
+    return m_jacobianSparsity;
+}
+
+casadi::Sparsity Function::getJacobianSparsity() const {
+    if (has_jacobian_sparsity()) return get_jacobian_sparsity();
+    return casadi::Sparsity::dense(nnz_out(), nnz_in());
+}
+
+const FiniteDifferenceJacobian& Function::getFiniteDifferenceJacobian() const {
+    if (!m_jacobian) {
+        std::vector<std::string> inames;
+        for (int i = 0; i < (int)n_in(); ++i) inames.push_back(name_in(i));
+        for (int i = 0; i < (int)n_out(); ++i) {
+            inames.push_back("out_" + name_out(i));
+        }
+        m_jacobian = OpenSim::make_unique<FiniteDifferenceJacobian>();
+        m_jacobian->constructFunction(this, m_casProblem, "jac_" + name(),
+                inames, {"jac"}, getJacobianSparsity(),
+                m_finite_difference_scheme);
+    }
+    return *m_jacobian;
+}
+
+casadi::Function Function::get_jacobian(const std::string&,
+        const std::vector<std::string>&, const std::vector<std::string>&,
+        const casadi::Dict&) const {
+    return getFiniteDifferenceJacobian();
+}
+
+casadi::Function Function::get_forward(casadi_int nfwd,
+        const std::string& name, const std::vector<std::string>& inames,
+        const std::vector<std::string>& onames,
+        const casadi::Dict& opts) const {
+    using casadi::MX;
+    using casadi::Slice;
+    // Forward sensitivities are the product of the Jacobian and the seeds.
+    // All inputs and outputs are dense column vectors.
+    std::vector<MX> in;
+    for (int i = 0; i < (int)n_in(); ++i) {
+        in.push_back(MX::sym(name_in(i), sparsity_in(i)));
+    }
+    for (int i = 0; i < (int)n_out(); ++i) {
+        in.push_back(MX::sym("out_" + name_out(i), sparsity_out(i)));
+    }
+    const MX jac = getFiniteDifferenceJacobian()(in).at(0);
+    std::vector<MX> seeds;
+    for (int i = 0; i < (int)n_in(); ++i) {
+        seeds.push_back(MX::sym("fwd_" + name_in(i), size1_in(i), nfwd));
+    }
+    const MX sens = mtimes(jac, MX::vertcat(seeds));
+    std::vector<MX> out;
+    casadi_int offset = 0;
+    for (int i = 0; i < (int)n_out(); ++i) {
+        out.push_back(sens(Slice(offset, offset + size1_out(i)), Slice()));
+        offset += size1_out(i);
+    }
+    in.insert(in.end(), seeds.begin(), seeds.end());
+    return casadi::Function(name, in, out, inames, onames, opts);
+}
+
+casadi::Function Function::get_reverse(casadi_int nadj,
+        const std::string& name, const std::vector<std::string>& inames,
+        const std::vector<std::string>& onames,
+        const casadi::Dict& opts) const {
+    using casadi::MX;
+    using casadi::Slice;
+    // Adjoint sensitivities are the product of the transposed Jacobian and
+    // the seeds.
+    std::vector<MX> in;
+    for (int i = 0; i < (int)n_in(); ++i) {
+        in.push_back(MX::sym(name_in(i), sparsity_in(i)));
+    }
+    for (int i = 0; i < (int)n_out(); ++i) {
+        in.push_back(MX::sym("out_" + name_out(i), sparsity_out(i)));
+    }
+    const MX jac = getFiniteDifferenceJacobian()(in).at(0);
+    std::vector<MX> seeds;
+    for (int i = 0; i < (int)n_out(); ++i) {
+        seeds.push_back(MX::sym("adj_" + name_out(i), size1_out(i), nadj));
+    }
+    const MX sens = mtimes(jac.T(), MX::vertcat(seeds));
+    std::vector<MX> out;
+    casadi_int offset = 0;
+    for (int i = 0; i < (int)n_in(); ++i) {
+        out.push_back(sens(Slice(offset, offset + size1_in(i)), Slice()));
+        offset += size1_in(i);
+    }
+    in.insert(in.end(), seeds.begin(), seeds.end());
+    return casadi::Function(name, in, out, inames, onames, opts);
+}
+
+void FiniteDifferenceJacobian::constructFunction(const Function* function,
+        const Problem* casProblem, const std::string& name,
+        std::vector<std::string> inames, std::vector<std::string> onames,
+        casadi::Sparsity sparsity, const std::string& finiteDiffScheme) {
+    OPENSIM_THROW_IF(finiteDiffScheme != "central" &&
+                             finiteDiffScheme != "forward" &&
+                             finiteDiffScheme != "backward",
+            OpenSim::Exception,
+            format("Unrecognized finite difference scheme '%s'.",
+                    finiteDiffScheme));
+    m_function = function;
+    m_casProblem = casProblem;
+    m_inames = std::move(inames);
+    m_onames = std::move(onames);
+    m_sparsity = std::move(sparsity);
+    m_finite_difference_scheme = finiteDiffScheme;
+
+    m_inputOffsets.assign(1, 0);
+    for (casadi_int i = 0; i < function->n_in(); ++i) {
+        m_inputOffsets.push_back(m_inputOffsets.back() + function->nnz_in(i));
+    }
+    m_outputOffsets.assign(1, 0);
+    for (casadi_int i = 0; i < function->n_out(); ++i) {
+        m_outputOffsets.push_back(
+                m_outputOffsets.back() + function->nnz_out(i));
+    }
+    OPENSIM_THROW_IF(m_inputOffsets.back() != m_sparsity.size2() ||
+                             m_outputOffsets.back() != m_sparsity.size1(),
+            OpenSim::Exception, "Internal error.");
+
+    // Greedily assign each column to the first group with which it shares no
+    // nonzero rows. Columns without nonzeros need not be perturbed.
+    m_columnGroups.clear();
+    std::vector<std::vector<bool>> rowsInGroup;
+    const casadi_int* colind = m_sparsity.colind();
+    const casadi_int* row = m_sparsity.row();
+    for (casadi_int j = 0; j < m_sparsity.size2(); ++j) {
+        if (colind[j] == colind[j + 1]) continue;
+        int igroup = 0;
+        for (; igroup < (int)m_columnGroups.size(); ++igroup) {
+            bool overlaps = false;
+            for (casadi_int k = colind[j]; k < colind[j + 1]; ++k) {
+                if (rowsInGroup[igroup][row[k]]) {
+                    overlaps = true;
+                    break;
+                }
+            }
+            if (!overlaps) break;
+        }
+        if (igroup == (int)m_columnGroups.size()) {
+            m_columnGroups.emplace_back();
+            rowsInGroup.emplace_back(m_sparsity.size1(), false);
+        }
+        m_columnGroups[igroup].push_back(j);
+        for (casadi_int k = colind[j]; k < colind[j + 1]; ++k) {
+            rowsInGroup[igroup][row[k]] = true;
+        }
+    }
+
+    casadi::Dict opts;
+    // Second derivatives, if requested, are computed with CasADi's finite
+    // differences of this function.
+    opts["enable_fd"] = true;
+    opts["fd_method"] = finiteDiffScheme;
+    this->construct(name, opts);
+}
+
+int FiniteDifferenceJacobian::eval_buffer(const double** arg,
+        const std::vector<casadi_int>&, double** res,
+        const std::vector<casadi_int>&) const {
+    if (!res[0]) return 0;
+    const casadi_int numIn = m_function->n_in();
+    const casadi_int numOut = m_function->n_out();
+    const casadi_int numInputs = m_inputOffsets.back();
+    const casadi_int numOutputs = m_outputOffsets.back();
+
+    // These buffers are reused across evaluations on this thread. The
+    // perturbed inputs are the concatenation of all inputs, so that column j
+    // of the Jacobian corresponds to x[j].
+    // CasADi passes null for inputs that are zero.
+    static thread_local std::vector<double> x0;
+    static thread_local std::vector<double> x;
+    static thread_local std::vector<double> steps;
+    static thread_local std::vector<double> outputs;
+    static thread_local std::vector<const double*> in;
+    static thread_local std::vector<double*> out;
+    x.resize(numInputs);
+    steps.resize(numInputs);
+    outputs.resize(3 * numOutputs);
+    in.resize(numIn);
+    out.resize(numOut);
+    for (casadi_int i = 0; i < numIn; ++i) {
+        const casadi_int size = m_inputOffsets[i + 1] - m_inputOffsets[i];
+        if (arg[i]) {
+            std::copy_n(arg[i], size, x.data() + m_inputOffsets[i]);
+        } else {
+            std::fill_n(x.data() + m_inputOffsets[i], size, 0.0);
+        }
+        in[i] = x.data() + m_inputOffsets[i];
+    }
+    x0 = x;
+    double* plus = outputs.data();
+    double* minus = plus + numOutputs;
+    double* nominal = minus + numOutputs;
+    auto evalFunction = [&](double* output) {
+        for (casadi_int i = 0; i < numOut; ++i) {
+            out[i] = output + m_outputOffsets[i];
+        }
+        m_function->evalBuffers(in.data(), out.data());
+    };
+
+    const bool central = m_finite_difference_scheme == "central";
+    const bool forward = m_finite_difference_scheme == "forward";
+    // These step sizes balance truncation and roundoff error.
+    const double relStep =
+            central ? std::cbrt(SimTK::Eps) : std::sqrt(SimTK::Eps);
+
+    double* jacNonzeros = res[0];
+    const casadi_int* colind = m_sparsity.colind();
+    const casadi_int* row = m_sparsity.row();
+
+    m_casProblem->beginRepeatedEvaluations();
+    try {
+        // Forward and backward differences reuse the nominal output, unless
+        // CasADi did not provide it.
+        if (!central) {
+            bool providedNominal = true;
+            for (casadi_int i = 0; i < numOut; ++i) {
+                providedNominal = providedNominal && arg[numIn + i];
+            }
+            if (providedNominal) {
+                for (casadi_int i = 0; i < numOut; ++i) {
+                    std::copy_n(arg[numIn + i],
+                            m_outputOffsets[i + 1] - m_outputOffsets[i],
+                            nominal + m_outputOffsets[i]);
+                }
+            } else {
+                evalFunction(nominal);
+            }
+        }
+        for (const auto& group : m_columnGroups) {
+            for (const auto& j : group) {
+                steps[j] = relStep * std::max(1.0, std::abs(x0[j]));
+                x[j] = forward || central ? x0[j] + steps[j] : x0[j] - steps[j];
+            }
+            evalFunction(forward || central ? plus : minus);
+            if (central) {
+                for (const auto& j : group) x[j] = x0[j] - steps[j];
+                evalFunction(minus);
+            }
+            for (const auto& j : group) x[j] = x0[j];
+
+            for (const auto& j : group) {
+                for (casadi_int k = colind[j]; k < colind[j + 1]; ++k) {
+                    const auto i = row[k];
+                    if (central) {
+                        jacNonzeros[k] = (plus[i] - minus[i]) / (2 * steps[j]);
+                    } else if (forward) {
+                        jacNonzeros[k] = (plus[i] - nominal[i]) / steps[j];
+                    } else {
+                        jacNonzeros[k] = (nominal[i] - minus[i]) / steps[j];
+                    }
+                }
+            }
+        }
+    } catch (...) {
+        m_casProblem->endRepeatedEvaluations();
+        throw;
+    }
+    m_casProblem->endRepeatedEvaluations();
+    return 0;
 }
 
 void Function::constructFunction(const Problem* casProblem,
@@ -116,6 +385,67 @@ void Function::constructFunction(const Problem* casProblem,
     this->construct(name, opts);
 }
 
+int Function::eval_buffer(const double** arg,
+        const std::vector<casadi_int>& sizes_arg, double** res,
+        const std::vector<casadi_int>& sizes_res) const {
+    // CasADi passes null for inputs that are zero and for outputs that are
+    // not needed. In that case, we substitute buffers that are reused across
+    // evaluations on this thread.
+    bool allProvided = true;
+    for (casadi_int i = 0; i < (casadi_int)sizes_arg.size(); ++i) {
+        allProvided = allProvided && (arg[i] || !sizes_arg[i]);
+    }
+    for (casadi_int i = 0; i < (casadi_int)sizes_res.size(); ++i) {
+        allProvided = allProvided && (res[i] || !sizes_res[i]);
+    }
+    if (allProvided) {
+        evalBuffers(arg, res);
+        return 0;
+    }
+
+    static thread_local std::vector<double> zeros;
+    static thread_local std::vector<double> unusedOutputs;
+    static thread_local std::vector<const double*> args;
+    static thread_local std::vector<double*> results;
+    casadi_int maxSizeArg = 0;
+    for (const auto& size : sizes_arg) maxSizeArg = std::max(maxSizeArg, size);
+    casadi_int totalSizeRes = 0;
+    for (const auto& size : sizes_res) totalSizeRes += size;
+    zeros.assign(maxSizeArg, 0.0);
+    unusedOutputs.resize(totalSizeRes);
+    args.assign(arg, arg + sizes_arg.size());
+    results.assign(res, res + sizes_res.size());
+    for (auto& a : args) {
+        if (!a) a = zeros.data();
+    }
+    casadi_int offset = 0;
+    for (casadi_int i = 0; i < (casadi_int)results.size(); ++i) {
+        if (!results[i]) results[i] = unusedOutputs.data() + offset;
+        offset += sizes_res[i];
+    }
+    evalBuffers(args.data(), results.data());
+    return 0;
+}
+
+VectorDM Function::eval(const VectorDM& args) const {
+    std::vector<const double*> arg(args.size());
+    std::vector<casadi_int> sizes_arg(args.size());
+    for (int i = 0; i < (int)args.size(); ++i) {
+        arg[i] = args[i].ptr();
+        sizes_arg[i] = args[i].nnz();
+    }
+    VectorDM out(n_out());
+    std::vector<double*> res(out.size());
+    std::vector<casadi_int> sizes_res(out.size());
+    for (int i = 0; i < (int)out.size(); ++i) {
+        out[i] = casadi::DM(sparsity_out(i));
+        res[i] = out[i].ptr();
+        sizes_res[i] = out[i].nnz();
+    }
+    eval_buffer(arg.data(), sizes_arg, res.data(), sizes_res);
+    return out;
+}
+
 casadi::Sparsity Function::get_sparsity_in(casadi_int i) {
     if (i == 0) {
         return casadi::Sparsity::dense(1, 1);
@@ -134,29 +464,26 @@ casadi::Sparsity Function::get_sparsity_in(casadi_int i) {
     }
 }
 
-VectorDM PathConstraint::eval(const VectorDM& args) const {
-    Problem::ContinuousInput input{args.at(0).scalar(), args.at(1), args.at(2),
-            args.at(3), args.at(4), args.at(5)};
-    VectorDM out{casadi::DM(sparsity_out(0))};
-    m_casProblem->calcPathConstraint(m_index, input, out[0]);
-    return out;
+void PathConstraint::evalBuffers(const double** arg, double** res) const {
+    Problem::ContinuousInput input{*arg[0], getInput(arg, 1),
+            getInput(arg, 2), getInput(arg, 3), getInput(arg, 4),
+            getInput(arg, 5)};
+    m_casProblem->calcPathConstraint(m_index, input, getOutput(res, 0));
 }
 
-VectorDM CostIntegrand::eval(const VectorDM& args) const {
-    Problem::ContinuousInput input{args.at(0).scalar(), args.at(1), args.at(2),
-            args.at(3), args.at(4), args.at(5)};
-    VectorDM out{casadi::DM(casadi::Sparsity::scalar())};
-    m_casProblem->calcCostIntegrand(m_index, input, *out[0].ptr());
-    return out;
+void CostIntegrand::evalBuffers(const double** arg, double** res) const {
+    Problem::ContinuousInput input{*arg[0], getInput(arg, 1),
+            getInput(arg, 2), getInput(arg, 3), getInput(arg, 4),
+            getInput(arg, 5)};
+    m_casProblem->calcCostIntegrand(m_index, input, *res[0]);
 }
 
-VectorDM EndpointConstraintIntegrand::eval(const VectorDM& args) const {
-    Problem::ContinuousInput input{args.at(0).scalar(), args.at(1), args.at(2),
-                                   args.at(3), args.at(4), args.at(5)};
-    VectorDM out{casadi::DM(casadi::Sparsity::scalar())};
-    m_casProblem->calcEndpointConstraintIntegrand(
-            m_index, input, *out[0].ptr());
-    return out;
+void EndpointConstraintIntegrand::evalBuffers(
+        const double** arg, double** res) const {
+    Problem::ContinuousInput input{*arg[0], getInput(arg, 1),
+            getInput(arg, 2), getInput(arg, 3), getInput(arg, 4),
+            getInput(arg, 5)};
+    m_casProblem->calcEndpointConstraintIntegrand(m_index, input, *res[0]);
 }
 
 casadi::Sparsity Endpoint::get_sparsity_in(casadi_int i) {
@@ -188,21 +515,19 @@ casadi::Sparsity Endpoint::get_sparsity_in(casadi_int i) {
         return casadi::Sparsity(0, 0);
     }
 }
-VectorDM Cost::eval(const VectorDM& args) const {
-    Problem::CostInput input{args.at(0).scalar(), args.at(1), args.at(2),
-            args.at(3), args.at(4), args.at(5).scalar(), args.at(6), args.at(7),
-            args.at(8), args.at(9), args.at(10), args.at(11).scalar()};
-    VectorDM out{casadi::DM(sparsity_out(0))};
-    m_casProblem->calcCost(m_index, input, out.at(0));
-    return out;
+void Cost::evalBuffers(const double** arg, double** res) const {
+    Problem::CostInput input{*arg[0], getInput(arg, 1), getInput(arg, 2),
+            getInput(arg, 3), getInput(arg, 4), *arg[5], getInput(arg, 6),
+            getInput(arg, 7), getInput(arg, 8), getInput(arg, 9),
+            getInput(arg, 10), *arg[11]};
+    m_casProblem->calcCost(m_index, input, getOutput(res, 0));
 }
-VectorDM EndpointConstraint::eval(const VectorDM& args) const {
-    Problem::CostInput input{args.at(0).scalar(), args.at(1), args.at(2),
-            args.at(3), args.at(4), args.at(5).scalar(), args.at(6), args.at(7),
-            args.at(8), args.at(9), args.at(10), args.at(11).scalar()};
-    VectorDM out{casadi::DM(sparsity_out(0))};
-    m_casProblem->calcEndpointConstraint(m_index, input, out.at(0));
-    return out;
+void EndpointConstraint::evalBuffers(const double** arg, double** res) const {
+    Problem::CostInput input{*arg[0], getInput(arg, 1), getInput(arg, 2),
+            getInput(arg, 3), getInput(arg, 4), *arg[5], getInput(arg, 6),
+            getInput(arg, 7), getInput(arg, 8), getInput(arg, 9),
+            getInput(arg, 10), *arg[11]};
+    m_casProblem->calcEndpointConstraint(m_index, input, getOutput(res, 0));
 }
 
 template <bool CalcKCErrors>
@@ -230,18 +555,14 @@ casadi::Sparsity MultibodySystemExplicit<CalcKCErrors>::get_sparsity_out(
 }
 
 template <bool CalcKCErrors>
-VectorDM MultibodySystemExplicit<CalcKCErrors>::eval(
-        const VectorDM& args) const {
-    Problem::ContinuousInput input{args.at(0).scalar(), args.at(1), args.at(2),
-            args.at(3), args.at(4), args.at(5)};
-    VectorDM out((int)n_out());
-    for (casadi_int i = 0; i < n_out(); ++i) {
-        out[i] = casadi::DM(sparsity_out(i));
-    }
-    Problem::MultibodySystemExplicitOutput output{out[0], out[1], out[2],
-            out[3]};
+void MultibodySystemExplicit<CalcKCErrors>::evalBuffers(
+        const double** arg, double** res) const {
+    Problem::ContinuousInput input{*arg[0], getInput(arg, 1),
+            getInput(arg, 2), getInput(arg, 3), getInput(arg, 4),
+            getInput(arg, 5)};
+    Problem::MultibodySystemExplicitOutput output{getOutput(res, 0),
+            getOutput(res, 1), getOutput(res, 2), getOutput(res, 3)};
     m_casProblem->calcMultibodySystemExplicit(input, CalcKCErrors, output);
-    return out;
 }
 
 template class CasOC::MultibodySystemExplicit<false>;
@@ -283,11 +604,9 @@ casadi::DM VelocityCorrection::getSubsetPoint(
             fullPoint.at(slacks)(Slice(), itime), fullPoint.at(parameters)});
 }
 
-VectorDM VelocityCorrection::eval(const VectorDM& args) const {
-    VectorDM out{casadi::DM(sparsity_out(0))};
-    m_casProblem->calcVelocityCorrection(
-            args.at(0).scalar(), args.at(1), args.at(2), args.at(3), out[0]);
-    return out;
+void VelocityCorrection::evalBuffers(const double** arg, double** res) const {
+    m_casProblem->calcVelocityCorrection(*arg[0], getInput(arg, 1),
+            getInput(arg, 2), getInput(arg, 3), getOutput(res, 0));
 }
 
 template <bool CalcKCErrors>
@@ -315,19 +634,14 @@ casadi::Sparsity MultibodySystemImplicit<CalcKCErrors>::get_sparsity_out(
 }
 
 template <bool CalcKCErrors>
-VectorDM MultibodySystemImplicit<CalcKCErrors>::eval(
-        const VectorDM& args) const {
-    Problem::ContinuousInput input{args.at(0).scalar(), args.at(1), args.at(2),
-            args.at(3), args.at(4), args.at(5)};
-    VectorDM out((int)n_out());
-    for (casadi_int i = 0; i < n_out(); ++i) {
-        out[i] = casadi::DM(sparsity_out(i));
-    }
-
-    Problem::MultibodySystemImplicitOutput output{out[0], out[1], out[2], 
-            out[3]};
+void MultibodySystemImplicit<CalcKCErrors>::evalBuffers(
+        const double** arg, double** res) const {
+    Problem::ContinuousInput input{*arg[0], getInput(arg, 1),
+            getInput(arg, 2), getInput(arg, 3), getInput(arg, 4),
+            getInput(arg, 5)};
+    Problem::MultibodySystemImplicitOutput output{getOutput(res, 0),
+            getOutput(res, 1), getOutput(res, 2), getOutput(res, 3)};
     m_casProblem->calcMultibodySystemImplicit(input, CalcKCErrors, output);
-    return out;
 }
 
 template class CasOC::MultibodySystemImplicit<false>;
@@ -25,12 +25,41 @@
 namespace CasOC {
 
 class Problem;
+class FiniteDifferenceJacobian;
 
 using VectorDM = std::vector<casadi::DM>;
 
+/// A non-owning view of a dense column vector stored in a buffer (e.g., a
+/// buffer that CasADi provides to Function::eval_buffer()). The view provides
+/// the subset of the casadi::DM interface that Problems use.
+template <typename T>
+class VectorView {
+public:
+    VectorView(T* data, casadi_int size) : m_data(data), m_size(size) {}
+    T* ptr() const { return m_data; }
+    casadi_int size1() const { return m_size; }
+    casadi_int rows() const { return m_size; }
+    casadi_int numel() const { return m_size; }
+    T& operator[](casadi_int i) const { return m_data[i]; }
+
+private:
+    T* m_data;
+    casadi_int m_size;
+};
+using InputVector = VectorView<const double>;
+using OutputVector = VectorView<double>;
+
+/// Functions compute their derivatives with finite differences. Rather than
+/// letting CasADi perturb the function one direction at a time, we provide
+/// the Jacobian ourselves (see FiniteDifferenceJacobian) and compute forward
+/// and reverse derivatives from this Jacobian.
+/// CasADi evaluates Functions through eval_buffer(), which passes pointers to
+/// CasADi's preallocated work vectors; derived classes implement
+/// evalBuffers() and write their outputs directly into these buffers, so
+/// evaluating a Function does not allocate memory.
 class Function : public casadi::Callback {
 public:
-    virtual ~Function() = default;
+    virtual ~Function();
     void constructFunction(const Problem* casProblem, const std::string& name,
             const std::string& finiteDiffScheme,
             std::shared_ptr<const std::vector<VariablesDM>>
@@ -63,10 +92,52 @@ public:
     }
     casadi::Sparsity get_jacobian_sparsity() const override;
 
+    bool has_eval_buffer() const override { return true; }
+    int eval_buffer(const double** arg,
+            const std::vector<casadi_int>& sizes_arg, double** res,
+            const std::vector<casadi_int>& sizes_res) const override;
+    /// This allocates the outputs, and is intended for use outside of the
+    /// optimization (e.g., detecting sparsity).
+    VectorDM eval(const VectorDM& args) const override;
+
+    bool has_jacobian() const override { return true; }
+    casadi::Function get_jacobian(const std::string& name,
+            const std::vector<std::string>& inames,
+            const std::vector<std::string>& onames,
+            const casadi::Dict& opts) const override;
+    bool has_forward(casadi_int) const override { return true; }
+    casadi::Function get_forward(casadi_int nfwd, const std::string& name,
+            const std::vector<std::string>& inames,
+            const std::vector<std::string>& onames,
+            const casadi::Dict& opts) const override;
+    bool has_reverse(casadi_int) const override { return true; }
+    casadi::Function get_reverse(casadi_int nadj, const std::string& name,
+            const std::vector<std::string>& inames,
+            const std::vector<std::string>& onames,
+            const casadi::Dict& opts) const override;
+
 protected:
+    /// Evaluate this function. The buffers are never null, and have the sizes
+    /// given by the input and output sparsities. The buffers are valid only
+    /// for the duration of the call.
+    virtual void evalBuffers(const double** arg, double** res) const = 0;
+    InputVector getInput(const double** arg, casadi_int i) const {
+        return {arg[i], nnz_in(i)};
+    }
+    OutputVector getOutput(double** res, casadi_int i) const {
+        return {res[i], nnz_out(i)};
+    }
+
     const Problem* m_casProblem;
 
 private:
+    friend class FiniteDifferenceJacobian;
+
+    /// The Jacobian sparsity, or a dense sparsity if we have no points for
+    /// detecting the sparsity.
+    casadi::Sparsity getJacobianSparsity() const;
+    const FiniteDifferenceJacobian& getFiniteDifferenceJacobian() const;
+
     /// Here, "point" refers to a vector of all variables in the optimization
     /// problem.
     VectorDM getSubsetPointsForSparsityDetection() const {
@@ -91,6 +162,62 @@ private:
 
     std::shared_ptr<const std::vector<VariablesDM>>
             m_fullPointsForSparsityDetection;
+
+    // Detecting the sparsity is expensive, so we only do so once.
+    mutable bool m_jacobianSparsityDetected = false;
+    mutable casadi::Sparsity m_jacobianSparsity;
+    mutable std::unique_ptr<FiniteDifferenceJacobian> m_jacobian;
+};
+
+/// This function computes the Jacobian of a Function with finite differences.
+/// Columns of the Jacobian that share no nonzero rows are grouped and
+/// perturbed together (Curtis, Powell, and Reid, 1974), so the number of
+/// function evaluations is the number of groups rather than the number of
+/// inputs. The function is evaluated directly (without CasADi's overhead),
+/// all evaluations occur between Problem::beginRepeatedEvaluations() and
+/// Problem::endRepeatedEvaluations(), and forward and backward differences
+/// reuse the nominal output that CasADi provides.
+/// The inputs are the inputs and nominal outputs of the function, and the
+/// output is the Jacobian of all outputs with respect to all inputs.
+class FiniteDifferenceJacobian : public casadi::Callback {
+public:
+    void constructFunction(const Function* function, const Problem* casProblem,
+            const std::string& name, std::vector<std::string> inames,
+            std::vector<std::string> onames, casadi::Sparsity sparsity,
+            const std::string& finiteDiffScheme);
+    casadi_int get_n_in() override {
+        return m_function->n_in() + m_function->n_out();
+    }
+    casadi_int get_n_out() override { return 1; }
+    std::string get_name_in(casadi_int i) override { return m_inames.at(i); }
+    std::string get_name_out(casadi_int i) override { return m_onames.at(i); }
+    casadi::Sparsity get_sparsity_in(casadi_int i) override {
+        if (i < m_function->n_in()) return m_function->sparsity_in(i);
+        return m_function->sparsity_out(i - m_function->n_in());
+    }
+    casadi::Sparsity get_sparsity_out(casadi_int) override {
+        return m_sparsity;
+    }
+    bool has_eval_buffer() const override { return true; }
+    int eval_buffer(const double** arg,
+            const std::vector<casadi_int>& sizes_arg, double** res,
+            const std::vector<casadi_int>& sizes_res) const override;
+
+private:
+    const Function* m_function = nullptr;
+    const Problem* m_casProblem = nullptr;
+    std::vector<std::string> m_inames;
+    std::vector<std::string> m_onames;
+    casadi::Sparsity m_sparsity;
+    std::string m_finite_difference_scheme;
+    /// Each group contains columns of the Jacobian that share no nonzero rows.
+    std::vector<std::vector<casadi_int>> m_columnGroups;
+    /// The offset of each input (and output) of the function within the
+    /// concatenation of all inputs (and outputs), with the total size as the
+    /// last element. The columns of the Jacobian correspond to the elements of
+    /// the concatenated inputs.
+    std::vector<casadi_int> m_inputOffsets;
+    std::vector<casadi_int> m_outputOffsets;
 };
 
 class PathConstraint : public Function {
@@ -117,7 +244,7 @@ public:
         } else
             return casadi::Sparsity(0, 0);
     }
-    VectorDM eval(const VectorDM& args) const override;
+    void evalBuffers(const double** arg, double** res) const override;
 
 protected:
     int m_index = -1;
@@ -154,12 +281,12 @@ protected:
 
 class CostIntegrand : public Integrand {
 public:
-    VectorDM eval(const VectorDM& args) const override;
+    void evalBuffers(const double** arg, double** res) const override;
 };
 
 class EndpointConstraintIntegrand : public Integrand {
 public:
-    VectorDM eval(const VectorDM& args) const override;
+    void evalBuffers(const double** arg, double** res) const override;
 };
 
 /// This function takes initial states/controls, final states/controls, and an
@@ -241,13 +368,13 @@ protected:
 /// This invokes CasOC::Problem::calcCost().
 class Cost : public Endpoint {
 public:
-    VectorDM eval(const VectorDM& args) const override;
+    void evalBuffers(const double** arg, double** res) const override;
 };
 
 /// This invokes CasOC::Problem::calcEndpointConstraint().
 class EndpointConstraint : public Endpoint {
 public:
-    VectorDM eval(const VectorDM& args) const override;
+    void evalBuffers(const double** arg, double** res) const override;
 
 };
 
@@ -267,7 +394,7 @@ public:
         }
     }
     casadi::Sparsity get_sparsity_out(casadi_int i) override final;
-    VectorDM eval(const VectorDM& args) const override;
+    void evalBuffers(const double** arg, double** res) const override;
 };
 
 /// This function should compute a velocity correction term to make feasible
@@ -293,7 +420,7 @@ public:
     }
     casadi::Sparsity get_sparsity_in(casadi_int i) override final;
     casadi::Sparsity get_sparsity_out(casadi_int i) override final;
-    VectorDM eval(const VectorDM& args) const override;
+    void evalBuffers(const double** arg, double** res) const override;
     casadi::DM getSubsetPoint(const VariablesDM& fullPoint) const override;
 };
 
@@ -310,7 +437,7 @@ class MultibodySystemImplicit : public Function {
         }
     }
     casadi::Sparsity get_sparsity_out(casadi_int i) override final;
-    VectorDM eval(const VectorDM& args) const override;
+    void evalBuffers(const double** arg, double** res) const override;
 };
 
 } // namespace CasOC
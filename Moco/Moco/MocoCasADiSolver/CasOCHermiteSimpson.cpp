@@ -20,6 +20,27 @@
 using casadi::DM;
 using casadi::MX;
 using casadi::Slice;
+using casadi::SX;
+
+namespace {
+/// The Hermite interpolant and Simpson integration defects for a single mesh
+/// interval.
+template <typename T>
+T calcIntervalDefects(const T& h, const T& x_i, const T& x_mid, const T& x_ip1,
+        const T& xdot_i, const T& xdot_mid, const T& xdot_ip1) {
+    return T::vertcat({
+            // Hermite interpolant defects.
+            x_mid - 0.5 * (x_ip1 + x_i) - (h / 8.0) * (xdot_i - xdot_ip1),
+            // Simpson integration defects.
+            x_ip1 - x_i - (h / 6.0) * (xdot_ip1 + 4.0 * xdot_mid + xdot_i)});
+}
+
+template <typename T>
+T calcIntervalInterpolatingControls(
+        const T& c_i, const T& c_mid, const T& c_ip1) {
+    return c_mid - 0.5 * (c_ip1 + c_i);
+}
+} // namespace
 
 namespace CasOC {
 
@@ -56,6 +77,28 @@ void HermiteSimpson::calcDefectsImpl(const casadi::MX& x,
 
     const int NS = m_problem.getNumStates();
 
+    if (m_solver.getSXTranscriptionFormulas()) {
+        const SX h = SX::sym("h");
+        const SX x_i = SX::sym("x_i", NS);
+        const SX x_mid = SX::sym("x_mid", NS);
+        const SX x_ip1 = SX::sym("x_ip1", NS);
+        const SX xdot_i = SX::sym("xdot_i", NS);
+        const SX xdot_mid = SX::sym("xdot_mid", NS);
+        const SX xdot_ip1 = SX::sym("xdot_ip1", NS);
+        const casadi::Function intervalDefects("hermite_simpson_defects",
+                {h, x_i, x_mid, x_ip1, xdot_i, xdot_mid, xdot_ip1},
+                {calcIntervalDefects(
+                        h, x_i, x_mid, x_ip1, xdot_i, xdot_mid, xdot_ip1)});
+        const Slice i(0, m_numGridPoints - 2, 2);
+        const Slice mid(1, m_numGridPoints - 1, 2);
+        const Slice ip1(2, m_numGridPoints, 2);
+        defects = evalOnMeshIntervals(intervalDefects,
+                {m_times(Slice(), ip1) - m_times(Slice(), i), x(Slice(), i),
+                        x(Slice(), mid), x(Slice(), ip1), xdot(Slice(), i),
+                        xdot(Slice(), mid), xdot(Slice(), ip1)});
+        return;
+    }
+
     int time_i;
     int time_mid;
     int time_ip1;
@@ -75,13 +118,8 @@ void HermiteSimpson::calcDefectsImpl(const casadi::MX& x,
         const auto xdot_mid = xdot(Slice(), time_mid);
         const auto xdot_ip1 = xdot(Slice(), time_ip1);
 
-        // Hermite interpolant defects.
-        defects(Slice(0, NS), imesh) =
-                x_mid - 0.5 * (x_ip1 + x_i) - (h / 8.0) * (xdot_i - xdot_ip1);
-
-        // Simpson integration defects.
-        defects(Slice(NS, 2 * NS), imesh) =
-                x_ip1 - x_i - (h / 6.0) * (xdot_ip1 + 4.0 * xdot_mid + xdot_i);
+        defects(Slice(), imesh) = calcIntervalDefects(
+                h, x_i, x_mid, x_ip1, xdot_i, xdot_mid, xdot_ip1);
     }
 }
 
@@ -89,6 +127,21 @@ void HermiteSimpson::calcInterpolatingControlsImpl(
         const casadi::MX& controls, casadi::MX& interpControls) const {
     if (m_problem.getNumControls() &&
             m_solver.getInterpolateControlMidpoints()) {
+        if (m_solver.getSXTranscriptionFormulas()) {
+            const int NC = m_problem.getNumControls();
+            const SX c_i = SX::sym("c_i", NC);
+            const SX c_mid = SX::sym("c_mid", NC);
+            const SX c_ip1 = SX::sym("c_ip1", NC);
+            const casadi::Function intervalInterpControls(
+                    "hermite_simpson_interpolating_controls",
+                    {c_i, c_mid, c_ip1},
+                    {calcIntervalInterpolatingControls(c_i, c_mid, c_ip1)});
+            interpControls = evalOnMeshIntervals(intervalInterpControls,
+                    {controls(Slice(), Slice(0, m_numGridPoints - 2, 2)),
+                            controls(Slice(), Slice(1, m_numGridPoints - 1, 2)),
+                            controls(Slice(), Slice(2, m_numGridPoints, 2))});
+            return;
+        }
         int time_i;
         int time_mid;
         int time_ip1;
@@ -99,7 +152,8 @@ void HermiteSimpson::calcInterpolatingControlsImpl(
             const auto c_i = controls(Slice(), time_i);
             const auto c_mid = controls(Slice(), time_mid);
             const auto c_ip1 = controls(Slice(), time_ip1);
-            interpControls(Slice(), imesh) = c_mid - 0.5 * (c_ip1 + c_i);
+            interpControls(Slice(), imesh) =
+                    calcIntervalInterpolatingControls(c_i, c_mid, c_ip1);
         }
     }
 }
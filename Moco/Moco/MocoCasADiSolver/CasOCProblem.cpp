@@ -27,11 +27,66 @@
 #include "../MocoTrajectory.h"
 #include "MocoCasOCProblem.h"
 
+using casadi::SX;
 using OpenSim::Exception;
 using OpenSim::format;
 
 namespace CasOC {
 
+namespace {
+/// The symbolic variables at a single time, used to evaluate the terms of an
+/// AlgebraicFunction.
+struct AlgebraicPoint {
+    SX time;
+    SX states;
+    SX controls;
+};
+
+/// Get the variable that the term's coefficient multiplies.
+SX getAlgebraicVariable(const AlgebraicTerm& term, const AlgebraicPoint& point,
+        const SX& integral) {
+    using Variable = AlgebraicTerm::Variable;
+    switch (term.variable) {
+    case Variable::State:
+        OPENSIM_THROW_IF(term.index < 0 || term.index >= point.states.numel(),
+                Exception, format("Invalid state index %i.", term.index));
+        return point.states(term.index);
+    case Variable::Control:
+        OPENSIM_THROW_IF(
+                term.index < 0 || term.index >= point.controls.numel(),
+                Exception, format("Invalid control index %i.", term.index));
+        return point.controls(term.index);
+    case Variable::Time: return point.time;
+    case Variable::Integral:
+        OPENSIM_THROW_IF(integral.is_empty(), Exception,
+                "The integral is only available to endpoint functions.");
+        return integral;
+    case Variable::Constant: return SX::ones(1, 1);
+    default: OPENSIM_THROW(Exception, "Internal error.");
+    }
+}
+
+SX evalAlgebraicOutputs(const AlgebraicFunction& algebraic,
+        const AlgebraicPoint& initial, const AlgebraicPoint& final,
+        const SX& integral, int numOutputs) {
+    OPENSIM_THROW_IF((int)algebraic.outputs.size() != numOutputs, Exception,
+            format("Expected %i outputs but the algebraic function has %i.",
+                    numOutputs, (int)algebraic.outputs.size()));
+    std::vector<SX> outputs;
+    for (const auto& terms : algebraic.outputs) {
+        SX output = SX::zeros(1, 1);
+        for (const auto& term : terms) {
+            output += term.coefficient *
+                      getAlgebraicVariable(
+                              term, term.final ? final : initial, integral);
+        }
+        if (algebraic.square_outputs) output = sq(output);
+        outputs.push_back(algebraic.scale * output);
+    }
+    return SX::vertcat(outputs);
+}
+} // anonymous namespace
+
 Iterate Iterate::resample(const casadi::DM& newTimes) const {
     auto mocoIt = OpenSim::convertToMocoTrajectory(*this);
     auto simtkNewTimes = OpenSim::convertToSimTKVector(newTimes);
@@ -48,4 +103,81 @@ Problem::createKinematicConstraintEquationNamesImpl() const {
     return names;
 }
 
+void Problem::constructAlgebraicFunctions(
+        const std::string& name, EndpointInfo& info) const {
+    const auto& algebraic = *info.algebraic;
+    AlgebraicPoint initial{SX::sym("initial_time"),
+            SX::sym("initial_states", getNumStates()),
+            SX::sym("initial_controls", getNumControls())};
+    AlgebraicPoint final{SX::sym("final_time"),
+            SX::sym("final_states", getNumStates()),
+            SX::sym("final_controls", getNumControls())};
+    SX initialMultipliers = SX::sym("initial_multipliers", getNumMultipliers());
+    SX initialDerivatives = SX::sym("initial_derivatives", getNumDerivatives());
+    SX finalMultipliers = SX::sym("final_multipliers", getNumMultipliers());
+    SX finalDerivatives = SX::sym("final_derivatives", getNumDerivatives());
+    SX parameters = SX::sym("parameters", getNumParameters());
+    SX integral = SX::sym("integral");
+
+    if (info.integrand_function) {
+        // The integrand has the same inputs as the Integrand callback.
+        const auto& point = initial;
+        const int exponent = algebraic.integrand_exponent;
+        SX integrand = SX::zeros(1, 1);
+        for (const auto& term : algebraic.integrand) {
+            const SX value = getAlgebraicVariable(term, point, SX());
+            // As in MocoControlGoal, avoid pow() for the common exponent.
+            if (exponent == 2) {
+                integrand += term.coefficient * sq(value);
+            } else {
+                integrand += term.coefficient *
+                             pow(fabs(value), SX(static_cast<double>(exponent)));
+            }
+        }
+        info.algebraic_integrand_function = casadi::Function(
+                name + "_integrand",
+                {point.time, point.states, point.controls, initialMultipliers,
+                        initialDerivatives, parameters},
+                {integrand},
+                {"time", "states", "controls", "multipliers", "derivatives",
+                        "parameters"},
+                {"integrand"});
+    }
+
+    const SX outputs = evalAlgebraicOutputs(
+            algebraic, initial, final, integral, info.num_outputs);
+    info.algebraic_endpoint_function = casadi::Function(name + "_endpoint",
+            {initial.time, initial.states, initial.controls,
+                    initialMultipliers, initialDerivatives, final.time,
+                    final.states, final.controls, finalMultipliers,
+                    finalDerivatives, parameters, integral},
+            {outputs},
+            {"initial_time", "initial_states", "initial_controls",
+                    "initial_multipliers", "initial_derivatives",
+                    "final_time", "final_states", "final_controls",
+                    "final_multipliers", "final_derivatives", "parameters",
+                    "integral"},
+            {"value"});
+}
+
+casadi::Function Problem::createAlgebraicPathConstraint(const std::string& name,
+        const AlgebraicFunction& algebraic, int numEquations) const {
+    AlgebraicPoint point{SX::sym("time"), SX::sym("states", getNumStates()),
+            SX::sym("controls", getNumControls())};
+    SX multipliers = SX::sym("multipliers", getNumMultipliers());
+    SX derivatives = SX::sym("derivatives", getNumDerivatives());
+    SX parameters = SX::sym("parameters", getNumParameters());
+    // Path constraints are evaluated at a single time, so the initial and
+    // final points are the same.
+    const SX outputs =
+            evalAlgebraicOutputs(algebraic, point, point, SX(), numEquations);
+    return casadi::Function(name,
+            {point.time, point.states, point.controls, multipliers,
+                    derivatives, parameters},
+            {outputs},
+            {"time", "states", "controls", "multipliers", "derivatives",
+                    "parameters"},
+            {"path_constraint_" + name});
+}
+
 } // namespace CasOC
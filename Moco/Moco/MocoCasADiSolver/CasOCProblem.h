@@ -80,31 +80,80 @@ struct ParameterInfo {
     Bounds bounds;
 };
 
+/// A term of an AlgebraicFunction: a coefficient multiplying one variable.
+/// The index is the index of the state or control in the CasOC problem.
+struct AlgebraicTerm {
+    enum class Variable { State, Control, Time, Integral, Constant };
+    AlgebraicTerm(Variable variable, int index, double coefficient, bool final)
+            : variable(variable), index(index), coefficient(coefficient),
+              final(final) {}
+    Variable variable;
+    int index;
+    double coefficient;
+    /// Use the value at the final time instead of at the initial time (only
+    /// for endpoint functions).
+    bool final;
+};
+
+/// Describes a cost, endpoint constraint, or path constraint that depends on
+/// the states, controls, and time only through simple algebraic expressions.
+/// The problem creates such functions from CasADi symbolic expressions instead
+/// of callbacks, so CasADi can evaluate them without the model and compute
+/// their exact derivatives.
+/// The integrand is sum_i coefficient_i * |variable_i|^integrand_exponent.
+/// Each output is the sum of its terms, squared if square_outputs is true,
+/// and multiplied by scale.
+struct AlgebraicFunction {
+    std::vector<AlgebraicTerm> integrand;
+    int integrand_exponent = 2;
+    std::vector<std::vector<AlgebraicTerm>> outputs;
+    bool square_outputs = false;
+    double scale = 1;
+};
+
 struct EndpointInfo {
     EndpointInfo(std::string name, int num_outputs,
-            std::unique_ptr<Integrand> ifunc, std::unique_ptr<Endpoint> efunc)
+            std::unique_ptr<Integrand> ifunc, std::unique_ptr<Endpoint> efunc,
+            std::unique_ptr<AlgebraicFunction> algebraic)
             : name(std::move(name)), num_outputs(num_outputs),
               integrand_function(std::move(ifunc)),
-              endpoint_function(std::move(efunc)) {}
+              endpoint_function(std::move(efunc)),
+              algebraic(std::move(algebraic)) {}
     std::string name;
     int num_outputs;
     std::unique_ptr<Integrand> integrand_function;
     std::unique_ptr<Endpoint> endpoint_function;
+    /// If provided, the functions below are used in place of the callbacks.
+    std::unique_ptr<AlgebraicFunction> algebraic;
+    casadi::Function algebraic_integrand_function;
+    casadi::Function algebraic_endpoint_function;
+    /// The function to use for the integrand, if integrand_function is not
+    /// null.
+    const casadi::Function& getIntegrandFunction() const {
+        if (algebraic) return algebraic_integrand_function;
+        return *integrand_function;
+    }
+    const casadi::Function& getEndpointFunction() const {
+        if (algebraic) return algebraic_endpoint_function;
+        return *endpoint_function;
+    }
 };
 
 struct CostInfo : EndpointInfo {
     CostInfo(std::string name, int num_outputs,
-            std::unique_ptr<Integrand> ifunc, std::unique_ptr<Endpoint> efunc)
+            std::unique_ptr<Integrand> ifunc, std::unique_ptr<Endpoint> efunc,
+            std::unique_ptr<AlgebraicFunction> algebraic)
             : EndpointInfo(std::move(name), num_outputs, std::move(ifunc),
-                      std::move(efunc)) {}
+                      std::move(efunc), std::move(algebraic)) {}
 };
 
 struct EndpointConstraintInfo : EndpointInfo {
     EndpointConstraintInfo(std::string name, int num_outputs,
             std::unique_ptr<Integrand> ifunc, std::unique_ptr<Endpoint> efunc,
+            std::unique_ptr<AlgebraicFunction> algebraic,
             casadi::DM lowerBounds, casadi::DM upperBounds)
             : EndpointInfo(std::move(name), num_outputs, std::move(ifunc),
-                      std::move(efunc)),
+                      std::move(efunc), std::move(algebraic)),
               lowerBounds(std::move(lowerBounds)),
               upperBounds(std::move(upperBounds)) {}
     // The number of rows in these bounds must be num_outputs.
@@ -120,6 +169,13 @@ struct PathConstraintInfo {
     casadi::DM lowerBounds;
     casadi::DM upperBounds;
     std::unique_ptr<PathConstraint> function;
+    /// If provided, algebraic_function is used in place of function.
+    std::unique_ptr<AlgebraicFunction> algebraic;
+    casadi::Function algebraic_function;
+    const casadi::Function& getFunction() const {
+        if (algebraic) return algebraic_function;
+        return *function;
+    }
 };
 
 class Solver;
@@ -129,39 +185,42 @@ class Problem {
 public:
     virtual ~Problem() = default;
 
+    /// The inputs and outputs below are views into buffers provided by CasADi
+    /// (see Function::eval_buffer()); the buffers are valid only for the
+    /// duration of the call.
     struct ContinuousInput {
         const double& time;
-        const casadi::DM& states;
-        const casadi::DM& controls;
-        const casadi::DM& multipliers;
-        const casadi::DM& derivatives;
-        const casadi::DM& parameters;
+        InputVector states;
+        InputVector controls;
+        InputVector multipliers;
+        InputVector derivatives;
+        InputVector parameters;
     };
     struct CostInput {
         const double& initial_time;
-        const casadi::DM& initial_states;
-        const casadi::DM& initial_controls;
-        const casadi::DM& initial_multipliers;
-        const casadi::DM& initial_derivatives;
+        InputVector initial_states;
+        InputVector initial_controls;
+        InputVector initial_multipliers;
+        InputVector initial_derivatives;
         const double& final_time;
-        const casadi::DM& final_states;
-        const casadi::DM& final_controls;
-        const casadi::DM& final_multipliers;
-        const casadi::DM& final_derivatives;
-        const casadi::DM& parameters;
+        InputVector final_states;
+        InputVector final_controls;
+        InputVector final_multipliers;
+        InputVector final_derivatives;
+        InputVector parameters;
         const double& integral;
     };
     struct MultibodySystemExplicitOutput {
-        casadi::DM& multibody_derivatives;
-        casadi::DM& auxiliary_derivatives;
-        casadi::DM& auxiliary_residuals;
-        casadi::DM& kinematic_constraint_errors;
+        OutputVector multibody_derivatives;
+        OutputVector auxiliary_derivatives;
+        OutputVector auxiliary_residuals;
+        OutputVector kinematic_constraint_errors;
     };
     struct MultibodySystemImplicitOutput {
-        casadi::DM& multibody_residuals;
-        casadi::DM& auxiliary_derivatives;
-        casadi::DM& auxiliary_residuals;
-        casadi::DM& kinematic_constraint_errors;
+        OutputVector multibody_residuals;
+        OutputVector auxiliary_derivatives;
+        OutputVector auxiliary_residuals;
+        OutputVector kinematic_constraint_errors;
     };
 
 protected:
@@ -245,7 +304,10 @@ protected:
         m_paramInfos.push_back({std::move(name), std::move(bounds)});
     }
     /// Add a cost term to the problem.
-    void addCost(std::string name, int numIntegrals, int numOutputs) {
+    /// If `algebraic` is provided, the cost is computed from it rather than
+    /// from calcCostIntegrand() and calcCost().
+    void addCost(std::string name, int numIntegrals, int numOutputs,
+            std::unique_ptr<AlgebraicFunction> algebraic = nullptr) {
         OPENSIM_THROW_IF(numIntegrals < 0 || numIntegrals > 1,
                 OpenSim::Exception, "numIntegrals must be 0 or 1.");
         std::unique_ptr<CostIntegrand> integrand_function;
@@ -253,12 +315,16 @@ protected:
             integrand_function = OpenSim::make_unique<CostIntegrand>();
         }
         m_costInfos.emplace_back(std::move(name), numOutputs,
-                std::move(integrand_function),
-                OpenSim::make_unique<Cost>());
+                std::move(integrand_function), OpenSim::make_unique<Cost>(),
+                std::move(algebraic));
     }
     /// Add an endpoint constraint to the problem.
-    void addEndpointConstraint(
-            std::string name, int numIntegrals, std::vector<Bounds> bounds) {
+    /// If `algebraic` is provided, the constraint is computed from it rather
+    /// than from calcEndpointConstraintIntegrand() and
+    /// calcEndpointConstraint().
+    void addEndpointConstraint(std::string name, int numIntegrals,
+            std::vector<Bounds> bounds,
+            std::unique_ptr<AlgebraicFunction> algebraic = nullptr) {
         OPENSIM_THROW_IF(numIntegrals < 0 || numIntegrals > 1,
                 OpenSim::Exception, "numIntegrals must be 0 or 1.");
         std::unique_ptr<EndpointConstraintIntegrand> integrand_function;
@@ -274,13 +340,16 @@ protected:
         }
         m_endpointConstraintInfos.emplace_back(std::move(name),
                 (int)bounds.size(), std::move(integrand_function),
-                OpenSim::make_unique<EndpointConstraint>(), std::move(lower),
-                std::move(upper));
+                OpenSim::make_unique<EndpointConstraint>(),
+                std::move(algebraic), std::move(lower), std::move(upper));
     }
     /// The size of bounds must match the number of outputs in the function.
     /// Use variadic template arguments to pass arguments to the constructor of
     /// FunctionType.
-    void addPathConstraint(std::string name, std::vector<Bounds> bounds) {
+    /// If `algebraic` is provided, the constraint is computed from it rather
+    /// than from calcPathConstraint().
+    void addPathConstraint(std::string name, std::vector<Bounds> bounds,
+            std::unique_ptr<AlgebraicFunction> algebraic = nullptr) {
         casadi::DM lower(bounds.size(), 1);
         casadi::DM upper(bounds.size(), 1);
         for (int ibound = 0; ibound < (int)bounds.size(); ++ibound) {
@@ -288,7 +357,8 @@ protected:
             upper(ibound, 0) = bounds[ibound].upper;
         }
         m_pathInfos.push_back({std::move(name), std::move(lower),
-                std::move(upper), OpenSim::make_unique<PathConstraint>()});
+                std::move(upper), OpenSim::make_unique<PathConstraint>(),
+                std::move(algebraic)});
     }
     void setDynamicsMode(std::string dynamicsMode) {
         OPENSIM_THROW_IF(
@@ -315,25 +385,33 @@ public:
     virtual void calcMultibodySystemImplicit(const ContinuousInput& input,
             bool calcKCErrors, MultibodySystemImplicitOutput& output) const = 0;
     virtual void calcVelocityCorrection(const double& time,
-            const casadi::DM& multibody_states, const casadi::DM& slacks,
-            const casadi::DM& parameters,
-            casadi::DM& velocity_correction) const = 0;
+            const InputVector& multibody_states, const InputVector& slacks,
+            const InputVector& parameters,
+            OutputVector velocity_correction) const = 0;
 
     virtual void calcCostIntegrand(int /*costIndex*/,
             const ContinuousInput& /*input*/, double& /*integrand*/) const {}
     virtual void calcCost(int /*costIndex*/, const CostInput& /*input*/,
-            casadi::DM& /*cost*/) const {}
+            OutputVector /*cost*/) const {}
     virtual void calcEndpointConstraintIntegrand(int /*index*/,
             const ContinuousInput& /*input*/, double& /*integrand*/) const {}
     virtual void calcEndpointConstraint(int /*index*/,
-            const CostInput& /*input*/, casadi::DM& /*values*/) const {}
+            const CostInput& /*input*/, OutputVector /*values*/) const {}
     virtual void calcPathConstraint(int /*constraintIndex*/,
             const ContinuousInput& /*input*/,
-            casadi::DM& /*path_constraint*/) const {}
+            OutputVector /*path_constraint*/) const {}
 
     virtual std::vector<std::string>
     createKinematicConstraintEquationNamesImpl() const;
 
+    /// Functions invoke beginRepeatedEvaluations() before evaluating
+    /// themselves at several nearby points in succession on the current thread
+    /// (e.g., to compute finite differences), and endRepeatedEvaluations()
+    /// afterwards. In between, implementations may use the same resources
+    /// (e.g., a model and state) for every evaluation.
+    virtual void beginRepeatedEvaluations() const {}
+    virtual void endRepeatedEvaluations() const {}
+
     void intermediateCallback() const { intermediateCallbackImpl(); }
     void intermediateCallbackWithIterate(const CasOC::Iterate& it) const {
         intermediateCallbackWithIterateImpl(it);
@@ -388,7 +466,13 @@ public:
 
         {
             int index = 0;
-            for (const auto& costInfo : mutThis->m_costInfos) {
+            for (auto& costInfo : mutThis->m_costInfos) {
+                if (costInfo.algebraic) {
+                    constructAlgebraicFunctions("cost_" + costInfo.name,
+                            costInfo);
+                    ++index;
+                    continue;
+                }
                 costInfo.endpoint_function->constructFunction(this,
                         "cost_" + costInfo.name + "_endpoint", index,
                         costInfo.num_outputs, finiteDiffScheme,
@@ -403,7 +487,13 @@ public:
         }
         {
             int index = 0;
-            for (const auto& info : mutThis->m_endpointConstraintInfos) {
+            for (auto& info : mutThis->m_endpointConstraintInfos) {
+                if (info.algebraic) {
+                    constructAlgebraicFunctions(
+                            "endpoint_constraint_" + info.name, info);
+                    ++index;
+                    continue;
+                }
                 info.endpoint_function->constructFunction(this,
                         "endpoint_constraint_" + info.name + "_endpoint", index,
                         info.num_outputs, finiteDiffScheme,
@@ -418,7 +508,14 @@ public:
         }
         {
             int index = 0;
-            for (const auto& pathInfo : mutThis->m_pathInfos) {
+            for (auto& pathInfo : mutThis->m_pathInfos) {
+                if (pathInfo.algebraic) {
+                    pathInfo.algebraic_function = createAlgebraicPathConstraint(
+                            "path_constraint_" + pathInfo.name,
+                            *pathInfo.algebraic, pathInfo.size());
+                    ++index;
+                    continue;
+                }
                 pathInfo.function->constructFunction(this,
                         "path_constraint_" + pathInfo.name, index,
                         (int)pathInfo.lowerBounds.size1(), finiteDiffScheme,
@@ -599,6 +696,12 @@ public:
     /// @}
 
 private:
+    /// Create the integrand and endpoint functions for a cost or endpoint
+    /// constraint from info.algebraic.
+    void constructAlgebraicFunctions(
+            const std::string& name, EndpointInfo& info) const;
+    casadi::Function createAlgebraicPathConstraint(const std::string& name,
+            const AlgebraicFunction& algebraic, int numEquations) const;
     /// Clip endpoint to be as strict as b.
     void clipEndpointBounds(const Bounds& b, Bounds& endpoint) {
         endpoint.lower = std::max(b.lower, endpoint.lower);
@@ -21,6 +21,14 @@
 #include "CasOCTranscription.h"
 #include "CasOCTrapezoidal.h"
 
+#include <cstdlib>
+#include <limits>
+#include <thread>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 using OpenSim::Exception;
 using OpenSim::format;
 
@@ -61,6 +69,33 @@ void Solver::setSparsityDetectionRandomCount(int count) {
     m_sparsity_detection_random_count = count;
 }
 
+casadi::Function Solver::compileFunction(
+        const casadi::Function& function) const {
+    if (!m_compileFunctions || !function.is_a("SXFunction")) return function;
+    auto it = m_compiledFunctions.find(function.get());
+    if (it == m_compiledFunctions.end()) {
+        std::string cacheDir = m_compiledFunctionsCacheDir;
+        if (cacheDir.empty()) {
+            // Each user has their own cache (see CompiledFunction).
+            const char* tmpdir = std::getenv("TMPDIR");
+            cacheDir = std::string(tmpdir ? tmpdir : "/tmp") +
+                       "/opensim-moco-compiled-functions";
+#ifndef _WIN32
+            cacheDir += "-" + std::to_string(getuid());
+#endif
+        }
+        const char* compiler = std::getenv("CC");
+        auto compiled = OpenSim::make_unique<CompiledFunction>();
+        compiled->constructFunction(
+                function, cacheDir, compiler ? compiler : "cc");
+        it = m_compiledFunctions
+                     .emplace(function.get(),
+                             std::make_pair(function, std::move(compiled)))
+                     .first;
+    }
+    return *it->second.second;
+}
+
 void Solver::setParallelism(std::string parallelism, int numThreads) {
     m_parallelism = parallelism;
     OPENSIM_THROW_IF(numThreads < 1, OpenSim::Exception,
@@ -90,7 +125,115 @@ Solution Solver::solve(const Iterate& guess) const {
     m_problem.initialize(m_finite_difference_scheme,
             std::const_pointer_cast<const std::vector<VariablesDM>>(
                     pointsForSparsityDetection));
-    return transcription->solve(guess);
+    if (m_autoParallelism && m_numThreads > 1) {
+        const int numThreads = calcAutoNumThreads(guess);
+        transcription->setParallelism(
+                numThreads == 1 ? "serial" : m_parallelism, numThreads);
+    }
+    const auto parallelism = transcription->getParallelism();
+    Solution solution = transcription->solve(guess);
+    solution.stats["parallelism"] = parallelism.first;
+    solution.stats["num_threads"] = parallelism.second;
+    return solution;
+}
+
+int Solver::calcAutoNumThreads(const Iterate& guess) const {
+    // The functions evaluated at each grid point. Endpoint functions and the
+    // velocity correction are evaluated at few points and are ignored.
+    std::vector<const casadi::Function*> functions;
+    if (m_problem.isDynamicsModeImplicit()) {
+        functions.push_back(&m_problem.getImplicitMultibodySystem());
+    } else {
+        functions.push_back(&m_problem.getMultibodySystem());
+    }
+    for (const auto& info : m_problem.getCostInfos()) {
+        if (info.integrand_function) {
+            functions.push_back(&info.getIntegrandFunction());
+        }
+    }
+    for (const auto& info : m_problem.getPathConstraintInfos()) {
+        functions.push_back(&info.getFunction());
+    }
+
+    // Inputs for a single point: time, states, controls, multipliers,
+    // derivatives, and parameters, taken from the first point of the guess.
+    const std::vector<Var> vars{
+            states, controls, multipliers, derivatives, parameters};
+    casadi::DMVector in{guess.times.numel() ? guess.times(0)
+                                            : casadi::DM::zeros(1, 1)};
+    for (const auto& var : vars) {
+        const auto it = guess.variables.find(var);
+        if (it != guess.variables.end() && it->second.columns()) {
+            in.push_back(it->second(casadi::Slice(), 0));
+        } else {
+            in.push_back(casadi::DM());
+        }
+    }
+    const auto createInput = [&](const casadi::Function& function) {
+        casadi::DMVector funcIn(function.n_in());
+        for (int i = 0; i < (int)funcIn.size(); ++i) {
+            const auto& sparsity = function.sparsity_in(i);
+            if (i < (int)in.size() && in[i].size() == sparsity.size()) {
+                funcIn[i] = in[i];
+            } else {
+                funcIn[i] = casadi::DM::zeros(sparsity);
+            }
+        }
+        return funcIn;
+    };
+
+    // Time the functions at one point, using the fastest of a few trials to
+    // reduce noise. The first evaluation warms up caches (e.g., the model's
+    // state) and is not timed.
+    const int numTrials = 3;
+    double callTime = std::numeric_limits<double>::infinity();
+    try {
+        std::vector<casadi::DMVector> inputs;
+        for (const auto* function : functions) {
+            inputs.push_back(createInput(*function));
+            (*function)(inputs.back());
+        }
+        for (int itrial = 0; itrial < numTrials; ++itrial) {
+            const OpenSim::Stopwatch stopwatch;
+            for (int ifunc = 0; ifunc < (int)functions.size(); ++ifunc) {
+                (*functions[ifunc])(inputs[ifunc]);
+            }
+            callTime = std::min(callTime, stopwatch.getElapsedTime());
+        }
+    } catch (const std::exception&) {
+        return 1;
+    }
+
+    // CasADi's "thread" map creates and joins its threads every time the
+    // map is evaluated.
+    double spawnTime = std::numeric_limits<double>::infinity();
+    for (int itrial = 0; itrial < numTrials; ++itrial) {
+        const OpenSim::Stopwatch stopwatch;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < m_numThreads; ++i) threads.emplace_back([] {});
+        for (auto& thread : threads) thread.join();
+        spawnTime = std::min(spawnTime, stopwatch.getElapsedTime());
+    }
+    spawnTime /= m_numThreads;
+
+    // Predict the time to evaluate the functions across the grid with each
+    // number of threads. The grid points are divided evenly among threads.
+    const int numMeshPoints = (int)m_mesh.size();
+    const int numPoints = m_transcriptionScheme == "hermite-simpson"
+                                  ? 2 * numMeshPoints - 1
+                                  : numMeshPoints;
+    int bestNumThreads = 1;
+    double bestTime = numPoints * callTime;
+    for (int numThreads = 2; numThreads <= m_numThreads; ++numThreads) {
+        const int pointsPerThread = (numPoints + numThreads - 1) / numThreads;
+        const double time =
+                pointsPerThread * callTime + numThreads * spawnTime;
+        if (time < bestTime) {
+            bestTime = time;
+            bestNumThreads = numThreads;
+        }
+    }
+    return bestNumThreads;
 }
 
 } // namespace CasOC
@@ -18,7 +18,9 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 
+#include "CasOCCompiledFunction.h"
 #include "CasOCProblem.h"
+#include <map>
 
 namespace OpenSim {
 class MocoCasADiSolver;
@@ -108,6 +110,65 @@ public:
     bool getInterpolateControlMidpoints() const {
         return m_interpolateControlMidpoints;
     }
+    /// If controls are interpolated at mesh interval midpoints, remove the
+    /// midpoint controls from the NLP variables and substitute the
+    /// interpolation expressions for them, instead of adding interpolation
+    /// constraints.
+    void setEliminateInterpolatedControls(bool tf) {
+        m_eliminateInterpolatedControls = tf;
+    }
+    bool getEliminateInterpolatedControls() const {
+        return m_eliminateInterpolatedControls;
+    }
+
+    /// Scale the NLP variables so that they have magnitudes near 1, and scale
+    /// the defect and control interpolation constraints by the scales of the
+    /// corresponding states and controls. The scale of a variable is the
+    /// range of its bounds if the bounds are finite; otherwise, it is the
+    /// largest magnitude of the variable in the initial guess (or 1 if that
+    /// magnitude is 0). The solution is unscaled.
+    void setScaleVariablesAndConstraints(bool tf) {
+        m_scaleVariablesAndConstraints = tf;
+    }
+    bool getScaleVariablesAndConstraints() const {
+        return m_scaleVariablesAndConstraints;
+    }
+    /// Override the automatically-computed scales for the variables with the
+    /// given names (e.g., state names, or "final_time").
+    void setVariableScales(std::map<std::string, double> scales) {
+        m_variableScales = std::move(scales);
+    }
+    const std::map<std::string, double>& getVariableScales() const {
+        return m_variableScales;
+    }
+
+    /// Whether to build the algebraic parts of the transcription (defects and
+    /// control interpolation constraints) as a single SX function of one
+    /// mesh interval that is mapped across all mesh intervals, rather than as
+    /// MX operations on each mesh interval. This yields a much smaller MX
+    /// graph for the NLP.
+    void setSXTranscriptionFormulas(bool tf) {
+        m_sxTranscriptionFormulas = tf;
+    }
+    bool getSXTranscriptionFormulas() const {
+        return m_sxTranscriptionFormulas;
+    }
+
+    /// Generate C code for the symbolic (SX) functions in the problem and
+    /// transcription (e.g., algebraic goals and, with
+    /// setSXTranscriptionFormulas(), the defects), compile the code with the
+    /// system's C compiler, and evaluate the compiled code instead of
+    /// CasADi's virtual machine. Callbacks (CasOC::Function) are unaffected.
+    /// Compiled libraries are cached in `cacheDir` (see CompiledFunction).
+    void setCompileFunctions(bool tf, std::string cacheDir = "") {
+        m_compileFunctions = tf;
+        m_compiledFunctionsCacheDir = std::move(cacheDir);
+    }
+    bool getCompileFunctions() const { return m_compileFunctions; }
+    /// If compiling functions is enabled and the function is an SX function,
+    /// return a compiled version of the function; otherwise, return the
+    /// function.
+    casadi::Function compileFunction(const casadi::Function& function) const;
 
     void setOptimSolver(std::string optimSolver) {
         m_optimSolver = std::move(optimSolver);
@@ -129,6 +190,27 @@ public:
     }
 
     int getCallbackInterval() const { return m_callbackInterval; }
+
+    /// Write a Checkpoint of the optimizer's current iterate to `filepath`
+    /// every `interval` iterations (0, the default, for no checkpoints). The
+    /// `problemHash` identifies the problem, and must be the same to resume
+    /// from the checkpoint.
+    void setCheckpoint(
+            std::string filepath, int interval, std::string problemHash) {
+        m_checkpointFilepath = std::move(filepath);
+        m_checkpointInterval = interval;
+        m_problemHash = std::move(problemHash);
+    }
+    const std::string& getCheckpointFilepath() const {
+        return m_checkpointFilepath;
+    }
+    int getCheckpointInterval() const { return m_checkpointInterval; }
+    const std::string& getProblemHash() const { return m_problemHash; }
+    /// If the checkpoint file (see setCheckpoint()) exists, start the
+    /// optimizer from the checkpoint's iterate and multipliers (warm start)
+    /// instead of from the guess.
+    void setResumeFromCheckpoint(bool tf) { m_resumeFromCheckpoint = tf; }
+    bool getResumeFromCheckpoint() const { return m_resumeFromCheckpoint; }
     /// "none" to use block sparsity (treat all CasOC::Function%s as dense;
     /// default), "initial-guess", or "random".
     void setSparsityDetection(const std::string& setting);
@@ -153,6 +235,16 @@ public:
     std::pair<std::string, int> getParallelism() const {
         return std::make_pair(m_parallelism, m_numThreads);
     }
+    /// If true, solve() times a few evaluations of the functions that are
+    /// evaluated at every grid point (the multibody system, cost integrands,
+    /// and path constraints) at the guess, along with the cost of creating
+    /// threads, and uses the number of threads (at most the number given to
+    /// setParallelism()) that minimizes the predicted time to evaluate these
+    /// functions across the grid. If a single thread is best, the functions
+    /// are evaluated serially. The choice is recorded in the solution's stats
+    /// as "parallelism" and "num_threads".
+    void setAutoParallelism(bool tf) { m_autoParallelism = tf; }
+    bool getAutoParallelism() const { return m_autoParallelism; }
 
     void setPluginOptions(casadi::Dict opts) {
         m_pluginOptions = std::move(opts);
@@ -173,6 +265,9 @@ public:
 
 private:
     std::unique_ptr<Transcription> createTranscription() const;
+    /// Choose the number of threads as described in setAutoParallelism().
+    /// Returns 1 if the functions could not be evaluated at the guess.
+    int calcAutoNumThreads(const Iterate& guess) const;
 
     const Problem& m_problem;
     std::vector<double> m_mesh;
@@ -184,15 +279,31 @@ private:
     bool m_minimizeImplicitAuxiliaryDerivatives = false;
     double m_implicitAuxiliaryDerivativesWeight = 1.0;
     bool m_interpolateControlMidpoints = true;
+    bool m_eliminateInterpolatedControls = false;
+    bool m_scaleVariablesAndConstraints = false;
+    std::map<std::string, double> m_variableScales;
+    bool m_sxTranscriptionFormulas = false;
+    bool m_compileFunctions = false;
+    std::string m_compiledFunctionsCacheDir;
+    // The compiled functions must exist as long as the NLP that uses them.
+    // The key is the original function's internal object.
+    mutable std::map<const void*,
+            std::pair<casadi::Function, std::unique_ptr<CompiledFunction>>>
+            m_compiledFunctions;
     Bounds m_implicitMultibodyAccelerationBounds;
     Bounds m_implicitAuxiliaryDerivativeBounds;
     std::string m_finite_difference_scheme = "central";
     std::string m_sparsity_detection = "none";
     std::string m_write_sparsity;
     int m_callbackInterval = 0;
+    std::string m_checkpointFilepath;
+    int m_checkpointInterval = 0;
+    std::string m_problemHash;
+    bool m_resumeFromCheckpoint = false;
     int m_sparsity_detection_random_count = 3;
     std::string m_parallelism = "serial";
     int m_numThreads = 1;
+    bool m_autoParallelism = false;
     casadi::Dict m_pluginOptions;
     casadi::Dict m_solverOptions;
     std::string m_optimSolver;
@@ -17,6 +17,9 @@
  * -------------------------------------------------------------------------- */
 #include "CasOCTranscription.h"
 
+#include "CasOCCheckpoint.h"
+#include <algorithm>
+
 using casadi::DM;
 using casadi::MX;
 using casadi::MXVector;
@@ -30,12 +33,17 @@ namespace CasOC {
 /// optimization.
 class NlpsolCallback : public casadi::Callback {
 public:
+    /// The `checkpoint` contains the information about the problem to write
+    /// with each checkpoint, and its iteration is the number of iterations
+    /// performed before this solve.
     NlpsolCallback(const Transcription& transcription, const Problem& problem,
             casadi_int numVariables, casadi_int numConstraints,
-            casadi_int outputInterval)
+            casadi_int outputInterval, Checkpoint checkpoint)
             : m_transcription(transcription), m_problem(problem),
               m_numVariables(numVariables), m_numConstraints(numConstraints),
-              m_callbackInterval(outputInterval) {
+              m_callbackInterval(outputInterval),
+              m_checkpoint(std::move(checkpoint)),
+              m_initialIteration(m_checkpoint.iteration) {
         construct("NlpsolCallback", {});
     }
     casadi_int get_n_in() override { return casadi::nlpsol_n_out(); }
@@ -66,17 +74,39 @@ public:
             iterate.iteration = evalCount;
             m_problem.intermediateCallbackWithIterate(iterate);
         }
+        const int checkpointInterval =
+                m_transcription.m_solver.getCheckpointInterval();
+        if (checkpointInterval > 0 && evalCount > 0 &&
+                evalCount % checkpointInterval == 0) {
+            writeCheckpoint(args);
+        }
         m_problem.intermediateCallback();
         ++evalCount;
         return {0};
     }
 
 private:
+    void writeCheckpoint(const std::vector<DM>& args) const {
+        const std::vector<std::string> names = casadi::nlpsol_out();
+        auto arg = [&](const std::string& name) -> const DM& {
+            const auto it = std::find(names.begin(), names.end(), name);
+            return args.at(it - names.begin());
+        };
+        m_checkpoint.iteration = m_initialIteration + evalCount;
+        m_checkpoint.objective = arg("f").scalar();
+        m_checkpoint.x = arg("x").nonzeros();
+        m_checkpoint.lam_x = arg("lam_x").nonzeros();
+        m_checkpoint.lam_g = arg("lam_g").nonzeros();
+        m_checkpoint.write(m_transcription.m_solver.getCheckpointFilepath());
+    }
+
     const Transcription& m_transcription;
     const Problem& m_problem;
     casadi_int m_numVariables;
     casadi_int m_numConstraints;
     casadi_int m_callbackInterval;
+    mutable Checkpoint m_checkpoint;
+    int m_initialIteration;
     mutable int evalCount = 0;
 };
 
@@ -94,7 +124,16 @@ void Transcription::createVariablesAndSetBounds(const casadi::DM& grid,
     m_numMeshIntervals = m_numMeshPoints - 1;
     m_numMeshInteriorPoints = m_numGridPoints - m_numMeshPoints;
     m_numDefectsPerMeshInterval = numDefectsPerMeshInterval;
+    m_grid = grid;
     m_pointsForInterpControls = pointsForInterpControls;
+    m_eliminateInterpolatedControls =
+            m_solver.getEliminateInterpolatedControls() &&
+            m_problem.getNumControls() && pointsForInterpControls.numel();
+    if (m_eliminateInterpolatedControls) {
+        createControlInterpolationMatrix();
+        // There are no interpolation constraints.
+        m_pointsForInterpControls = casadi::DM();
+    }
     m_numMultibodyResiduals = m_problem.isDynamicsModeImplicit()
                              ? m_problem.getNumMultibodyDynamicsEquations()
                              : 0;
@@ -105,7 +144,8 @@ void Transcription::createVariablesAndSetBounds(const casadi::DM& grid,
             m_numMultibodyResiduals * m_numGridPoints +
             m_numAuxiliaryResiduals * m_numGridPoints +
             m_problem.getNumKinematicConstraintEquations() * m_numMeshPoints +
-            m_problem.getNumControls() * (int)pointsForInterpControls.numel();
+            m_problem.getNumControls() *
+                    (int)m_pointsForInterpControls.numel();
     m_constraints.endpoint.resize(
             m_problem.getEndpointConstraintInfos().size());
     for (int iec = 0; iec < (int)m_constraints.endpoint.size(); ++iec) {
@@ -117,33 +157,29 @@ void Transcription::createVariablesAndSetBounds(const casadi::DM& grid,
         const auto& info = m_problem.getPathConstraintInfos()[ipc];
         m_numConstraints += info.size() * m_numMeshPoints;
     }
-    m_grid = grid;
 
     // Create variables.
     // -----------------
-    m_vars[initial_time] = MX::sym("initial_time");
-    m_vars[final_time] = MX::sym("final_time");
-    m_duration = m_vars[final_time] - m_vars[initial_time];
-    m_times = createTimes(m_vars[initial_time], m_vars[final_time]);
-    m_vars[states] =
+    m_decisionVars[initial_time] = MX::sym("initial_time");
+    m_decisionVars[final_time] = MX::sym("final_time");
+    m_decisionVars[states] =
             MX::sym("states", m_problem.getNumStates(), m_numGridPoints);
-    m_vars[controls] =
-            MX::sym("controls", m_problem.getNumControls(), m_numGridPoints);
-    m_vars[multipliers] = MX::sym(
+    m_decisionVars[controls] = MX::sym("controls", m_problem.getNumControls(),
+            m_eliminateInterpolatedControls ? m_controlPointIndices.numel()
+                                            : m_numGridPoints);
+    m_decisionVars[multipliers] = MX::sym(
             "multipliers", m_problem.getNumMultipliers(), m_numGridPoints);
-    m_vars[derivatives] = MX::sym(
+    m_decisionVars[derivatives] = MX::sym(
             "derivatives", m_problem.getNumDerivatives(), m_numGridPoints);
 
     // TODO: This assumes that slack variables are applied at all
     // collocation points on the mesh interval interior.
-    m_vars[slacks] = MX::sym(
+    m_decisionVars[slacks] = MX::sym(
             "slacks", m_problem.getNumSlacks(), m_numMeshInteriorPoints);
-    m_vars[parameters] = MX::sym("parameters", m_problem.getNumParameters(), 1);
+    m_decisionVars[parameters] =
+            MX::sym("parameters", m_problem.getNumParameters(), 1);
 
-    m_paramsTrajGrid = MX::repmat(m_vars[parameters], 1, m_numGridPoints);
-    m_paramsTrajMesh = MX::repmat(m_vars[parameters], 1, m_numMeshPoints);
-    m_paramsTrajMeshInterior =
-            MX::repmat(m_vars[parameters], 1, m_numMeshInteriorPoints);
+    createVariableExpressions();
 
     m_meshIndicesMap = createMeshIndices();
     std::vector<int> meshIndicesVector;
@@ -423,7 +459,7 @@ void Transcription::transcribe() {
     for (int ipc = 0; ipc < (int)m_constraints.path.size(); ++ipc) {
         const auto& info = m_problem.getPathConstraintInfos()[ipc];
         // TODO: Is it sufficiently general to apply these to mesh points?
-        const auto out = evalOnTrajectory(*info.function,
+        const auto out = evalOnTrajectory(info.getFunction(),
                 {states, controls, multipliers, derivatives}, m_meshIndices);
         m_constraints.path[ipc] = out.at(0);
         m_constraintsLowerBounds.path[ipc] =
@@ -442,7 +478,122 @@ void Transcription::transcribe() {
     m_constraintsLowerBounds.interp_controls = boundsOnInterpControls;
     m_constraintsUpperBounds.interp_controls = boundsOnInterpControls;
 
-    calcInterpolatingControls();
+    if (m_pointsForInterpControls.numel()) calcInterpolatingControls();
+}
+
+void Transcription::createVariableExpressions() {
+    for (const auto& kv : m_decisionVars) {
+        MX var = kv.second;
+        if (!m_variableScales.empty()) {
+            var = DM::repmat(m_variableScales.at(kv.first), 1, var.columns()) *
+                  var;
+        }
+        if (kv.first == controls && m_eliminateInterpolatedControls) {
+            var = MX::mtimes(var, m_controlInterpolationMatrix);
+        }
+        m_vars[kv.first] = var;
+    }
+    m_duration = m_vars[final_time] - m_vars[initial_time];
+    m_times = createTimes(m_vars[initial_time], m_vars[final_time]);
+    m_paramsTrajGrid = MX::repmat(m_vars[parameters], 1, m_numGridPoints);
+    m_paramsTrajMesh = MX::repmat(m_vars[parameters], 1, m_numMeshPoints);
+    m_paramsTrajMeshInterior =
+            MX::repmat(m_vars[parameters], 1, m_numMeshInteriorPoints);
+}
+
+void Transcription::setVariableScales(const VariablesDM& guess) {
+    // A variable's scale is the range of its bounds, if the bounds are
+    // finite; otherwise, the largest magnitude of the variable in the guess.
+    // The user can override the scale of any variable by name.
+    const Iterate names = m_problem.createIterate();
+    const std::map<Var, std::vector<std::string>> varNames{
+            {initial_time, {"initial_time"}}, {final_time, {"final_time"}},
+            {states, names.state_names}, {controls, names.control_names},
+            {multipliers, names.multiplier_names},
+            {derivatives, names.derivative_names},
+            {slacks, names.slack_names}, {parameters, names.parameter_names}};
+    const auto& userScales = m_solver.getVariableScales();
+    m_variableScales.clear();
+    for (const auto& kv : m_decisionVars) {
+        const Var var = kv.first;
+        const DM& lower = m_lowerBounds.at(var);
+        const DM& upper = m_upperBounds.at(var);
+        DM scales = DM::ones(kv.second.rows(), 1);
+        if (!kv.second.columns()) {
+            m_variableScales[var] = scales;
+            continue;
+        }
+        for (int irow = 0; irow < scales.rows(); ++irow) {
+            const auto& rowNames = varNames.at(var);
+            if (irow < (int)rowNames.size()) {
+                const auto it = userScales.find(rowNames[irow]);
+                if (it != userScales.end()) {
+                    OPENSIM_THROW_IF(it->second <= 0, OpenSim::Exception,
+                            OpenSim::format("Expected the scale for variable "
+                                            "'%s' to be positive, but got %g.",
+                                    it->first, it->second));
+                    scales(irow) = it->second;
+                    continue;
+                }
+            }
+            const double range =
+                    DM::mmax(upper(irow, Slice())).scalar() -
+                    DM::mmin(lower(irow, Slice())).scalar();
+            if (std::isfinite(range) && range > 0) {
+                scales(irow) = range;
+            } else if (guess.count(var) && guess.at(var).rows() > irow &&
+                       guess.at(var).columns()) {
+                const double magnitude =
+                        DM::norm_inf(guess.at(var)(irow, Slice())).scalar();
+                if (std::isfinite(magnitude) && magnitude > 0) {
+                    scales(irow) = magnitude;
+                }
+            }
+        }
+        m_variableScales[var] = scales;
+    }
+}
+
+void Transcription::createControlInterpolationMatrix() {
+    // Grid points that are not in pointsForInterpControls hold control
+    // variables. The control at each of the other points is linearly
+    // interpolated from the control variables at the neighboring points.
+    std::vector<bool> isInterpolated(m_numGridPoints, false);
+    std::vector<int> controlPointIndices;
+    int icon = 0;
+    for (int igrid = 0; igrid < m_numGridPoints; ++igrid) {
+        if (icon < m_pointsForInterpControls.numel() &&
+                m_grid(igrid).scalar() ==
+                        m_pointsForInterpControls(icon).scalar()) {
+            isInterpolated[igrid] = true;
+            ++icon;
+        } else {
+            controlPointIndices.push_back(igrid);
+        }
+    }
+    OPENSIM_THROW_IF(icon != m_pointsForInterpControls.numel() ||
+                             isInterpolated.front() || isInterpolated.back(),
+            OpenSim::Exception, "Internal error.");
+
+    const int numControlPoints = (int)controlPointIndices.size();
+    m_controlPointIndices = casadi::Matrix<casadi_int>(1, numControlPoints);
+    m_controlInterpolationMatrix = DM(numControlPoints, m_numGridPoints);
+    // The index (into controlPointIndices) of the latest control variable.
+    int ivar = -1;
+    for (int igrid = 0; igrid < m_numGridPoints; ++igrid) {
+        if (!isInterpolated[igrid]) {
+            ++ivar;
+            m_controlPointIndices(ivar) = igrid;
+            m_controlInterpolationMatrix(ivar, igrid) = 1;
+        } else {
+            const double t = m_grid(igrid).scalar();
+            const double tPrev = m_grid(controlPointIndices[ivar]).scalar();
+            const double tNext = m_grid(controlPointIndices[ivar + 1]).scalar();
+            const double fraction = (t - tPrev) / (tNext - tPrev);
+            m_controlInterpolationMatrix(ivar, igrid) = 1 - fraction;
+            m_controlInterpolationMatrix(ivar + 1, igrid) = fraction;
+        }
+    }
 }
 
 void Transcription::setObjectiveAndEndpointConstraints() {
@@ -486,7 +637,7 @@ void Transcription::setObjectiveAndEndpointConstraints() {
             // cost. We are *not* numerically evaluating the integral cost
             // integrand here--that occurs when the function by casadi::nlpsol()
             // is evaluated.
-            MX integrandTraj = evalOnTrajectory(*info.integrand_function,
+            MX integrandTraj = evalOnTrajectory(info.getIntegrandFunction(),
                     {states, controls, multipliers, derivatives}, m_gridIndices)
                     .at(0);
 
@@ -496,7 +647,7 @@ void Transcription::setObjectiveAndEndpointConstraints() {
         }
 
         MXVector costOut;
-        info.endpoint_function->call(
+        m_solver.compileFunction(info.getEndpointFunction()).call(
                 {m_vars[initial_time], m_vars[states](Slice(), 0),
                  m_vars[controls](Slice(), 0),
                  m_vars[multipliers](Slice(), 0),
@@ -557,7 +708,7 @@ void Transcription::setObjectiveAndEndpointConstraints() {
 
         MX integral;
         if (info.integrand_function) {
-            MX integrandTraj = evalOnTrajectory(*info.integrand_function,
+            MX integrandTraj = evalOnTrajectory(info.getIntegrandFunction(),
                     {states, controls, multipliers, derivatives}, m_gridIndices)
                                        .at(0);
 
@@ -567,7 +718,7 @@ void Transcription::setObjectiveAndEndpointConstraints() {
         }
 
         MXVector endpointOut;
-        info.endpoint_function->call(
+        m_solver.compileFunction(info.getEndpointFunction()).call(
                 {m_vars[initial_time], m_vars[states](Slice(), 0),
                         m_vars[controls](Slice(), 0),
                         m_vars[multipliers](Slice(), 0),
@@ -586,10 +737,6 @@ void Transcription::setObjectiveAndEndpointConstraints() {
 
 Solution Transcription::solve(const Iterate& guessOrig) {
 
-    // Define the NLP.
-    // ---------------
-    transcribe();
-
     // Resample the guess.
     // -------------------
     const auto guessTimes = createTimes(guessOrig.variables.at(initial_time),
@@ -627,24 +774,72 @@ Solution Transcription::solve(const Iterate& guessOrig) {
                         m_numMeshInteriorPoints, slacks.size2()));
     }
 
-    // Create the CasADi NLP function.
-    // -------------------------------
-    // Option handling is copied from casadi::OptiNode::solver().
-    casadi::Dict options = m_solver.getPluginOptions();
-    if (!options.empty()) {
-        options[m_solver.getOptimSolver()] = m_solver.getSolverOptions();
+    // Define the NLP.
+    // ---------------
+    if (m_solver.getScaleVariablesAndConstraints()) {
+        setVariableScales(guess.variables);
+        createVariableExpressions();
     }
+    transcribe();
 
-    auto x = flattenVariables(m_vars);
+    auto x = flattenVariables(m_decisionVars);
     casadi_int numVariables = x.numel();
 
     // The m_constraints symbolic vector holds all of the expressions for
     // the constraint functions.
     auto g = flattenConstraints(m_constraints);
     casadi_int numConstraints = g.numel();
+    const auto gScaled = flattenConstraints(scaleConstraints(m_constraints));
+
+    // Resume from a checkpoint.
+    // -------------------------
+    Checkpoint checkpoint;
+    checkpoint.problemHash = m_solver.getProblemHash();
+    checkpoint.mesh = m_solver.getMesh();
+    checkpoint.scales = createFlattenedVariableScales().nonzeros();
+    casadi::Dict solverOptions = m_solver.getSolverOptions();
+    Checkpoint resumed;
+    const bool resume =
+            m_solver.getResumeFromCheckpoint() &&
+            resumed.read(m_solver.getCheckpointFilepath());
+    if (resume) {
+        OPENSIM_THROW_IF(resumed.problemHash != checkpoint.problemHash ||
+                                 resumed.mesh != checkpoint.mesh ||
+                                 resumed.scales != checkpoint.scales ||
+                                 (casadi_int)resumed.x.size() !=
+                                         numVariables ||
+                                 (casadi_int)resumed.lam_x.size() !=
+                                         numVariables ||
+                                 (casadi_int)resumed.lam_g.size() !=
+                                         numConstraints,
+                OpenSim::Exception,
+                OpenSim::format("Checkpoint '%s' was created for a different "
+                                "problem, mesh, or variable scaling; delete "
+                                "it to solve the problem from the guess.",
+                        m_solver.getCheckpointFilepath()));
+        std::cout << "Resuming from checkpoint '"
+                  << m_solver.getCheckpointFilepath() << "' at iteration "
+                  << resumed.iteration << " (objective: "
+                  << resumed.objective << ")." << std::endl;
+        checkpoint.iteration = resumed.iteration;
+        if (m_solver.getOptimSolver() == "ipopt" &&
+                solverOptions.find("warm_start_init_point") ==
+                        solverOptions.end()) {
+            // Start from the multipliers, too.
+            solverOptions["warm_start_init_point"] = "yes";
+        }
+    }
+
+    // Create the CasADi NLP function.
+    // -------------------------------
+    // Option handling is copied from casadi::OptiNode::solver().
+    casadi::Dict options = m_solver.getPluginOptions();
+    if (!options.empty()) {
+        options[m_solver.getOptimSolver()] = solverOptions;
+    }
 
     NlpsolCallback callback(*this, m_problem, numVariables, numConstraints,
-            m_solver.getCallbackInterval());
+            m_solver.getCallbackInterval(), std::move(checkpoint));
     options["iteration_callback"] = callback;
 
     // The inputs to nlpsol() are symbolic (casadi::MX).
@@ -657,7 +852,7 @@ Solution Transcription::solve(const Iterate& guessOrig) {
         objective = 0;
     }
     nlp.emplace(std::make_pair("f", objective));
-    nlp.emplace(std::make_pair("g", g));
+    nlp.emplace(std::make_pair("g", gScaled));
     if (!m_solver.getWriteSparsity().empty()) {
         const auto prefix = m_solver.getWriteSparsity();
         auto gradient = casadi::MX::gradient(nlp["f"], nlp["x"]);
@@ -681,12 +876,20 @@ Solution Transcription::solve(const Iterate& guessOrig) {
     // Run the optimization (evaluate the CasADi NLP function).
     // --------------------------------------------------------
     // The inputs and outputs of nlpFunc are numeric (casadi::DM).
-    const casadi::DMDict nlpResult =
-            nlpFunc(casadi::DMDict{{"x0", flattenVariables(guess.variables)},
-                    {"lbx", flattenVariables(m_lowerBounds)},
-                    {"ubx", flattenVariables(m_upperBounds)},
-                    {"lbg", flattenConstraints(m_constraintsLowerBounds)},
-                    {"ubg", flattenConstraints(m_constraintsUpperBounds)}});
+    casadi::DMDict nlpInputs{
+            {"x0", flattenVariables(createDecisionValues(guess.variables))},
+            {"lbx", flattenVariables(createDecisionValues(m_lowerBounds))},
+            {"ubx", flattenVariables(createDecisionValues(m_upperBounds))},
+            {"lbg", flattenConstraints(
+                            scaleConstraints(m_constraintsLowerBounds))},
+            {"ubg", flattenConstraints(
+                            scaleConstraints(m_constraintsUpperBounds))}};
+    if (resume) {
+        nlpInputs["x0"] = casadi::DM(resumed.x);
+        nlpInputs["lam_x0"] = casadi::DM(resumed.lam_x);
+        nlpInputs["lam_g0"] = casadi::DM(resumed.lam_g);
+    }
+    const casadi::DMDict nlpResult = nlpFunc(nlpInputs);
 
     // Create a CasOC::Solution.
     // -------------------------
@@ -1174,9 +1377,10 @@ Iterate Transcription::createRandomIterateWithinBounds(
 casadi::MXVector Transcription::evalOnTrajectory(
         const casadi::Function& pointFunction, const std::vector<Var>& inputs,
         const casadi::Matrix<casadi_int>& timeIndices) const {
-    auto parallelism = m_solver.getParallelism();
-    const auto trajFunc = pointFunction.map(
-            timeIndices.size2(), parallelism.first, parallelism.second);
+    const auto trajFunc = m_solver.compileFunction(pointFunction)
+                                  .map(timeIndices.size2(),
+                                          m_parallelism.first,
+                                          m_parallelism.second);
 
     // Assemble input.
     // Add 1 for time input and 1 for parameters input.
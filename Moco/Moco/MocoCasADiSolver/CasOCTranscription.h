@@ -29,8 +29,17 @@ namespace CasOC {
 class Transcription {
 public:
     Transcription(const Solver& solver, const Problem& problem)
-            : m_solver(solver), m_problem(problem) {}
+            : m_solver(solver), m_problem(problem),
+              m_parallelism(solver.getParallelism()) {}
     virtual ~Transcription() = default;
+    /// Override the parallelism from the Solver (see
+    /// Solver::setParallelism()). This must be called before solve().
+    void setParallelism(std::string parallelism, int numThreads) {
+        m_parallelism = std::make_pair(std::move(parallelism), numThreads);
+    }
+    const std::pair<std::string, int>& getParallelism() const {
+        return m_parallelism;
+    }
     Iterate createInitialGuessFromBounds() const;
     /// Use the provided random number generator to generate an iterate.
     /// Random::Uniform is used if a generator is not provided. The generator
@@ -75,6 +84,16 @@ protected:
             int numDefectsPerMeshInterval,
             const casadi::DM& pointsForInterpControls = casadi::DM());
 
+    /// Evaluate a function of a single mesh interval on all mesh intervals
+    /// using casadi::Function::map(). Each input has one column per mesh
+    /// interval, and the output has one column per mesh interval.
+    casadi::MX evalOnMeshIntervals(const casadi::Function& intervalFunction,
+            const casadi::MXVector& inputs) const {
+        return m_solver.compileFunction(intervalFunction)
+                .map(m_numMeshIntervals)(inputs)
+                .at(0);
+    }
+
     /// We assume all functions depend on time and parameters.
     /// "inputs" is prepended by time and postpended (?) by parameters.
     casadi::MXVector evalOnTrajectory(const casadi::Function& pointFunction,
@@ -115,6 +134,7 @@ protected:
 
     const Solver& m_solver;
     const Problem& m_problem;
+    std::pair<std::string, int> m_parallelism;
     int m_numGridPoints = -1;
     int m_numMeshPoints = -1;
     int m_numMeshIntervals = -1;
@@ -125,11 +145,26 @@ protected:
     int m_numConstraints = -1;
     casadi::DM m_grid;
     casadi::DM m_pointsForInterpControls;
+    /// Whether the controls at pointsForInterpControls are expressions of the
+    /// other controls instead of NLP variables (see
+    /// Solver::setEliminateInterpolatedControls()).
+    bool m_eliminateInterpolatedControls = false;
     casadi::MX m_times;
     casadi::MX m_duration;
 
 private:
+    // The variables of the NLP. The expressions in m_vars, used to build the
+    // NLP, are the decision variables multiplied by m_variableScales (if
+    // scaling is enabled) and, if m_eliminateInterpolatedControls, the
+    // controls are the decision variables (at the grid points given by
+    // m_controlPointIndices) times m_controlInterpolationMatrix.
+    VariablesMX m_decisionVars;
     VariablesMX m_vars;
+    casadi::Matrix<casadi_int> m_controlPointIndices;
+    casadi::DM m_controlInterpolationMatrix;
+    // Column vectors with an element for each row of each variable. Empty if
+    // scaling is disabled.
+    VariablesDM m_variableScales;
     casadi::MX m_paramsTrajGrid;
     casadi::MX m_paramsTrajMesh;
     casadi::MX m_paramsTrajMeshInterior;
@@ -179,6 +214,66 @@ private:
         calcInterpolatingControlsImpl(
                 m_vars.at(controls), m_constraints.interp_controls);
     }
+    void createControlInterpolationMatrix();
+    /// Set m_vars and the quantities derived from them (e.g., m_times) from
+    /// m_decisionVars.
+    void createVariableExpressions();
+    /// Compute m_variableScales from the variable bounds, the guess, and the
+    /// scales provided by the user (Solver::setVariableScales()).
+    void setVariableScales(const VariablesDM& guess);
+
+    /// Convert an iterate's variables (or variable bounds) to values of the
+    /// NLP's decision variables, for passing to nlpsol(): remove the
+    /// eliminated controls and divide by the variable scales.
+    VariablesDM createDecisionValues(VariablesDM vars) const {
+        if (m_eliminateInterpolatedControls) {
+            vars[controls] =
+                    vars[controls](casadi::Slice(), m_controlPointIndices);
+        }
+        if (!m_variableScales.empty()) {
+            for (auto& kv : vars) {
+                kv.second /= casadi::DM::repmat(m_variableScales.at(kv.first),
+                        1, kv.second.columns());
+            }
+        }
+        return vars;
+    }
+    /// The scale of each element of the 'x' column vector of the nonlinear
+    /// program (all 1 if the variables are not scaled).
+    casadi::DM createFlattenedVariableScales() const {
+        VariablesDM scales;
+        for (const auto& kv : m_decisionVars) {
+            scales[kv.first] =
+                    m_variableScales.empty()
+                            ? casadi::DM::ones(kv.second.rows(),
+                                      kv.second.columns())
+                            : casadi::DM::repmat(m_variableScales.at(kv.first),
+                                      1, kv.second.columns());
+        }
+        return flattenVariables(scales);
+    }
+    /// Divide the defects by the scales of the corresponding states and the
+    /// control interpolation constraints by the scales of the controls. The
+    /// other constraints are not scaled.
+    template <typename T>
+    Constraints<T> scaleConstraints(Constraints<T> constraints) const {
+        if (m_variableScales.empty()) return constraints;
+        const casadi::DM& stateScales = m_variableScales.at(states);
+        if (stateScales.numel()) {
+            casadi::DM defectScales(m_numDefectsPerMeshInterval, 1);
+            for (int i = 0; i < m_numDefectsPerMeshInterval; ++i) {
+                defectScales(i) = stateScales(i % stateScales.numel());
+            }
+            constraints.defects /= casadi::DM::repmat(
+                    defectScales, 1, constraints.defects.columns());
+        }
+        if (constraints.interp_controls.numel()) {
+            constraints.interp_controls /=
+                    casadi::DM::repmat(m_variableScales.at(controls), 1,
+                            constraints.interp_controls.columns());
+        }
+        return constraints;
+    }
 
     /// Use this function to ensure you iterate through variables in the same
     /// order.
@@ -199,19 +294,29 @@ private:
         }
         return T::veccat(stdvec);
     }
-    /// Convert the 'x' column vector into separate variables.
+    /// Convert the 'x' column vector into separate variables. Variables are
+    /// unscaled, and eliminated controls are computed from the control
+    /// variables.
     CasOC::VariablesDM expandVariables(const casadi::DM& x) const {
         CasOC::VariablesDM out;
         using casadi::Slice;
         casadi_int offset = 0;
-        for (const auto& key : getSortedVarKeys(m_vars)) {
-            const auto& value = m_vars.at(key);
+        for (const auto& key : getSortedVarKeys(m_decisionVars)) {
+            const auto& value = m_decisionVars.at(key);
             // Convert a portion of the column vector into a matrix.
             out[key] = casadi::DM::reshape(
                     x(Slice(offset, offset + value.numel())), value.rows(),
                     value.columns());
+            if (!m_variableScales.empty()) {
+                out[key] *= casadi::DM::repmat(
+                        m_variableScales.at(key), 1, value.columns());
+            }
             offset += value.numel();
         }
+        if (m_eliminateInterpolatedControls) {
+            out[controls] = casadi::DM::mtimes(
+                    out[controls], m_controlInterpolationMatrix);
+        }
         return out;
     }
 
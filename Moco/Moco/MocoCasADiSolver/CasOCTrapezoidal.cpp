@@ -20,6 +20,16 @@
 using casadi::DM;
 using casadi::MX;
 using casadi::Slice;
+using casadi::SX;
+
+namespace {
+/// The trapezoidal defects for a single mesh interval.
+template <typename T>
+T calcIntervalDefects(const T& h, const T& x_i, const T& x_ip1,
+        const T& xdot_i, const T& xdot_ip1) {
+    return x_ip1 - (x_i + 0.5 * h * (xdot_ip1 + xdot_i));
+}
+} // namespace
 
 namespace CasOC {
 
@@ -43,6 +53,24 @@ DM Trapezoidal::createMeshIndicesImpl() const {
 void Trapezoidal::calcDefectsImpl(
         const casadi::MX& x, const casadi::MX& xdot, casadi::MX& defects) const {
 
+    if (m_solver.getSXTranscriptionFormulas()) {
+        const int NS = m_problem.getNumStates();
+        const SX h = SX::sym("h");
+        const SX x_i = SX::sym("x_i", NS);
+        const SX x_ip1 = SX::sym("x_ip1", NS);
+        const SX xdot_i = SX::sym("xdot_i", NS);
+        const SX xdot_ip1 = SX::sym("xdot_ip1", NS);
+        const casadi::Function intervalDefects("trapezoidal_defects",
+                {h, x_i, x_ip1, xdot_i, xdot_ip1},
+                {calcIntervalDefects(h, x_i, x_ip1, xdot_i, xdot_ip1)});
+        const Slice i(0, m_numGridPoints - 1);
+        const Slice ip1(1, m_numGridPoints);
+        defects = evalOnMeshIntervals(intervalDefects,
+                {m_times(Slice(), ip1) - m_times(Slice(), i), x(Slice(), i),
+                        x(Slice(), ip1), xdot(Slice(), i), xdot(Slice(), ip1)});
+        return;
+    }
+
     // We have arranged the code this way so that all constraints at a given
     // mesh point are grouped together (organizing the sparsity of the Jacobian
     // this way might have benefits for sparse linear algebra).
@@ -54,7 +82,8 @@ void Trapezoidal::calcDefectsImpl(
         const auto xdot_ip1 = xdot(Slice(), itime + 1);
 
         // Trapezoidal defects.
-        defects(Slice(), itime) = x_ip1 - (x_i + 0.5 * h * (xdot_ip1 + xdot_i));
+        defects(Slice(), itime) =
+                calcIntervalDefects(h, x_i, x_ip1, xdot_i, xdot_ip1);
     }
 }
 
@@ -18,10 +18,12 @@
 
 #include "MocoCasADiSolver.h"
 
+#include "../MocoThreadBudget.h"
 #include "../MocoUtilities.h"
 #include "CasOCSolver.h"
 #include "MocoCasOCProblem.h"
 #include <casadi/casadi.hpp>
+#include <cstdio>
 
 using casadi::Callback;
 using casadi::Dict;
@@ -32,6 +34,17 @@ using casadi::Sparsity;
 
 using namespace OpenSim;
 
+namespace {
+/// Identify a problem in checkpoints using a hash of the problem's
+/// serialization and the data it references (e.g., reference files).
+std::string calcProblemHash(const MocoProblem& problem) {
+    ContentHasher hasher;
+    hasher.updateFromSerialization(problem);
+    hasher.updateFromReferencedData(problem);
+    return hasher.getHexDigest();
+}
+} // anonymous namespace
+
 MocoCasADiSolver::MocoCasADiSolver() { constructProperties(); }
 
 void MocoCasADiSolver::constructProperties() {
@@ -40,12 +53,20 @@ void MocoCasADiSolver::constructProperties() {
     constructProperty_optim_write_sparsity("");
     constructProperty_optim_finite_difference_scheme("central");
     constructProperty_parallel();
+    constructProperty_parallel_auto_tune(false);
     constructProperty_output_interval(0);
 
     constructProperty_minimize_implicit_multibody_accelerations(false);
     constructProperty_implicit_multibody_accelerations_weight(1.0);
     constructProperty_minimize_implicit_auxiliary_derivatives(false);
     constructProperty_implicit_auxiliary_derivatives_weight(1.0);
+    constructProperty_sx_transcription_formulas(false);
+    constructProperty_eliminate_interpolated_control_midpoints(false);
+    constructProperty_compile_sx_functions(false);
+    constructProperty_compiled_functions_cache_dir("");
+    constructProperty_checkpoint_path("");
+    constructProperty_checkpoint_interval(10);
+    constructProperty_resume_from_checkpoint(false);
 }
 
 MocoTrajectory MocoCasADiSolver::createGuess(const std::string& type) const {
@@ -124,8 +145,7 @@ const MocoTrajectory& MocoCasADiSolver::getGuess() const {
     return m_guessToUse.getRef();
 }
 
-std::unique_ptr<MocoCasOCProblem> MocoCasADiSolver::createCasOCProblem() const {
-    const auto& problemRep = getProblemRep();
+int MocoCasADiSolver::getNumThreadsRequested() const {
     int parallel = 1;
     int parallelEV = getMocoParallelEnvironmentVariable();
     if (getProperty_parallel().size()) {
@@ -133,23 +153,23 @@ std::unique_ptr<MocoCasOCProblem> MocoCasADiSolver::createCasOCProblem() const {
     } else if (parallelEV != -1) {
         parallel = parallelEV;
     }
-    // if (m_runningInPython && parallel) {
-    //    std::cout << "Warning: "
-    //                 "Cannot use parallelism in Python due to its "
-    //                 "Global Interpreter Lock. "
-    //                 "Set the environment variable OPENSIM_MOCO_PARALLEL or "
-    //                 "MocoCasADiSolver's 'parallel' property to 0, "
-    //                 "or use the command-line or Matlab interfaces."
-    //              << std::endl;
-    //}
+    // The Python bindings release the Global Interpreter Lock while solving,
+    // so parallelism is allowed when running in Python.
     int numThreads;
     if (parallel == 0) {
         numThreads = 1;
     } else if (parallel == 1) {
-        numThreads = std::thread::hardware_concurrency();
+        numThreads = MocoThreadBudget::getNumCores();
     } else {
         numThreads = parallel;
     }
+    return numThreads;
+}
+
+std::unique_ptr<MocoCasOCProblem> MocoCasADiSolver::createCasOCProblem(
+        int numThreads) const {
+    const auto& problemRep = getProblemRep();
+    if (numThreads == -1) numThreads = getNumThreadsRequested();
 
     checkPropertyInSet(
             *this, getProperty_multibody_dynamics_mode(), {"explicit", "implicit"});
@@ -267,6 +287,30 @@ std::unique_ptr<CasOC::Solver> MocoCasADiSolver::createCasOCSolver(
 
     casSolver->setCallbackInterval(get_output_interval());
 
+    OPENSIM_THROW_IF_FRMOBJ(!get_checkpoint_path().empty() &&
+                                    get_checkpoint_interval() < 1,
+            Exception,
+            format("Expected checkpoint_interval to be positive, but got %i.",
+                    get_checkpoint_interval()));
+    OPENSIM_THROW_IF_FRMOBJ(
+            get_resume_from_checkpoint() && get_checkpoint_path().empty(),
+            Exception,
+            "Property 'resume_from_checkpoint' is enabled, but no "
+            "'checkpoint_path' was provided.");
+    if (!get_checkpoint_path().empty()) {
+        if (get_resume_from_checkpoint() && get_verbosity() &&
+                hasUnhashedReferenceData(getProblem())) {
+            std::cout << "Warning: a goal holds reference data in memory, "
+                         "which is not part of the problem hash; a checkpoint "
+                         "created with different reference data cannot be "
+                         "detected."
+                      << std::endl;
+        }
+        casSolver->setCheckpoint(get_checkpoint_path(),
+                get_checkpoint_interval(), calcProblemHash(getProblem()));
+        casSolver->setResumeFromCheckpoint(get_resume_from_checkpoint());
+    }
+
     Dict pluginOptions;
     pluginOptions["verbose_init"] = true;
 
@@ -311,9 +355,18 @@ std::unique_ptr<CasOC::Solver> MocoCasADiSolver::createCasOCSolver(
     casSolver->setOptimSolver(get_optim_solver());
     casSolver->setInterpolateControlMidpoints(
             get_interpolate_control_midpoints());
+    casSolver->setSXTranscriptionFormulas(get_sx_transcription_formulas());
+    casSolver->setEliminateInterpolatedControls(
+            get_eliminate_interpolated_control_midpoints());
+    casSolver->setScaleVariablesAndConstraints(
+            get_scale_variables_and_constraints());
+    casSolver->setVariableScales(createVariableScalesMap());
+    casSolver->setCompileFunctions(get_compile_sx_functions(),
+            get_compiled_functions_cache_dir());
     if (casProblem.getJarSize() > 1) {
         casSolver->setParallelism("thread", casProblem.getJarSize());
     }
+    casSolver->setAutoParallelism(get_parallel_auto_tune());
     casSolver->setPluginOptions(pluginOptions);
     casSolver->setSolverOptions(solverOptions);
     return casSolver;
@@ -329,7 +382,11 @@ MocoSolution MocoCasADiSolver::solveImpl() const {
         std::cout << std::string(79, '-') << std::endl;
         getProblemRep().printDescription();
     }
-    auto casProblem = createCasOCProblem();
+    // Share the cores with any other solves running in this process. The
+    // lease is held until the solve finishes.
+    auto lease = MocoThreadBudget::acquire(getNumThreadsRequested());
+    MocoThreadBudget::limitLinearAlgebraThreads(lease.getNumThreads());
+    auto casProblem = createCasOCProblem(lease.getNumThreads());
     auto casSolver = createCasOCSolver(*casProblem);
     if (get_verbosity()) {
         std::cout << "Number of threads: " << casProblem->getJarSize()
@@ -346,6 +403,12 @@ MocoSolution MocoCasADiSolver::solveImpl() const {
     CasOC::Solution casSolution = casSolver->solve(casGuess);
     MocoSolution mocoSolution =
             convertToMocoTrajectory<MocoSolution>(casSolution);
+    const int numThreadsUsed = casSolution.stats.at("num_threads");
+    if (get_verbosity() && get_parallel_auto_tune()) {
+        std::cout << "Automatically chose " << numThreadsUsed
+                  << " thread(s) of " << casProblem->getJarSize() << "."
+                  << std::endl;
+    }
 
     // If enforcing model constraints and not minimizing Lagrange multipliers,
     // check the rank of the constraint Jacobian and if rank-deficient, print
@@ -396,11 +459,28 @@ MocoSolution MocoCasADiSolver::solveImpl() const {
         }
     }
 
+    // CasADi counts the evaluations of each function of the NLP (e.g.,
+    // "n_call_nlp_f").
+    std::vector<std::pair<std::string, int>> numEvaluations;
+    const std::string callPrefix = "n_call_";
+    for (const auto& stat : casSolution.stats) {
+        if (startsWith(stat.first, callPrefix) && stat.second.is_int()) {
+            numEvaluations.emplace_back(stat.first.substr(callPrefix.size()),
+                    (int)stat.second.as_int());
+        }
+    }
+
+    // A successful solve no longer needs its checkpoint.
+    if (!get_checkpoint_path().empty() && mocoSolution.success()) {
+        std::remove(get_checkpoint_path().c_str());
+    }
+
     const long long elapsed = stopwatch.getElapsedTimeInNs();
     setSolutionStats(mocoSolution, casSolution.stats.at("success"),
             casSolution.objective, casSolution.stats.at("return_status"),
             casSolution.stats.at("iter_count"), SimTK::nsToSec(elapsed),
-            casSolution.objective_breakdown);
+            casSolution.objective_breakdown, numThreadsUsed,
+            std::move(numEvaluations));
 
     if (get_verbosity()) {
         std::cout << std::string(79, '-') << "\n";
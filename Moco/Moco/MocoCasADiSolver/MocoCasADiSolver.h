@@ -77,10 +77,23 @@ class MocoCasOCProblem;
 /// a machine with 4 cores, you could set OPENSIM_MOCO_PARALLEL to 2 to use
 /// all 4 cores.
 ///
+/// Solves running at the same time in one process (e.g., MocoStudy::solve()
+/// called from multiple threads) share the cores in the MocoThreadBudget: each
+/// solve leases the threads it requests from the cores that other solves are
+/// not using, and the linear solver (MUMPS) and BLAS reuse the leased cores.
+/// The number of threads a solve actually used is printed when verbosity is
+/// on.
+///
 /// Note that there is overhead in the parallelization; if you plan to solve
 /// many problems, it is better to turn off parallelization here and parallelize
 /// the solving of your multiple problems using your system (e.g., invoke the
 /// opensim-moco command-line tool in multiple Terminals or Command Prompts).
+/// For small models, the overhead may exceed the benefit of parallelization.
+/// Set the `parallel_auto_tune` property to true to have the solver time the
+/// problem's functions before solving and choose the number of threads
+/// (possibly 1) that it predicts is fastest; `parallel` is then the maximum
+/// number of threads. The number of threads used is available from
+/// MocoSolution::getNumThreads().
 ///
 /// Note that the `parallel` property overrides the environment variable,
 /// allowing more granular control over parallelization. However, the
@@ -103,6 +116,28 @@ class MocoCasOCProblem;
 /// Model::initSystem(). To protect against this, ensure that you obtain the
 /// same results whether this setting is true or false.
 ///
+/// Checkpoints
+/// ===========
+/// Long solves can be resumed after they are interrupted (e.g., when a job
+/// on a cluster is preempted). Set `checkpoint_path` to have the solver
+/// write the optimizer's current iterate, along with the multipliers for the
+/// bounds and constraints, to a binary file every `checkpoint_interval`
+/// iterations. To resume, solve the same problem again with
+/// `resume_from_checkpoint` enabled; if the checkpoint file exists, the
+/// optimizer starts from the iterate in the file (for IPOPT, with a warm
+/// start of the multipliers) instead of from the guess:
+/// @code
+/// solver.set_checkpoint_path("gait3d.checkpoint");
+/// solver.set_checkpoint_interval(20);
+/// solver.set_resume_from_checkpoint(true);
+/// @endcode
+/// The checkpoint records a hash of the problem's serialization and the
+/// files it references, the mesh, and the scales of the variables, and the
+/// solver throws an exception if these do not match the problem being
+/// solved. The checkpoint file is
+/// deleted once the problem is solved successfully. Each solve after
+/// resuming may perform up to `optim_max_iterations` iterations.
+///
 /// @note The software license of CasADi (LGPL) is more restrictive than that of
 /// the rest of Moco (Apache 2.0).
 /// @note This solver currently only supports systems for which \f$ \dot{q} = u
@@ -135,6 +170,11 @@ public:
             "0: not parallel; 1: use all cores (default); greater than 1: use"
             "this number of threads. This overrides the OPENSIM_MOCO_PARALLEL "
             "environment variable.");
+    OpenSim_DECLARE_PROPERTY(parallel_auto_tune, bool,
+            "Time the functions evaluated at each grid point and use the "
+            "number of threads (at most the number from 'parallel') that is "
+            "predicted to be fastest, possibly evaluating serially. "
+            "Default: false.");
     OpenSim_DECLARE_PROPERTY(output_interval, int,
             "Write intermediate trajectories to file. 0, the default, "
             "indicates no intermediate trajectories are saved, 1 indicates "
@@ -157,6 +197,45 @@ public:
             "The weight on the cost term added if "
             "'minimize_implicit_auxiliary_derivatives' is enabled."
             "Default: 1.0.");
+    OpenSim_DECLARE_PROPERTY(sx_transcription_formulas, bool,
+            "Build the transcription's defect and control interpolation "
+            "constraints from a CasADi SX function of a single mesh interval, "
+            "mapped across all mesh intervals. This reduces the size of the "
+            "expression graph for the optimization problem. Default: false.");
+    OpenSim_DECLARE_PROPERTY(eliminate_interpolated_control_midpoints, bool,
+            "If 'interpolate_control_midpoints' is enabled, remove the "
+            "controls at mesh interval midpoints from the optimization "
+            "variables and substitute the interpolated values for them, "
+            "instead of adding interpolation constraints. This yields a "
+            "smaller problem with the same solution. Default: false.");
+    OpenSim_DECLARE_PROPERTY(compile_sx_functions, bool,
+            "Generate C code for the problem's symbolic (SX) functions "
+            "(algebraic goals and, with 'sx_transcription_formulas', the "
+            "transcription formulas), compile it with the C compiler given by "
+            "the CC environment variable (default: cc; run without a shell), "
+            "and evaluate the compiled code. Not supported on Windows. "
+            "Default: false.");
+    OpenSim_DECLARE_PROPERTY(compiled_functions_cache_dir, std::string,
+            "Directory in which to cache the libraries created by "
+            "'compile_sx_functions'; libraries are reused across solves if "
+            "the generated code is unchanged. The directory must be owned by "
+            "the current user and must not be writable by other users. "
+            "Default: '' ($TMPDIR/opensim-moco-compiled-functions-<user ID>, "
+            "created with permissions for the current user only).");
+
+    OpenSim_DECLARE_PROPERTY(checkpoint_path, std::string,
+            "Path of a binary file to which the optimizer's current iterate "
+            "and multipliers are written periodically, so that an interrupted "
+            "solve can be resumed (see 'resume_from_checkpoint'). "
+            "Default: '' (no checkpoints).");
+    OpenSim_DECLARE_PROPERTY(checkpoint_interval, int,
+            "If 'checkpoint_path' is set, write the checkpoint every this "
+            "many iterations. Default: 10.");
+    OpenSim_DECLARE_PROPERTY(resume_from_checkpoint, bool,
+            "If the file at 'checkpoint_path' exists, start the optimizer "
+            "from the checkpoint instead of from the guess. The checkpoint "
+            "must have been written for the same problem and mesh. "
+            "Default: false.");
 
     MocoCasADiSolver();
 
@@ -211,7 +290,12 @@ public:
 protected:
     MocoSolution solveImpl() const override;
 
-    std::unique_ptr<MocoCasOCProblem> createCasOCProblem() const;
+    /// The number of threads requested via the `parallel` property or the
+    /// OPENSIM_MOCO_PARALLEL environment variable.
+    int getNumThreadsRequested() const;
+    /// If numThreads is -1, use getNumThreadsRequested().
+    std::unique_ptr<MocoCasOCProblem> createCasOCProblem(
+            int numThreads = -1) const;
     std::unique_ptr<CasOC::Solver> createCasOCSolver(
             const MocoCasOCProblem&) const;
 
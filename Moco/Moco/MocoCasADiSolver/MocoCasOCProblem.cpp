@@ -26,6 +26,64 @@ thread_local SimTK::Vector_<SimTK::SpatialVec>
         MocoCasOCProblem::m_constraintBodyForces;
 thread_local SimTK::Vector MocoCasOCProblem::m_constraintMobilityForces;
 thread_local SimTK::Vector MocoCasOCProblem::m_pvaerr;
+thread_local MocoCasOCProblem::HeldRep MocoCasOCProblem::m_heldRep;
+
+namespace {
+/// Convert a MocoAlgebraicForm, whose states and controls are identified by
+/// their system indices, to a CasOC::AlgebraicFunction. This returns nullptr
+/// if the form depends on a state or control that is not a variable in the
+/// CasOC problem.
+std::unique_ptr<CasOC::AlgebraicFunction> convertAlgebraicForm(
+        const MocoAlgebraicForm& form,
+        const std::unordered_map<int, int>& casStateIndices,
+        const std::unordered_map<int, int>& casControlIndices) {
+    using Variable = MocoAlgebraicTerm::Variable;
+    using CasVariable = CasOC::AlgebraicTerm::Variable;
+    bool convertible = true;
+    auto convertTerms = [&](const std::vector<MocoAlgebraicTerm>& terms) {
+        std::vector<CasOC::AlgebraicTerm> casTerms;
+        for (const auto& term : terms) {
+            CasVariable variable;
+            int index = 0;
+            if (term.variable == Variable::State ||
+                    term.variable == Variable::Control) {
+                const auto& indices = term.variable == Variable::State
+                                              ? casStateIndices
+                                              : casControlIndices;
+                const auto it = indices.find(term.index);
+                if (it == indices.end()) {
+                    convertible = false;
+                    continue;
+                }
+                variable = term.variable == Variable::State
+                                   ? CasVariable::State
+                                   : CasVariable::Control;
+                index = it->second;
+            } else if (term.variable == Variable::Time) {
+                variable = CasVariable::Time;
+            } else if (term.variable == Variable::Integral) {
+                variable = CasVariable::Integral;
+            } else {
+                variable = CasVariable::Constant;
+            }
+            casTerms.emplace_back(
+                    variable, index, term.coefficient, term.final);
+        }
+        return casTerms;
+    };
+
+    auto algebraic = OpenSim::make_unique<CasOC::AlgebraicFunction>();
+    algebraic->integrand = convertTerms(form.integrand);
+    algebraic->integrand_exponent = form.integrandExponent;
+    for (const auto& output : form.outputs) {
+        algebraic->outputs.push_back(convertTerms(output));
+    }
+    algebraic->square_outputs = form.squareOutputs;
+    algebraic->scale = form.scale;
+    if (!convertible) return nullptr;
+    return algebraic;
+}
+} // anonymous namespace
 
 MocoCasOCProblem::MocoCasOCProblem(const MocoCasADiSolver& mocoCasADiSolver,
         const MocoProblemRep& problemRep,
@@ -69,6 +127,38 @@ MocoCasOCProblem::MocoCasOCProblem(const MocoCasADiSolver& mocoCasADiSolver,
                 convertBounds(info.getFinalBounds()));
     }
 
+    // Goals and path constraints with an algebraic form identify states and
+    // controls by their system indices; map these to the CasOC indices.
+    // With prescribed kinematics, the coordinates and speeds in the
+    // SimTK::State come from the prescribed motion rather than from the NLP
+    // variables, so such goals must use the model. The remaining CasOC states
+    // are offset by the number of multibody state variables in the model.
+    std::unordered_map<int, int> casStateIndices;
+    const int numMultibodyY = model.getWorkingState().getNQ() +
+                              model.getWorkingState().getNU();
+    int numSkipped = 0;
+    for (int isv = 0; isv < (int)m_yIndexMap.size(); ++isv) {
+        const int iy = m_yIndexMap.at(isv);
+        if (problemRep.isPrescribedKinematics() && iy < numMultibodyY) {
+            ++numSkipped;
+            continue;
+        }
+        casStateIndices[iy] = isv - numSkipped;
+    }
+    std::unordered_map<int, int> casControlIndices;
+    for (int ic = 0; ic < (int)m_modelControlIndices.size(); ++ic) {
+        casControlIndices[m_modelControlIndices[ic]] = ic;
+    }
+    auto createAlgebraicFunction = [&](bool hasForm,
+                                           const MocoAlgebraicForm& form) {
+        std::unique_ptr<CasOC::AlgebraicFunction> algebraic;
+        if (hasForm) {
+            algebraic = convertAlgebraicForm(
+                    form, casStateIndices, casControlIndices);
+        }
+        return algebraic;
+    };
+
     // Set the number of residual equations to be enforced for components with
     // dynamics in implicit form.
     const auto& implicitRefs = problemRep.getImplicitComponentReferencePtrs();
@@ -218,7 +308,10 @@ MocoCasOCProblem::MocoCasOCProblem(const MocoCasADiSolver& mocoCasADiSolver,
         const auto costNames = problemRep.createCostNames();
         for (const auto& name : costNames) {
             const auto& cost = problemRep.getCost(name);
-            addCost(name, cost.getNumIntegrals(), cost.getNumOutputs());
+            MocoAlgebraicForm form;
+            const bool hasForm = cost.getAlgebraicForm(form);
+            addCost(name, cost.getNumIntegrals(), cost.getNumOutputs(),
+                    createAlgebraicFunction(hasForm, form));
         }
     }
     {
@@ -230,7 +323,10 @@ MocoCasOCProblem::MocoCasOCProblem(const MocoCasADiSolver& mocoCasADiSolver,
             for (const auto& bounds : ec.getConstraintInfo().getBounds()) {
                 casBounds.push_back(convertBounds(bounds));
             }
-            addEndpointConstraint(name, ec.getNumIntegrals(), casBounds);
+            MocoAlgebraicForm form;
+            const bool hasForm = ec.getAlgebraicForm(form);
+            addEndpointConstraint(name, ec.getNumIntegrals(), casBounds,
+                    createAlgebraicFunction(hasForm, form));
         }
     }
 
@@ -241,7 +337,10 @@ MocoCasOCProblem::MocoCasOCProblem(const MocoCasADiSolver& mocoCasADiSolver,
         for (const auto& bounds : pathCon.getConstraintInfo().getBounds()) {
             casBounds.push_back(convertBounds(bounds));
         }
-        addPathConstraint(name, casBounds);
+        MocoAlgebraicForm form;
+        const bool hasForm = pathCon.getAlgebraicForm(form);
+        addPathConstraint(name, casBounds,
+                createAlgebraicFunction(hasForm, form));
     }
 
     m_fileDeletionThrower = OpenSim::make_unique<FileDeletionThrower>(
@@ -203,7 +203,7 @@ private:
     void calcMultibodySystemExplicit(const ContinuousInput& input,
             bool calcKCErrors,
             MultibodySystemExplicitOutput& output) const override {
-        auto mocoProblemRep = m_jar->take();
+        auto mocoProblemRep = takeRep();
 
         const auto& modelBase = mocoProblemRep->getModelBase();
         auto& simtkStateBase = mocoProblemRep->updStateBase();
@@ -239,12 +239,12 @@ private:
         copyImplicitResidualsToOutput(*mocoProblemRep,
                 simtkStateDisabledConstraints, output.auxiliary_residuals);
 
-        m_jar->leave(std::move(mocoProblemRep));
+        leaveRep(std::move(mocoProblemRep));
     }
     void calcMultibodySystemImplicit(const ContinuousInput& input,
             bool calcKCErrors,
             MultibodySystemImplicitOutput& output) const override {
-        auto mocoProblemRep = m_jar->take();
+        auto mocoProblemRep = takeRep();
 
         // Original model and its associated state. These are used to calculate
         // kinematic constraint forces and errors.
@@ -291,14 +291,19 @@ private:
         copyImplicitResidualsToOutput(*mocoProblemRep,
                 simtkStateDisabledConstraints, output.auxiliary_residuals);
 
-        m_jar->leave(std::move(mocoProblemRep));
+        leaveRep(std::move(mocoProblemRep));
     }
     void calcVelocityCorrection(const double& time,
-            const casadi::DM& multibody_states, const casadi::DM& slacks,
-            const casadi::DM& parameters,
-            casadi::DM& velocity_correction) const override {
-        if (isPrescribedKinematics()) return;
-        auto mocoProblemRep = m_jar->take();
+            const CasOC::InputVector& multibody_states,
+            const CasOC::InputVector& slacks,
+            const CasOC::InputVector& parameters,
+            CasOC::OutputVector velocity_correction) const override {
+        if (isPrescribedKinematics()) {
+            std::fill_n(velocity_correction.ptr(),
+                    velocity_correction.numel(), 0.0);
+            return;
+        }
+        auto mocoProblemRep = takeRep();
 
         const auto& modelBase = mocoProblemRep->getModelBase();
         auto& simtkStateBase = mocoProblemRep->updStateBase();
@@ -325,11 +330,11 @@ private:
                 velocity_correction.ptr(), true);
         matterBase.multiplyByGTranspose(simtkStateBase, gamma, qdotCorr);
 
-        m_jar->leave(std::move(mocoProblemRep));
+        leaveRep(std::move(mocoProblemRep));
     }
     void calcCostIntegrand(int index, const ContinuousInput& input,
             double& integrand) const override {
-        auto mocoProblemRep = m_jar->take();
+        auto mocoProblemRep = takeRep();
         applyInput(input.time, input.states, input.controls, input.multipliers,
                 input.derivatives, input.parameters, mocoProblemRep);
 
@@ -339,11 +344,11 @@ private:
         const auto& mocoCost = mocoProblemRep->getCostByIndex(index);
         integrand = mocoCost.calcIntegrand(simtkStateDisabledConstraints);
 
-        m_jar->leave(std::move(mocoProblemRep));
+        leaveRep(std::move(mocoProblemRep));
     }
     void calcCost(int index, const CostInput& input,
-            casadi::DM& cost) const override {
-        auto mocoProblemRep = m_jar->take();
+            CasOC::OutputVector cost) const override {
+        auto mocoProblemRep = takeRep();
 
         applyInput(input.initial_time, input.initial_states,
                 input.initial_controls, input.initial_multipliers,
@@ -367,12 +372,12 @@ private:
                         simtkStateDisabledConstraintsFinal, input.integral},
                 simtkCost);
 
-        m_jar->leave(std::move(mocoProblemRep));
+        leaveRep(std::move(mocoProblemRep));
     }
 
     void calcEndpointConstraintIntegrand(int index,
             const ContinuousInput& input, double& integrand) const override {
-        auto mocoProblemRep = m_jar->take();
+        auto mocoProblemRep = takeRep();
         applyInput(input.time, input.states, input.controls, input.multipliers,
                 input.derivatives, input.parameters, mocoProblemRep);
 
@@ -383,11 +388,11 @@ private:
                 mocoProblemRep->getEndpointConstraintByIndex(index);
         integrand = mocoEC.calcIntegrand(simtkStateDisabledConstraints);
 
-        m_jar->leave(std::move(mocoProblemRep));
+        leaveRep(std::move(mocoProblemRep));
     }
     void calcEndpointConstraint(int index, const CostInput& input,
-            casadi::DM& values) const override {
-        auto mocoProblemRep = m_jar->take();
+            CasOC::OutputVector values) const override {
+        auto mocoProblemRep = takeRep();
 
         applyInput(input.initial_time, input.initial_states,
                 input.initial_controls, input.initial_multipliers,
@@ -412,12 +417,12 @@ private:
                         simtkStateDisabledConstraintsFinal, input.integral},
                 simtkValues);
 
-        m_jar->leave(std::move(mocoProblemRep));
+        leaveRep(std::move(mocoProblemRep));
     }
 
     void calcPathConstraint(int constraintIndex, const ContinuousInput& input,
-            casadi::DM& path_constraint) const override {
-        auto mocoProblemRep = m_jar->take();
+            CasOC::OutputVector path_constraint) const override {
+        auto mocoProblemRep = takeRep();
         applyInput(input.time, input.states, input.controls, input.multipliers,
                 input.derivatives, input.parameters, mocoProblemRep);
         auto& simtkStateDisabledConstraints =
@@ -431,16 +436,27 @@ private:
         mocoPathCon.calcPathConstraintErrors(
                 simtkStateDisabledConstraints, errors);
 
-        m_jar->leave(std::move(mocoProblemRep));
+        leaveRep(std::move(mocoProblemRep));
     }
     std::vector<std::string>
     createKinematicConstraintEquationNamesImpl() const override {
-        auto mocoProblemRep = m_jar->take();
+        auto mocoProblemRep = takeRep();
         const auto names = mocoProblemRep->getKinematicConstraintEquationNames(
                 getEnforceConstraintDerivatives());
-        m_jar->leave(std::move(mocoProblemRep));
+        leaveRep(std::move(mocoProblemRep));
         return names;
     }
+    void beginRepeatedEvaluations() const override {
+        OPENSIM_THROW_IF(m_heldRep.owner, Exception,
+                "Repeated evaluations cannot be nested.");
+        m_heldRep.owner = this;
+        m_heldRep.rep = m_jar->take();
+    }
+    void endRepeatedEvaluations() const override {
+        if (m_heldRep.owner != this) return;
+        if (m_heldRep.rep) m_jar->leave(std::move(m_heldRep.rep));
+        m_heldRep.owner = nullptr;
+    }
     void intermediateCallbackImpl() const override {
         m_fileDeletionThrower->throwIfDeleted();
     }
@@ -452,10 +468,28 @@ private:
     }
 
 private:
+    /// During repeated evaluations (see beginRepeatedEvaluations()), this
+    /// returns the MocoProblemRep held by the current thread, so that the
+    /// evaluations reuse the same states; otherwise, this takes a
+    /// MocoProblemRep from the jar.
+    std::unique_ptr<const MocoProblemRep> takeRep() const {
+        if (m_heldRep.owner == this && m_heldRep.rep) {
+            return std::move(m_heldRep.rep);
+        }
+        return m_jar->take();
+    }
+    void leaveRep(std::unique_ptr<const MocoProblemRep> mocoProblemRep) const {
+        if (m_heldRep.owner == this && !m_heldRep.rep) {
+            m_heldRep.rep = std::move(mocoProblemRep);
+            return;
+        }
+        m_jar->leave(std::move(mocoProblemRep));
+    }
     /// Apply parameters to properties in the models returned by
     /// `mocoProblemRep.getModelBase()` and
     /// `mocoProblemRep.getModelDisabledConstraints()`.
-    void applyParametersToModelProperties(const casadi::DM& parameters,
+    void applyParametersToModelProperties(
+            const CasOC::InputVector& parameters,
             const MocoProblemRep& mocoProblemRep) const {
         if (parameters.numel()) {
             SimTK::Vector simtkParams(
@@ -468,29 +502,64 @@ private:
     /// slots in Simbody's Y vector.
     /// It's fine for the size of `states` to be less than the size of Y; only
     /// the first states.size1() values are copied.
+    /// Each MocoProblemRep's states retain the previous input, so we only
+    /// write the time, coordinates, speeds, or auxiliary states if they
+    /// differ from those already in `simtkState`. Simbody then invalidates
+    /// only the stages that depend on what changed (Position for coordinates,
+    /// Velocity for speeds, Dynamics for auxiliary states), which is typical
+    /// of finite difference perturbations.
+    /// If the problem has parameters, we always invalidate the Time stage,
+    /// since the parameters may alter model properties on which the realized
+    /// state depends. We also start from scratch if the state is not
+    /// realized to Time (e.g., right after initSystem()).
     inline void convertToSimTKState(const double& time,
-            const casadi::DM& states, const Model& model,
+            const CasOC::InputVector& states, const Model& model,
             SimTK::State& simtkState, bool copyAuxStates) const {
-        simtkState.setTime(time);
+        const bool timeChanged =
+                getNumParameters() || simtkState.getTime() != time ||
+                simtkState.getSystemStage() < SimTK::Stage::Time;
+        if (timeChanged) { simtkState.setTime(time); }
         // Assign the generalized coordinates. We know we have NU generalized
         // speeds because we do not yet support quaternions.
+        bool qChanged = false;
+        const auto& q = simtkState.getQ();
         for (int isv = 0; isv < getNumCoordinates(); ++isv) {
-            simtkState.updQ()[m_yIndexMap.at(isv)] = *(states.ptr() + isv);
+            if (q[m_yIndexMap.at(isv)] != *(states.ptr() + isv)) {
+                qChanged = true;
+                break;
+            }
+        }
+        if (qChanged) {
+            auto& simtkQ = simtkState.updQ();
+            for (int isv = 0; isv < getNumCoordinates(); ++isv) {
+                simtkQ[m_yIndexMap.at(isv)] = *(states.ptr() + isv);
+            }
+        }
+        const double* speeds = states.ptr() + getNumCoordinates();
+        const bool uChanged = !std::equal(speeds, speeds + getNumSpeeds(),
+                simtkState.getU().getContiguousScalarData());
+        if (uChanged) {
+            std::copy_n(speeds, getNumSpeeds(),
+                    simtkState.updU().updContiguousScalarData());
         }
-        std::copy_n(states.ptr() + getNumCoordinates(), getNumSpeeds(),
-                simtkState.updY().updContiguousScalarData() +
-                        simtkState.getNQ());
         if (copyAuxStates) {
-            std::copy_n(states.ptr() + getNumCoordinates() + getNumSpeeds(),
-                    getNumAuxiliaryStates(),
-                    simtkState.updY().updContiguousScalarData() +
-                            simtkState.getNQ() + simtkState.getNU());
+            const double* auxStates = speeds + getNumSpeeds();
+            if (!std::equal(auxStates, auxStates + getNumAuxiliaryStates(),
+                        simtkState.getZ().getContiguousScalarData())) {
+                std::copy_n(auxStates, getNumAuxiliaryStates(),
+                        simtkState.updZ().updContiguousScalarData());
+            }
+        }
+        // Prescribed motion depends only on time, but prescribing writes to
+        // the coordinates and speeds, so avoid it if nothing changed.
+        if (timeChanged || qChanged || uChanged) {
+            model.getSystem().prescribe(simtkState);
         }
-        model.getSystem().prescribe(simtkState);
     }
 
-    void convertToSimTKState(const double& time, const casadi::DM& states,
-            const casadi::DM& controls, const Model& model,
+    void convertToSimTKState(const double& time,
+            const CasOC::InputVector& states,
+            const CasOC::InputVector& controls, const Model& model,
             SimTK::State& simtkState, bool copyAuxStates) const {
         convertToSimTKState(time, states, model, simtkState, copyAuxStates);
         model.realizeVelocity(simtkState);
@@ -503,9 +572,11 @@ private:
         model.realizeVelocity(simtkState);
         model.setControls(simtkState, simtkControls);
     }
-    void applyInput(const double& time, const casadi::DM& states,
-            const casadi::DM& controls, const casadi::DM& multipliers,
-            const casadi::DM& derivatives, const casadi::DM& parameters,
+    void applyInput(const double& time, const CasOC::InputVector& states,
+            const CasOC::InputVector& controls,
+            const CasOC::InputVector& multipliers,
+            const CasOC::InputVector& derivatives,
+            const CasOC::InputVector& parameters,
             const std::unique_ptr<const MocoProblemRep>& mocoProblemRep,
             int stateDisConIndex = 0) const {
         // Original model and its associated state. These are used to calculate
@@ -522,9 +593,17 @@ private:
 
         // Update the model and state.
         applyParametersToModelProperties(parameters, *mocoProblemRep);
-        modelBase.getSystem().prescribe(simtkStateBase);
-        modelDisabledConstraints.getSystem().prescribe(
-                simtkStateDisabledConstraints);
+        // The discrete variables set below require the Time stage. We avoid
+        // prescribing otherwise, as prescribing invalidates the Position
+        // stage (see convertToSimTKState()).
+        if (simtkStateBase.getSystemStage() < SimTK::Stage::Time) {
+            modelBase.getSystem().prescribe(simtkStateBase);
+        }
+        if (simtkStateDisabledConstraints.getSystemStage() <
+                SimTK::Stage::Time) {
+            modelDisabledConstraints.getSystem().prescribe(
+                    simtkStateDisabledConstraints);
+        }
 
         if (getNumAccelerations()) {
             auto& accel = mocoProblemRep->getAccelerationMotion();
@@ -559,7 +638,7 @@ private:
         }
     }
 
-    void calcKinematicConstraintForces(const casadi::DM& multipliers,
+    void calcKinematicConstraintForces(const CasOC::InputVector& multipliers,
             const SimTK::State& stateBase, const Model& modelBase,
             const DiscreteForces& constraintForces,
             SimTK::State& stateDisabledConstraints) const {
@@ -583,12 +662,16 @@ private:
     void calcKinematicConstraintErrors(const Model& modelBase,
             const SimTK::State& stateBase,
             const SimTK::State& simtkStateDisabledConstraints,
-            casadi::DM& kinematic_constraint_errors) const {
+            CasOC::OutputVector kinematic_constraint_errors) const {
 
         // If all kinematics are prescribed, we assume that the prescribed
         // kinematics obey any kinematic constraints. Therefore, the kinematic
         // constraints would be redundant, and we need not enforce them.
-        if (isPrescribedKinematics()) return;
+        if (isPrescribedKinematics()) {
+            std::fill_n(kinematic_constraint_errors.ptr(),
+                    kinematic_constraint_errors.numel(), 0.0);
+            return;
+        }
 
         // The total number of scalar holonomic, non-holonomic, and acceleration
         // constraint equations enabled in the model. This does not count
@@ -651,20 +734,24 @@ private:
     }
 
     void copyImplicitResidualsToOutput(const MocoProblemRep& mocoProblemRep,
-            const SimTK::State& state, casadi::DM& auxiliary_residuals) const {
+            const SimTK::State& state,
+            CasOC::OutputVector auxiliary_residuals) const {
         if (getNumAuxiliaryResidualEquations()) {
             const auto& residualOutputs =
                     mocoProblemRep.getImplicitResidualReferencePtrs();
-            SimTK::Vector auxResiduals((int)residualOutputs.size(), 0.0);
             for (int i = 0; i < (int)residualOutputs.size(); ++i) {
-                auxResiduals[i] = residualOutputs[i]->getValue(state);
+                auxiliary_residuals[i] = residualOutputs[i]->getValue(state);
             }
-            std::copy_n(auxResiduals.getContiguousScalarData(),
-                    auxResiduals.size(), auxiliary_residuals.ptr());
         }
     }
 
     std::unique_ptr<ThreadsafeJar<const MocoProblemRep>> m_jar;
+    struct HeldRep {
+        const MocoCasOCProblem* owner = nullptr;
+        std::unique_ptr<const MocoProblemRep> rep;
+    };
+    // The MocoProblemRep held by this thread during repeated evaluations.
+    static thread_local HeldRep m_heldRep;
     bool m_paramsRequireInitSystem = true;
     std::string m_formattedTimeString;
     std::unordered_map<int, int> m_yIndexMap;
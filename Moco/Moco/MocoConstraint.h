@@ -18,6 +18,7 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 
+#include "MocoAlgebraicForm.h"
 #include "MocoBounds.h"
 #include "MocoUtilities.h"
 #include "MocoConstraintInfo.h"
@@ -187,6 +188,16 @@ public:
         calcPathConstraintErrorsImpl(state, theseErrors);
     }
 
+    /// For use by solvers. If the constraint errors depend on the states,
+    /// controls, and time only through simple algebraic expressions, this
+    /// fills `form` with one output per equation and returns true; otherwise,
+    /// this returns false and solvers must use calcPathConstraintErrors().
+    /// @precondition This constraint must be initialized.
+    bool getAlgebraicForm(MocoAlgebraicForm& form) const {
+        form = MocoAlgebraicForm();
+        return getAlgebraicFormImpl(form);
+    }
+
     /// For use by solvers. This also performs error checks on the Problem.
     void initializeOnModel(const Model& model, const MocoProblemInfo&,
             const int& pathConstraintIndex) const;
@@ -222,6 +233,11 @@ protected:
     /// @endcode
     virtual void calcPathConstraintErrorsImpl(
             const SimTK::State& state, SimTK::Vector& errors) const = 0;
+    /// Override this function if the constraint can be described with a
+    /// MocoAlgebraicForm (see getAlgebraicForm()).
+    virtual bool getAlgebraicFormImpl(MocoAlgebraicForm&) const {
+        return false;
+    }
     /// For use within virtual function implementations.
     const Model& getModel() const {
         OPENSIM_THROW_IF(!m_model, Exception,
@@ -20,6 +20,7 @@
 
 #include "MocoProblemInfo.h"
 
+#include <OpenSim/Common/Constant.h>
 #include <OpenSim/Common/GCVSpline.h>
 
 using namespace OpenSim;
@@ -147,3 +148,38 @@ void MocoControlBoundConstraint::calcPathConstraintErrorsImpl(
         }
     }
 }
+
+bool MocoControlBoundConstraint::getAlgebraicFormImpl(
+        MocoAlgebraicForm& form) const {
+    // Only constant bounds can be expressed without evaluating the bound
+    // functions.
+    const Constant* lower = nullptr;
+    const Constant* upper = nullptr;
+    if (m_hasLower) {
+        lower = dynamic_cast<const Constant*>(&get_lower_bound());
+        if (!lower) { return false; }
+    }
+    if (m_hasUpper) {
+        upper = dynamic_cast<const Constant*>(&get_upper_bound());
+        if (!upper) { return false; }
+    }
+    using Variable = MocoAlgebraicTerm::Variable;
+    const SimTK::Vector time(1, 0.0);
+    for (const auto& controlIndex : m_controlIndices) {
+        // The order of the equations matches calcPathConstraintErrorsImpl().
+        if (lower) {
+            form.outputs.push_back(
+                    {MocoAlgebraicTerm(Variable::Control, controlIndex, 1),
+                            MocoAlgebraicTerm(Variable::Constant, 0,
+                                    -lower->calcValue(time))});
+        }
+        if (upper) {
+            form.outputs.push_back(
+                    {MocoAlgebraicTerm(Variable::Control, controlIndex, 1),
+                            MocoAlgebraicTerm(Variable::Constant, 0,
+                                    -upper->calcValue(time))});
+        }
+    }
+    return true;
+}
+
@@ -90,6 +90,7 @@ protected:
 
     void calcPathConstraintErrorsImpl(
             const SimTK::State& state, SimTK::Vector& errors) const override;
+    bool getAlgebraicFormImpl(MocoAlgebraicForm& form) const override;
 
 private:
     OpenSim_DECLARE_LIST_PROPERTY(control_paths, std::string,
@@ -18,6 +18,8 @@
 
 #include "MocoDirectCollocationSolver.h"
 
+#include "MocoUtilities.h"
+
 using namespace OpenSim;
 
 void MocoDirectCollocationSolver::constructProperties() {
@@ -40,6 +42,23 @@ void MocoDirectCollocationSolver::constructProperties() {
     constructProperty_implicit_auxiliary_derivative_bounds({-1000, 1000});
     constructProperty_minimize_lagrange_multipliers(false);
     constructProperty_lagrange_multiplier_weight(1.0);
+    constructProperty_scale_variables_and_constraints(false);
+    constructProperty_variable_scales(MocoWeightSet());
+}
+
+std::map<std::string, double>
+MocoDirectCollocationSolver::createVariableScalesMap() const {
+    std::map<std::string, double> scales;
+    const auto& scaleSet = get_variable_scales();
+    for (int i = 0; i < scaleSet.getSize(); ++i) {
+        const auto& scale = scaleSet.get(i);
+        OPENSIM_THROW_IF_FRMOBJ(scale.getWeight() <= 0, Exception,
+                format("Expected the scale for variable '%s' to be positive, "
+                       "but got %g.",
+                        scale.getName(), scale.getWeight()));
+        scales[scale.getName()] = scale.getWeight();
+    }
+    return scales;
 }
 
 void MocoDirectCollocationSolver::setMesh(const std::vector<double>& mesh) {
@@ -19,6 +19,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "MocoSolver.h"
+#include "MocoWeightSet.h"
 
 #include <OpenSim/Common/Object.h>
 
@@ -151,6 +152,19 @@ public:
     OpenSim_DECLARE_PROPERTY(implicit_auxiliary_derivative_bounds, MocoBounds,
             "Bounds on derivative variables for components with auxiliary "
             "dynamics in implicit form. Default: [-1000, 1000]");
+    OpenSim_DECLARE_PROPERTY(scale_variables_and_constraints, bool,
+            "Scale the optimization variables by the range of their bounds "
+            "(or, for variables with infinite bounds, by their largest "
+            "magnitude in the initial guess), and scale the defect "
+            "constraints by the scales of the corresponding states. This can "
+            "improve the conditioning of problems whose variables have very "
+            "different magnitudes (e.g., forces and activations). The "
+            "solution is unscaled. Default: false.");
+    OpenSim_DECLARE_PROPERTY(variable_scales, MocoWeightSet,
+            "Override the scales computed for "
+            "'scale_variables_and_constraints' for individual variables; the "
+            "names are state, control, multiplier, derivative, or parameter "
+            "names, or 'initial_time' or 'final_time'.");
 
     MocoDirectCollocationSolver() { constructProperties(); }
 
@@ -167,6 +181,9 @@ protected:
             "Usually non-uniform, user-defined list of mesh points to sample. "
             "Takes precedence over uniform mesh with num_mesh_intervals.");
     void constructProperties();
+    /// Create a map from variable name to scale from the 'variable_scales'
+    /// property.
+    std::map<std::string, double> createVariableScalesMap() const;
 };
 
 } // namespace OpenSim
@@ -17,6 +17,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "MocoContactTrackingGoal.h"
+#include "../Components/StationPlaneContactForce.h"
 #include "OpenSim/Simulation/Model/SmoothSphereHalfSpaceForce.h"
 
 using namespace OpenSim;
@@ -123,6 +124,15 @@ void MocoContactTrackingGoal::initializeOnModelImpl(const Model& model) const {
         for (int ic = 0; ic < group.getProperty_contact_force_paths().size();
                 ++ic) {
             const auto& path = group.get_contact_force_paths(ic);
+            if (model.hasComponent<StationPlaneContactForce>(path)) {
+                const auto& contactForce =
+                        model.getComponent<StationPlaneContactForce>(path);
+                double sign = findStationForceSign(group, contactForce,
+                        extForce.get_applied_to_body());
+                groupInfo.stationContacts.push_back(
+                        std::make_pair(&contactForce, sign));
+                continue;
+            }
             const auto& contactForce =
                     model.getComponent<SmoothSphereHalfSpaceForce>(path);
 
@@ -241,6 +251,41 @@ int MocoContactTrackingGoal::findRecordOffset(
                     group.get_external_force_name()));
 }
 
+double MocoContactTrackingGoal::findStationForceSign(
+        const MocoContactTrackingGoalGroup& group,
+        const StationPlaneContactForce& contactForce,
+        const std::string& appliedToBody) const {
+
+    // Is the ExternalForce applied to the station's body?
+    const auto& stationBase = contactForce.getConnectee<Station>("station")
+                                      .getParentFrame()
+                                      .findBaseFrame();
+    const std::string& stationBaseName = stationBase.getName();
+    if (stationBaseName == appliedToBody) { return 1.0; }
+
+    // Is the ExternalForce applied to ground (the plane)?
+    const auto& ground = contactForce.getModel().getGround();
+    if (ground.getName() == appliedToBody) { return -1.0; }
+
+    // Check the group's alternative frames.
+    const auto& stationBasePath = stationBase.getAbsolutePathString();
+    const auto& groundPath = ground.getAbsolutePathString();
+    for (int ia = 0; ia < group.getProperty_alternative_frame_paths().size();
+            ++ia) {
+        const auto& path = group.get_alternative_frame_paths(ia);
+        if (path == stationBasePath) { return 1.0; }
+        if (path == groundPath) { return -1.0; }
+    }
+
+    OPENSIM_THROW_FRMOBJ(Exception,
+            format("Contact force '%s' has station base frame '%s'. This "
+                   "frame or ground should match the applied_to_body "
+                   "setting ('%s') of ExternalForce '%s', or match one of "
+                   "the alternative_frame_paths, but no match found.",
+                    contactForce.getAbsolutePathString(), stationBaseName,
+                    appliedToBody, group.get_external_force_name()));
+}
+
 void MocoContactTrackingGoal::calcIntegrandImpl(
         const SimTK::State& state, double& integrand) const {
     const auto& time = state.getTime();
@@ -260,6 +305,10 @@ void MocoContactTrackingGoal::calcIntegrandImpl(
                 force_model[im] += recordValues[recordOffset + im];
             }
         }
+        for (const auto& entry : group.stationContacts) {
+            force_model += entry.second *
+                           entry.first->getContactForceOnStation(state);
+        }
 
         // Reference force.
         for (int ir = 0; ir < force_ref.size(); ++ir) {
@@ -24,6 +24,7 @@
 namespace OpenSim {
 
 class SmoothSphereHalfSpaceForce;
+class StationPlaneContactForce;
 
 /// A contact group is a single ExternalForce and a list of contact force
 /// components in the model whose forces are summed and compared to the
@@ -50,8 +51,9 @@ class OSIMMOCO_API MocoContactTrackingGoalGroup : public Object {
     OpenSim_DECLARE_CONCRETE_OBJECT(MocoContactTrackingGoalGroup, Object);
 public:
     OpenSim_DECLARE_LIST_PROPERTY(contact_force_paths, std::string,
-            "Paths to SmoothSphereHalfSpaceForce objects in the model whose "
-            "forces are summed and compared to an single ExternalForce.");
+            "Paths to SmoothSphereHalfSpaceForce or StationPlaneContactForce "
+            "objects in the model whose forces are summed and compared to an "
+            "single ExternalForce.");
     OpenSim_DECLARE_PROPERTY(external_force_name, std::string,
             "The name of an ExternalForce object in the ExternalLoads set.");
     OpenSim_DECLARE_LIST_PROPERTY(alternative_frame_paths, std::string,
@@ -78,7 +80,11 @@ private:
 /// experimental external loads file. Tracking ground reaction forces for the
 /// left and right feet in gait requires only one instance of this goal.
 ///
-/// @note The only contact element supported is SmoothSphereHalfSpaceForce.
+/// @note The supported contact elements are SmoothSphereHalfSpaceForce and
+/// StationPlaneContactForce. The forces of StationPlaneContactForce%s are read
+/// from the force cached in the state (see
+/// StationPlaneContactForce::getContactForceOnStation()), so they are not
+/// recomputed if the model has already computed them.
 ///
 /// @note This goal does not include torques or centers of pressure.
 ///
@@ -249,6 +255,13 @@ private:
             const SmoothSphereHalfSpaceForce& contactForce,
             const std::string& appliedToBody) const;
 
+    /// For a given StationPlaneContactForce, find whether to use the force on
+    /// the station (1) or the force on ground (-1).
+    double findStationForceSign(
+            const MocoContactTrackingGoalGroup& group,
+            const StationPlaneContactForce& contactForce,
+            const std::string& appliedToBody) const;
+
     enum class ProjectionType {
         None,
         Vector,
@@ -260,10 +273,13 @@ private:
 
     /// Each contact group includes a list of contact force components (with an
     /// int that keeps track of whether we want to use the force applied to the
-    /// sphere or to the half space) and a spline representation of associated
-    /// experimental data.
+    /// sphere or to the half space), a list of station contact forces (with
+    /// the sign of the force to use), and a spline representation of
+    /// associated experimental data.
     struct GroupInfo {
         std::vector<std::pair<const SmoothSphereHalfSpaceForce*, int>> contacts;
+        std::vector<std::pair<const StationPlaneContactForce*, double>>
+                stationContacts;
         GCVSplineSet refSplines;
         const PhysicalFrame* refExpressedInFrame = nullptr;
     };
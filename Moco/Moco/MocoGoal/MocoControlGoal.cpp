@@ -138,6 +138,19 @@ void MocoControlGoal::calcGoalImpl(
     }
 }
 
+bool MocoControlGoal::getAlgebraicFormImpl(MocoAlgebraicForm& form) const {
+    // The displacement of the system requires realizing the model.
+    if (get_divide_by_displacement()) { return false; }
+    for (int i = 0; i < (int)m_controlIndices.size(); ++i) {
+        form.integrand.emplace_back(MocoAlgebraicTerm::Variable::Control,
+                m_controlIndices[i], m_weights[i]);
+    }
+    form.integrandExponent = get_exponent();
+    form.outputs.push_back(
+            {MocoAlgebraicTerm(MocoAlgebraicTerm::Variable::Integral, 0, 1.0)});
+    return true;
+}
+
 void MocoControlGoal::printDescriptionImpl(std::ostream& stream) const {
     for (int i = 0; i < (int) m_controlNames.size(); i++) {
         stream << "        ";
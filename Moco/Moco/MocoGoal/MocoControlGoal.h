@@ -99,6 +99,7 @@ protected:
             const SimTK::State& state, double& integrand) const override;
     void calcGoalImpl(
             const GoalInput& input, SimTK::Vector& cost) const override;
+    bool getAlgebraicFormImpl(MocoAlgebraicForm& form) const override;
     void printDescriptionImpl(std::ostream& stream = std::cout) const override;
 
 private:
@@ -149,6 +149,19 @@ public:
         calcGoalImpl(input, goal);
         goal *= m_weightToUse;
     }
+    /// For use by solvers. If this goal depends on the phase's states,
+    /// controls, and time only through simple algebraic expressions, this
+    /// fills `form` with a description of the goal and returns true;
+    /// otherwise, this returns false and solvers must use calcIntegrand() and
+    /// calcGoal(). The weight is included in `form.scale`.
+    /// @precondition This goal must be initialized.
+    bool getAlgebraicForm(MocoAlgebraicForm& form) const {
+        form = MocoAlgebraicForm();
+        if (!get_enabled()) { return false; }
+        if (!getAlgebraicFormImpl(form)) { return false; }
+        form.scale *= m_weightToUse;
+        return true;
+    }
     /// For use by solvers. This also performs error checks on the Problem.
     void initializeOnModel(const Model& model) const {
         m_model.reset(&model);
@@ -222,6 +235,12 @@ protected:
     /// The Lagrange multipliers for kinematic constraints are not available.
     virtual void calcGoalImpl(
             const GoalInput& input, SimTK::Vector& goal) const = 0;
+    /// Override this function if the goal can be described with a
+    /// MocoAlgebraicForm (see getAlgebraicForm()). The form must be equivalent
+    /// to calcIntegrandImpl() and calcGoalImpl(); do not include the weight.
+    virtual bool getAlgebraicFormImpl(MocoAlgebraicForm&) const {
+        return false;
+    }
     /// Print a more detailed description unique to each goal.
     virtual void printDescriptionImpl(
             std::ostream& stream = std::cout) const {};
@@ -286,6 +305,11 @@ protected:
             const GoalInput& input, SimTK::Vector& cost) const override {
         cost[0] = input.final_state.getTime();
     }
+    bool getAlgebraicFormImpl(MocoAlgebraicForm& form) const override {
+        form.outputs.push_back({MocoAlgebraicTerm(
+                MocoAlgebraicTerm::Variable::Time, 0, 1.0, true)});
+        return true;
+    }
 };
 
 /// This goal requires the average speed of the system to match a desired
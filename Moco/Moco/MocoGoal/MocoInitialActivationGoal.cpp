@@ -56,3 +56,16 @@ void MocoInitialActivationGoal::calcGoalImpl(
         }
     }
 }
+
+bool MocoInitialActivationGoal::getAlgebraicFormImpl(
+        MocoAlgebraicForm& form) const {
+    using Variable = MocoAlgebraicTerm::Variable;
+    for (const auto& indices : m_indices) {
+        form.outputs.push_back(
+                {MocoAlgebraicTerm(Variable::Control, indices.first, 1),
+                        MocoAlgebraicTerm(
+                                Variable::State, indices.second, -1)});
+    }
+    form.squareOutputs = getModeIsCost();
+    return true;
+}
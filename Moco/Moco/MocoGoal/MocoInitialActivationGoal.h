@@ -44,6 +44,7 @@ protected:
         return Mode::EndpointConstraint;
     }
     void initializeOnModelImpl(const Model&) const override;
+    bool getAlgebraicFormImpl(MocoAlgebraicForm& form) const override;
     void calcGoalImpl(
             const GoalInput& input, SimTK::Vector& goal) const override;
 
@@ -76,9 +76,10 @@ void MocoMarkerTrackingGoal::initializeOnModelImpl(const Model& model) const {
 
     // Get and flatten TimeSeriesTableVec3 to doubles and create a set of
     // reference splines, one for each component of the coordinate
-    // trajectories.
-    m_refsplines =
-            GCVSplineSet(get_markers_reference().getMarkerTable().flatten());
+    // trajectories. The splines are shared with copies of this goal (e.g., in
+    // other MocoProblemReps) that use the same reference.
+    m_refsplines = createSharedGCVSplineSet(
+            get_markers_reference().getMarkerTable().flatten());
 
     setNumIntegralsAndOutputs(1, 1);
 }
@@ -96,9 +97,10 @@ void MocoMarkerTrackingGoal::initializeOnModelImpl(const Model& model) const {
         // Get the markers reference index corresponding to the current
         // model marker and get the reference value.
         int refidx = m_refindices[i];
-        refValue[0] = m_refsplines[3 * refidx].calcValue(timeVec);
-        refValue[1] = m_refsplines[3 * refidx + 1].calcValue(timeVec);
-        refValue[2] = m_refsplines[3 * refidx + 2].calcValue(timeVec);
+        const auto& refsplines = *m_refsplines;
+        refValue[0] = refsplines[3 * refidx].calcValue(timeVec);
+        refValue[1] = refsplines[3 * refidx + 1].calcValue(timeVec);
+        refValue[2] = refsplines[3 * refidx + 2].calcValue(timeVec);
 
         double distance = (modelValue - refValue).normSqr();
 
@@ -91,7 +91,7 @@ protected:
             "Allow markers_reference to contain marker data for a marker "
             "not in the model (such data would be ignored). Default: false.");
 
-    mutable GCVSplineSet m_refsplines;
+    mutable std::shared_ptr<const GCVSplineSet> m_refsplines;
     mutable std::vector<SimTK::ReferencePtr<const Marker>> m_model_markers;
     mutable std::vector<int> m_refindices;
     mutable SimTK::Array_<double> m_marker_weights;
@@ -123,6 +123,24 @@ void MocoPeriodicityGoal::calcGoalImpl(
     }
 }
 
+bool MocoPeriodicityGoal::getAlgebraicFormImpl(
+        MocoAlgebraicForm& form) const {
+    using Variable = MocoAlgebraicTerm::Variable;
+    auto addPairs = [&form](const std::vector<std::tuple<int, int, int>>& pairs,
+                            Variable variable) {
+        for (const auto& pair : pairs) {
+            form.outputs.push_back({MocoAlgebraicTerm(variable,
+                                            std::get<0>(pair),
+                                            std::get<2>(pair), false),
+                    MocoAlgebraicTerm(variable, std::get<1>(pair), -1, true)});
+        }
+    };
+    addPairs(m_indices_states, Variable::State);
+    addPairs(m_indices_controls, Variable::Control);
+    form.squareOutputs = getModeIsCost();
+    return true;
+}
+
 void MocoPeriodicityGoal::printDescriptionImpl(std::ostream& stream) const {
     stream << "        ";
     stream << "state periodicity pairs: " << std::endl;
@@ -128,6 +128,7 @@ protected:
     void initializeOnModelImpl(const Model& model) const override;
     void calcGoalImpl(
             const GoalInput& input, SimTK::Vector& goal) const override;
+    bool getAlgebraicFormImpl(MocoAlgebraicForm& form) const override;
     void printDescriptionImpl(std::ostream& stream = std::cout) const override;
 
 private:
@@ -29,7 +29,10 @@ void MocoStateTrackingGoal::initializeOnModelImpl(const Model& model) const {
     // TODO: set relativeToDirectory properly.
     TimeSeriesTable tableToUse = get_reference().process("", &model);
 
-    auto allSplines = GCVSplineSet(tableToUse);
+    // The splines are shared with copies of this goal (e.g., in other
+    // MocoProblemReps) that use the same reference.
+    m_refsplines = createSharedGCVSplineSet(tableToUse);
+    const auto& allSplines = *m_refsplines;
 
     // Check that there are no redundant columns in the reference data.
     checkRedundantLabels(tableToUse.getColumnLabels());
@@ -93,7 +96,7 @@ void MocoStateTrackingGoal::initializeOnModelImpl(const Model& model) const {
             refWeight *= 1.0 / refRange;
         }
         m_state_weights.push_back(refWeight);
-        m_refsplines.cloneAndAppend(allSplines[iref]);
+        m_refindices.push_back(iref);
         m_state_names.push_back(refName);
     }
 
@@ -109,9 +112,10 @@ void MocoStateTrackingGoal::calcIntegrandImpl(/*int meshIndex,*/
     // TODO cache the reference coordinate values at the mesh points, rather
     // than evaluating the spline.
     integrand = 0;
-    for (int iref = 0; iref < m_refsplines.getSize(); ++iref) {
+    for (int iref = 0; iref < (int)m_refindices.size(); ++iref) {
         const auto& modelValue = state.getY()[m_sysYIndices[iref]];
-        const auto& refValue = m_refsplines[iref].calcValue(timeVec);
+        const auto& refValue =
+                (*m_refsplines)[m_refindices[iref]].calcValue(timeVec);
         integrand += m_state_weights[iref] * pow(modelValue - refValue, 2);
     }
 }
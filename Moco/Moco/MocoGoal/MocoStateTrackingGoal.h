@@ -157,7 +157,11 @@ private:
         constructProperty_scale_weights_with_range(false);
     }
 
-    mutable GCVSplineSet m_refsplines;
+    /// Splines for all columns of the reference, shared across copies of
+    /// this goal that use the same reference.
+    mutable std::shared_ptr<const GCVSplineSet> m_refsplines;
+    /// The indices in m_refsplines of the tracked references.
+    mutable std::vector<int> m_refindices;
     /// The indices in Y corresponding to the provided reference coordinates.
     mutable std::vector<int> m_sysYIndices;
     mutable std::vector<double> m_state_weights;
@@ -99,6 +99,18 @@ void MocoSumSquaredStateGoal::calcIntegrandImpl(
     }
 }
 
+bool MocoSumSquaredStateGoal::getAlgebraicFormImpl(
+        MocoAlgebraicForm& form) const {
+    for (int i = 0; i < (int)m_state_weights.size(); ++i) {
+        form.integrand.emplace_back(MocoAlgebraicTerm::Variable::State,
+                m_sysYIndices[i], m_state_weights[i]);
+    }
+    form.integrandExponent = 2;
+    form.outputs.push_back(
+            {MocoAlgebraicTerm(MocoAlgebraicTerm::Variable::Integral, 0, 1.0)});
+    return true;
+}
+
 void MocoSumSquaredStateGoal::printDescriptionImpl(std::ostream& stream) const {
     for (int i = 0; i < (int)m_state_names.size(); i++) {
         stream << "        ";
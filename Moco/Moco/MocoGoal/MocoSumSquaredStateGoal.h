@@ -92,6 +92,7 @@ protected:
             const GoalInput& input, SimTK::Vector& cost) const override {
         cost[0] = input.integral;
     }
+    bool getAlgebraicFormImpl(MocoAlgebraicForm& form) const override;
     void printDescriptionImpl(std::ostream& stream = std::cout) const override;
 
 private:
@@ -23,11 +23,22 @@
 #include "Components/PositionMotion.h"
 #include "MocoProblem.h"
 #include "MocoProblemInfo.h"
+#include <mutex>
 #include <regex>
 #include <unordered_set>
 
 using namespace OpenSim;
 
+namespace {
+// Processing the model and initializing parameters, goals, and path
+// constraints may read files (e.g., a goal's TableProcessor) and create
+// Objects through OpenSim's global type registry, which is not threadsafe.
+// MocoProblemReps may be created concurrently (see
+// MocoSolver::createProblemRepJar()), so these steps are serialized; only
+// initSystem() runs concurrently.
+std::mutex initializationMutex;
+} // anonymous namespace
+
 MocoProblemRep::MocoProblemRep(const MocoProblem& problem)
         : m_problem(&problem) {
     initialize();
@@ -61,7 +72,10 @@ void MocoProblemRep::initialize() {
 
     const auto& ph0 = m_problem->getPhase(0);
     // TODO: Provide directory from which to load model file.
-    m_model_base = ph0.getModelProcessor().process();
+    {
+        std::lock_guard<std::mutex> lock(initializationMutex);
+        m_model_base = ph0.getModelProcessor().process();
+    }
     m_model_base.finalizeFromProperties();
     int countMotion = 0;
     for (const auto& comp : m_model_base.getComponentList<PositionMotion>()) {
@@ -449,6 +463,8 @@ void MocoProblemRep::initialize() {
         }
     }
 
+    // The lock is held until the end of this function.
+    std::lock_guard<std::mutex> lock(initializationMutex);
 
     // Parameters.
     // -----------
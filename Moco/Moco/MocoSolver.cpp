@@ -18,6 +18,7 @@
 #include "MocoSolver.h"
 
 #include "MocoProblem.h"
+#include "MocoUtilities.h"
 
 #include <OpenSim/Simulation/Manager/Manager.h>
 
@@ -88,20 +89,77 @@ MocoSolution MocoSolver::solve() const {
 void MocoSolver::setSolutionStats(MocoSolution& sol, bool success,
         double objective,
         const std::string& status, int numIterations, double duration,
-        std::vector<std::pair<std::string, double>> objectiveBreakdown) {
+        std::vector<std::pair<std::string, double>> objectiveBreakdown,
+        int numThreads,
+        std::vector<std::pair<std::string, int>> numFunctionEvaluations) {
     sol.setSuccess(success);
     sol.setObjective(objective);
     sol.setStatus(status);
     sol.setNumIterations(numIterations);
     sol.setSolverDuration(duration);
     sol.setObjectiveBreakdown(std::move(objectiveBreakdown));
+    sol.setNumThreads(numThreads);
+    sol.setNumFunctionEvaluations(std::move(numFunctionEvaluations));
+}
+
+MocoSolution MocoSolver::createSolutionFromFile(const std::string& filepath) {
+    MocoSolution solution(filepath);
+    // MocoTrajectory does not retain the header, so read it separately.
+    const TimeSeriesTable table(filepath);
+    const auto& metadata = table.getTableMetaData();
+    auto getString = [&](const std::string& key) {
+        OPENSIM_THROW_IF(!metadata.hasKey(key), Exception,
+                format("Expected the header of '%s' to contain '%s'.",
+                        filepath, key));
+        return metadata.getValueForKey(key).getValue<std::string>();
+    };
+    double objective;
+    SimTK::convertStringTo(getString("objective"), objective);
+    int numIterations;
+    SimTK::convertStringTo(getString("num_iterations"), numIterations);
+    double duration;
+    SimTK::convertStringTo(getString("solver_duration"), duration);
+    int numThreads = -1;
+    if (metadata.hasKey("num_threads")) {
+        SimTK::convertStringTo(getString("num_threads"), numThreads);
+    }
+    std::vector<std::pair<std::string, double>> breakdown;
+    std::vector<std::pair<std::string, int>> numEvaluations;
+    const std::string objectivePrefix = "objective_";
+    const std::string evaluationsPrefix = "num_evaluations_";
+    for (const auto& key : metadata.getKeys()) {
+        if (startsWith(key, objectivePrefix)) {
+            double value;
+            SimTK::convertStringTo(getString(key), value);
+            breakdown.emplace_back(key.substr(objectivePrefix.size()), value);
+        } else if (startsWith(key, evaluationsPrefix)) {
+            int value;
+            SimTK::convertStringTo(getString(key), value);
+            numEvaluations.emplace_back(
+                    key.substr(evaluationsPrefix.size()), value);
+        }
+    }
+    setSolutionStats(solution, getString("success") == "true", objective,
+            getString("status"), numIterations, duration, std::move(breakdown),
+            numThreads, std::move(numEvaluations));
+    return solution;
 }
 
 std::unique_ptr<ThreadsafeJar<const MocoProblemRep>>
         MocoSolver::createProblemRepJar(int size) const {
     auto jar = OpenSim::make_unique<ThreadsafeJar<const MocoProblemRep>>();
-    for (int i = 0; i < size; ++i) {
-        jar->leave(std::unique_ptr<MocoProblemRep>(m_problem->createRepHeap()));
-    }
+    if (size < 1) return jar;
+
+    // Create the first rep on this thread so that errors in the problem are
+    // reported once and so that data shared between reps (e.g., reference
+    // splines) is created before the remaining reps are created.
+    jar->leave(std::unique_ptr<MocoProblemRep>(m_problem->createRepHeap()));
+
+    // Create the remaining reps concurrently; each thread runs initSystem()
+    // on its own models.
+    parallelForBlocks(size - 1, size - 1, [&](int, int, int) {
+        jar->leave(std::unique_ptr<MocoProblemRep>(
+                m_problem->createRepHeap()));
+    });
     return jar;
 }
@@ -99,8 +99,17 @@ protected:
             const std::string& status, int numIterations,
             double duration,
             std::vector<std::pair<std::string, double>> objectiveBreakdown =
+                    {},
+            int numThreads = -1,
+            std::vector<std::pair<std::string, int>> numFunctionEvaluations =
                     {});
 
+    /// Read a solution written by MocoSolution::write(), including the
+    /// solver statistics (success, status, objective, etc.) in the header.
+    static MocoSolution createSolutionFromFile(const std::string& filepath);
+
+    const MocoProblem& getProblem() const { return m_problem.getRef(); }
+
     const MocoProblemRep& getProblemRep() const {
         return m_problemRep;
     }
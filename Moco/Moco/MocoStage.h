@@ -0,0 +1,71 @@
+#ifndef MOCO_MOCOSTAGE_H
+#define MOCO_MOCOSTAGE_H
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: MocoStage.h                                                  *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ModelProcessor.h"
+
+namespace OpenSim {
+
+/// A cheaper variant of a MocoStudy's problem, solved before the study's
+/// problem to provide it with a guess (see MocoStudy's `stages` property).
+/// The stage's model is the problem's model with the stage's
+/// `model_operators` applied after the operators already in the problem's
+/// ModelProcessor. For example, the following stages first solve with rigid
+/// tendons and no activation dynamics on a coarse mesh, then with rigid
+/// tendons, and finally (as the study's problem) with compliant tendons:
+/// @code
+/// MocoStage rigid;
+/// rigid.append_model_operators(ModOpIgnoreTendonCompliance());
+/// MocoStage excitations(rigid);
+/// excitations.append_model_operators(ModOpIgnoreActivationDynamics());
+/// excitations.set_num_mesh_intervals(10);
+/// study.append_stages(excitations);
+/// study.append_stages(rigid);
+/// @endcode
+/// Stages should only remove variables from the problem (e.g., states and
+/// controls); operators that add variables (e.g., ModOpAddReserves) should be
+/// applied to all stages by including them in the problem's ModelProcessor.
+class OSIMMOCO_API MocoStage : public Object {
+    OpenSim_DECLARE_CONCRETE_OBJECT(MocoStage, Object);
+
+public:
+    OpenSim_DECLARE_LIST_PROPERTY(model_operators, ModelOperator,
+            "Operators to apply to the problem's model for this stage, after "
+            "the operators in the problem's ModelProcessor.");
+    OpenSim_DECLARE_PROPERTY(num_mesh_intervals, int,
+            "The number of mesh intervals for this stage (default: -1, which "
+            "means to use the solver's setting).");
+    OpenSim_DECLARE_PROPERTY(optim_convergence_tolerance, double,
+            "The convergence tolerance for this stage (default: -1, which "
+            "means to use the solver's setting).");
+    OpenSim_DECLARE_PROPERTY(optim_constraint_tolerance, double,
+            "The constraint tolerance for this stage (default: -1, which "
+            "means to use the solver's setting).");
+
+    MocoStage() {
+        constructProperty_model_operators();
+        constructProperty_num_mesh_intervals(-1);
+        constructProperty_optim_convergence_tolerance(-1);
+        constructProperty_optim_constraint_tolerance(-1);
+    }
+};
+
+} // namespace OpenSim
+
+#endif // MOCO_MOCOSTAGE_H
@@ -17,12 +17,19 @@
  * -------------------------------------------------------------------------- */
 #include "MocoStudy.h"
 
+#include "About.h"
 #include "Components/PositionMotion.h"
 #include "MocoCasADiSolver/MocoCasADiSolver.h"
 #include "MocoProblem.h"
 #include "MocoTropterSolver.h"
 #include "MocoUtilities.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <regex>
+#include <sstream>
+#include <thread>
 
 #include <OpenSim/Common/IO.h>
 #include <OpenSim/Common/Reporter.h>
@@ -39,6 +46,7 @@ MocoStudy::MocoStudy(const std::string& omocoFile) : Object(omocoFile) {
 
 void MocoStudy::constructProperties() {
     constructProperty_write_solution("./");
+    constructProperty_stages();
     constructProperty_problem(MocoProblem());
     constructProperty_solver(MocoCasADiSolver());
 }
@@ -76,22 +84,100 @@ MocoCasADiSolver& MocoStudy::initCasADiSolver() {
 
 MocoSolver& MocoStudy::updSolver() { return updSolver<MocoSolver>(); }
 
+namespace {
+template <typename SolverType>
+void updateFromGuess(const MocoSolver& solver, ContentHasher& hasher) {
+    const auto* derived = dynamic_cast<const SolverType*>(&solver);
+    // A guess_file is handled by ContentHasher::updateFromReferencedData().
+    if (!derived || !derived->get_guess_file().empty()) return;
+    const MocoTrajectory& guess = derived->getGuess();
+    if (!guess.empty()) hasher.update(guess.convertToTable());
+}
+} // anonymous namespace
+
+std::string MocoStudy::calcCacheKey() const {
+    ContentHasher hasher;
+    hasher.update(GetMocoVersion());
+    hasher.updateFromSerialization(get_problem());
+    hasher.updateFromSerialization(get_solver());
+    for (int i = 0; i < getProperty_stages().size(); ++i) {
+        hasher.updateFromSerialization(get_stages(i));
+    }
+    hasher.updateFromReferencedData(get_problem());
+    hasher.updateFromReferencedData(get_solver());
+    updateFromGuess<MocoCasADiSolver>(get_solver(), hasher);
+    updateFromGuess<MocoTropterSolver>(get_solver(), hasher);
+    return hasher.getHexDigest();
+}
+
 MocoSolution MocoStudy::solve() const {
     // TODO avoid const_cast.
     const_cast<Self*>(this)->initSolverInternal();
 
-    // Temporarily disable printing of negative muscle force warnings so the
-    // output stream isn't flooded while computing finite differences.
-    int oldDebugLevel = Object::getDebugLevel();
-    Object::setDebugLevel(-1);
+    const bool verbose = isVerbose(get_solver());
+    std::string cacheFile;
+    if (!m_cacheDir.empty()) {
+        if (hasUnhashedReferenceData(get_problem())) {
+            if (verbose) {
+                std::cout << "Not using the solution cache: a goal holds "
+                             "reference data in memory, which is not part of "
+                             "the cache key."
+                          << std::endl;
+            }
+        } else {
+            cacheFile = m_cacheDir + SimTK::Pathname::getPathSeparator() +
+                        calcCacheKey() + ".sto";
+        }
+    }
+
     MocoSolution solution;
-    try {
-        solution = get_solver().solve();
-    } catch (const Exception&) {
+    if (!cacheFile.empty() && std::ifstream(cacheFile).good()) {
+        solution = MocoSolver::createSolutionFromFile(cacheFile);
+        if (verbose) {
+            std::cout << "Using the cached solution '" << cacheFile << "'."
+                      << std::endl;
+        }
+    } else {
+        // Temporarily disable printing of negative muscle force warnings so
+        // the output stream isn't flooded while computing finite differences.
+        int oldDebugLevel = Object::getDebugLevel();
+        Object::setDebugLevel(-1);
+        try {
+            if (getProperty_stages().empty()) {
+                solution = get_solver().solve();
+            } else {
+                solution = solveStages();
+            }
+        } catch (const Exception&) {
+            Object::setDebugLevel(oldDebugLevel);
+            throw;
+        }
         Object::setDebugLevel(oldDebugLevel);
-        throw;
+
+        // Failed solutions are not cached so that they are retried.
+        if (!cacheFile.empty() && solution.success()) {
+            OpenSim::IO::makeDir(m_cacheDir);
+            // Write to a temporary file and rename it so that concurrent
+            // solves never read a partially-written solution.
+            std::ostringstream tempFile;
+            tempFile << cacheFile << "." << std::this_thread::get_id() << "."
+                     << std::chrono::steady_clock::now()
+                                .time_since_epoch()
+                                .count()
+                     << ".tmp";
+            try {
+                solution.write(tempFile.str());
+                if (std::rename(tempFile.str().c_str(), cacheFile.c_str())) {
+                    std::remove(tempFile.str().c_str());
+                }
+            } catch (const TimestampGreaterThanEqualToNext&) {
+                if (verbose) {
+                    std::cout << "Could not cache solution...skipping."
+                              << std::endl;
+                }
+            }
+        }
     }
-    Object::setDebugLevel(oldDebugLevel);
 
     bool originallySealed = solution.isSealed();
     if (get_write_solution() != "false") {
@@ -112,6 +198,223 @@ MocoSolution MocoStudy::solve() const {
     return solution;
 }
 
+namespace {
+/// Copy the variables that `source` and `guess` have in common from `source`
+/// to `guess`, interpolating at the times in `guess`, and fill in the states
+/// that `source` lacks (see "Solving in stages" in MocoStudy).
+void applyTrajectoryToGuess(const MocoTrajectory& source,
+        const MocoProblem& problem, MocoTrajectory& guess) {
+    if (source.empty() || source.getNumTimes() < 2) return;
+
+    // The guess from createGuess() spans the midpoint of the time bounds
+    // (e.g., for a free final time); use the time span of the source
+    // instead, so the source's values are not extrapolated.
+    if (guess.getInitialTime() != source.getInitialTime() ||
+            guess.getFinalTime() != source.getFinalTime()) {
+        guess.setTime(createVectorLinspace(guess.getNumTimes(),
+                source.getInitialTime(), source.getFinalTime()));
+    }
+    guess.setStatesTrajectory(source.exportToStatesTable(), true, true);
+    TimeSeriesTable controls = source.exportToControlsTable();
+    for (const auto& name : source.getControlNames()) {
+        if (std::find(guess.getControlNames().begin(),
+                    guess.getControlNames().end(),
+                    name) == guess.getControlNames().end()) {
+            controls.removeColumn(name);
+        }
+    }
+    if (controls.getNumColumns()) {
+        guess.insertControlsTrajectory(controls, true);
+    }
+    for (const auto& name : source.getParameterNames()) {
+        if (std::find(guess.getParameterNames().begin(),
+                    guess.getParameterNames().end(),
+                    name) != guess.getParameterNames().end()) {
+            guess.setParameter(name, source.getParameter(name));
+        }
+    }
+
+    // Fill in the states that the source lacks. Muscle activations are
+    // set to the muscle's excitation.
+    const auto& sourceStateNames = source.getStateNames();
+    std::vector<std::string> remaining;
+    for (const auto& name : guess.getStateNames()) {
+        if (std::find(sourceStateNames.begin(), sourceStateNames.end(),
+                    name) != sourceStateNames.end()) {
+            continue;
+        }
+        const std::string suffix = "/activation";
+        if (endsWith(name, suffix)) {
+            const std::string control =
+                    name.substr(0, name.size() - suffix.size());
+            if (std::find(guess.getControlNames().begin(),
+                        guess.getControlNames().end(),
+                        control) != guess.getControlNames().end()) {
+                guess.setState(
+                        name, SimTK::Vector(guess.getControl(control)));
+                continue;
+            }
+        }
+        remaining.push_back(name);
+    }
+    if (remaining.empty()) return;
+
+    // The other new states (e.g., normalized tendon force) are obtained by
+    // equilibrating the muscles at each time in the guess.
+    Model model = problem.getPhase(0).getModelProcessor().process();
+    SimTK::State state = model.initSystem();
+    const auto svNames = model.getStateVariableNames();
+    const auto& guessStateNames = guess.getStateNames();
+    std::vector<int> guessIndices(svNames.size(), -1);
+    for (int isv = 0; isv < svNames.size(); ++isv) {
+        const auto it = std::find(guessStateNames.begin(),
+                guessStateNames.end(), svNames[isv]);
+        if (it != guessStateNames.end()) {
+            guessIndices[isv] = (int)(it - guessStateNames.begin());
+        }
+    }
+    const auto controlIndices = createSystemControlIndexMap(model);
+    SimTK::Matrix remainingValues(guess.getNumTimes(), (int)remaining.size());
+    remainingValues = SimTK::NaN;
+    SimTK::Vector values = model.getStateVariableValues(state);
+    for (int itime = 0; itime < guess.getNumTimes(); ++itime) {
+        state.setTime(guess.getTime()[itime]);
+        for (int isv = 0; isv < svNames.size(); ++isv) {
+            if (guessIndices[isv] != -1) {
+                values[isv] = guess.getStatesTrajectory()(
+                        itime, guessIndices[isv]);
+            }
+        }
+        // Changing the state variables invalidates the controls, so the
+        // controls are written after the state is realized.
+        model.setStateVariableValues(state, values);
+        model.realizeVelocity(state);
+        auto& modelControls = model.updControls(state);
+        for (int ic = 0; ic < (int)guess.getControlNames().size(); ++ic) {
+            const auto it = controlIndices.find(guess.getControlNames()[ic]);
+            if (it != controlIndices.end()) {
+                modelControls[it->second] =
+                        guess.getControlsTrajectory()(itime, ic);
+            }
+        }
+        model.setControls(state, modelControls);
+        try {
+            model.equilibrateMuscles(state);
+        } catch (const std::exception&) {
+            // Keep the values from the bounds guess at this time.
+            continue;
+        }
+        for (int ir = 0; ir < (int)remaining.size(); ++ir) {
+            if (svNames.findIndex(remaining[ir]) != -1) {
+                remainingValues(itime, ir) =
+                        model.getStateVariableValue(state, remaining[ir]);
+            }
+        }
+    }
+    for (int ir = 0; ir < (int)remaining.size(); ++ir) {
+        SimTK::Vector column = guess.getState(remaining[ir]);
+        for (int itime = 0; itime < guess.getNumTimes(); ++itime) {
+            if (!SimTK::isNaN(remainingValues(itime, ir))) {
+                column[itime] = remainingValues(itime, ir);
+            }
+        }
+        guess.setState(remaining[ir], column);
+    }
+}
+
+template <typename SolverType>
+bool getSolverGuess(const MocoSolver& solver, MocoTrajectory& guess) {
+    const auto* derived = dynamic_cast<const SolverType*>(&solver);
+    if (!derived) return false;
+    guess = derived->getGuess();
+    return true;
+}
+
+/// Apply the stage's solver settings (if `stage` is not null) and set the
+/// solver's guess from `previous`.
+template <typename SolverType>
+bool configureStageSolver(MocoSolver& solver, const MocoStage* stage,
+        const MocoTrajectory& previous, const MocoProblem& problem) {
+    auto* derived = dynamic_cast<SolverType*>(&solver);
+    if (!derived) return false;
+    if (stage) {
+        if (stage->get_num_mesh_intervals() != -1) {
+            derived->set_num_mesh_intervals(stage->get_num_mesh_intervals());
+        }
+        if (stage->get_optim_convergence_tolerance() != -1) {
+            derived->set_optim_convergence_tolerance(
+                    stage->get_optim_convergence_tolerance());
+        }
+        if (stage->get_optim_constraint_tolerance() != -1) {
+            derived->set_optim_constraint_tolerance(
+                    stage->get_optim_constraint_tolerance());
+        }
+    }
+    if (previous.empty()) {
+        // Use the default guess.
+        derived->clearGuess();
+    } else {
+        MocoTrajectory guess = derived->createGuess();
+        applyTrajectoryToGuess(previous, problem, guess);
+        derived->setGuess(std::move(guess));
+    }
+    return true;
+}
+} // anonymous namespace
+
+MocoSolution MocoStudy::solveStages() const {
+    MocoTrajectory previous;
+    OPENSIM_THROW_IF_FRMOBJ(
+            !getSolverGuess<MocoCasADiSolver>(get_solver(), previous) &&
+                    !getSolverGuess<MocoTropterSolver>(get_solver(), previous),
+            Exception,
+            format("Stages are not supported with solver %s.",
+                    get_solver().getConcreteClassName()));
+
+    const int numStages = getProperty_stages().size();
+    for (int istage = 0; istage <= numStages; ++istage) {
+        // The last iteration solves the study's own problem.
+        const MocoStage* stage =
+                istage < numStages ? &get_stages(istage) : nullptr;
+        MocoStudy study(*this);
+        study.updProperty_stages().clear();
+        study.set_write_solution("false");
+        if (stage) {
+            auto& modelProcessor =
+                    study.updProblem().updPhase(0).updModelProcessor();
+            for (int iop = 0; iop < stage->getProperty_model_operators().size();
+                    ++iop) {
+                modelProcessor.append(stage->get_model_operators(iop));
+            }
+        }
+        auto& solver = study.initSolverInternal();
+        if (!configureStageSolver<MocoCasADiSolver>(
+                    solver, stage, previous, study.getProblem())) {
+            configureStageSolver<MocoTropterSolver>(
+                    solver, stage, previous, study.getProblem());
+        }
+        if (!stage) return study.get_solver().solve();
+
+        const bool verbose = isVerbose(study.get_solver());
+        if (verbose) {
+            std::cout << "Solving stage " << istage + 1 << " of " << numStages
+                      << "..." << std::endl;
+        }
+        MocoSolution solution = study.solve();
+        solution.unseal();
+        if (verbose) {
+            std::cout << "Stage " << istage + 1 << " of " << numStages
+                      << (solution.success() ? " converged"
+                                             : " did not converge")
+                      << " in " << solution.getNumIterations()
+                      << " iterations and " << solution.getSolverDuration()
+                      << " seconds." << std::endl;
+        }
+        previous = std::move(solution);
+    }
+    OPENSIM_THROW_FRMOBJ(Exception, "Internal error.");
+}
+
 void MocoStudy::visualize(const MocoTrajectory& it) const {
     // TODO this does not need the Solver at all, so this could be moved to
     // MocoProblem.
@@ -19,6 +19,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "MocoSolver.h"
+#include "MocoStage.h"
 
 #include <OpenSim/Common/Object.h>
 #include <OpenSim/Simulation/Model/Model.h>
@@ -68,6 +69,22 @@ class MocoCasADiSolver;
 /// solvers, but there is no timeline for this. If you require additional
 /// features or enhancements to the solver, please consider contributing to
 /// **tropter**.
+///
+/// Solving in stages
+/// -----------------
+/// Problems with detailed models (e.g., compliant tendons) often solve faster
+/// when given a guess from a cheaper variant of the problem (e.g., with rigid
+/// tendons). If the `stages` property contains MocoStage%s, solve() first
+/// solves each stage in order, each using the trajectory from the previous
+/// stage (or the solver's guess, for the first stage) as its guess, and then
+/// solves the study's problem using the trajectory from the last stage as
+/// its guess. Variables that a stage's problem has but the previous
+/// trajectory lacks are filled in as follows: muscle activations are set to
+/// the muscle's excitation, other states of muscles (e.g., normalized tendon
+/// force) are set by equilibrating the muscles (Model::equilibrateMuscles()),
+/// and other variables keep the values from the bounds guess. A stage that
+/// fails to converge still provides the guess for the next stage. Stages are
+/// only supported with MocoCasADiSolver and MocoTropterSolver.
 class OSIMMOCO_API MocoStudy : public Object {
     OpenSim_DECLARE_CONCRETE_OBJECT(MocoStudy, Object);
 
@@ -77,6 +94,10 @@ public:
             "the "
             "solution files should be written. Set to 'false' to not write the "
             "solution to disk.");
+    OpenSim_DECLARE_LIST_PROPERTY(stages, MocoStage,
+            "Cheaper variants of the problem to solve, in order, before "
+            "solving the problem; each stage provides the guess for the next "
+            "(default: none).");
 
     MocoStudy();
 
@@ -120,8 +141,49 @@ public:
     ///     You must have finished setting up both the problem and solver.
     /// This reinitializes the solver so that any changes you have made will
     /// hold.
+    /// If a cache directory is set (see setCacheDir()) and it contains a
+    /// solution for this study, that solution is returned without solving.
+    /// If the study has stages, they are solved first (see "Solving in
+    /// stages" above).
     MocoSolution solve() const;
 
+    /// @name Caching solutions
+    /// Solving the same study twice yields the same solution, so solve() can
+    /// optionally store successful solutions in a directory, keyed by
+    /// calcCacheKey(). On a later call to solve() (perhaps from another
+    /// process) with an identical study, the stored solution is read from
+    /// the directory instead of solving. The solver statistics of the stored
+    /// solution (e.g., getSolverDuration()) are those of the original solve.
+    /// Caching is disabled by default. Studies with an enabled goal that
+    /// holds reference data in memory outside of its properties (e.g., a
+    /// MocoMarkerTrackingGoal whose MarkersReference was created from a
+    /// TimeSeriesTable_<SimTK::Vec3>, or
+    /// MocoOrientationTrackingGoal::setRotationReference()) are never cached,
+    /// since this data is not part of calcCacheKey().
+    /// @{
+
+    /// Set the directory in which to store and look up solutions. The
+    /// directory is created if it does not exist. Use an empty string (the
+    /// default) to disable caching. This setting is not serialized.
+    void setCacheDir(std::string cacheDir) {
+        m_cacheDir = std::move(cacheDir);
+    }
+    const std::string& getCacheDir() const { return m_cacheDir; }
+
+    /// A hexadecimal hash of everything that determines the solution:
+    /// the Moco version; the serialized problem, solver, and stages; the
+    /// contents of files referenced by properties named `filepath` or ending
+    /// in `_file` (e.g., the model file and TableProcessor files), evaluated
+    /// relative to the current working directory; the data files of
+    /// ExternalLoads, including those given by such XML files (e.g., for
+    /// ModOpAddExternalLoads and MocoContactTrackingGoal); the source tables
+    /// of TableProcessor%s provided in memory; and the guess provided to the
+    /// solver via setGuess(). Data that goals hold in memory outside of their
+    /// properties is not part of the key, so solve() does not use the cache
+    /// for such studies.
+    std::string calcCacheKey() const;
+    /// @}
+
     /// Interactively visualize a trajectory using the simbody-visualizer. The
     /// trajectory could be an initial guess, a solution, etc.
     /// @precondition
@@ -169,6 +231,9 @@ protected:
 private:
     MocoSolver& initSolverInternal();
     void constructProperties();
+    MocoSolution solveStages() const;
+
+    std::string m_cacheDir;
 };
 
 template <>
@@ -19,6 +19,9 @@
 #include "MocoStudyFactory.h"
 
 #include "Components/ModelFactory.h"
+#include "MocoCasADiSolver/MocoCasADiSolver.h"
+#include "MocoGoal/MocoControlGoal.h"
+#include "MocoGoal/MocoStateTrackingGoal.h"
 #include "MocoProblem.h"
 
 using namespace OpenSim;
@@ -86,3 +89,102 @@ MocoStudy MocoStudyFactory::createLinearTangentSteeringStudy(
 
     return study;
 }
+
+TimeSeriesTable MocoStudyFactory::createSyntheticReference(int numLinks,
+        int numLoopConstraints, double duration, int numTimes) {
+    OPENSIM_THROW_IF(numLinks < 1, Exception,
+            format("Expected numLinks to be positive, but got %i.",
+                    numLinks));
+    OPENSIM_THROW_IF(numLoopConstraints < 0 ||
+                             numLoopConstraints > numLinks / 2,
+            Exception,
+            format("Expected numLoopConstraints to be in [0, %i], but got "
+                   "%i.",
+                    numLinks / 2, numLoopConstraints));
+    OPENSIM_THROW_IF(duration <= 0, Exception,
+            format("Expected duration to be positive, but got %g.",
+                    duration));
+    OPENSIM_THROW_IF(numTimes < 2, Exception,
+            format("Expected numTimes to be at least 2, but got %i.",
+                    numTimes));
+
+    std::vector<std::string> labels;
+    for (int i = 0; i < numLinks; ++i) {
+        const std::string istr = std::to_string(i);
+        labels.push_back("/jointset/j" + istr + "/q" + istr + "/value");
+    }
+    for (int i = 0; i < numLinks; ++i) {
+        const std::string istr = std::to_string(i);
+        labels.push_back("/jointset/j" + istr + "/q" + istr + "/speed");
+    }
+
+    // The angle of each link with respect to the vertical is a sinusoid. The
+    // two links in loop k have opposite angles, so the distal end of the
+    // second link returns to the vertical line through the distal end of
+    // link 2k - 1 (or the chain's base).
+    const double amplitude = 0.2;
+    const double omega = 2 * SimTK::Pi / duration;
+    std::vector<double> times(numTimes);
+    SimTK::Matrix data(numTimes, 2 * numLinks);
+    for (int itime = 0; itime < numTimes; ++itime) {
+        const double time = duration * itime / (numTimes - 1);
+        times[itime] = time;
+        double prevAngle = 0;
+        double prevAngularVelocity = 0;
+        for (int i = 0; i < numLinks; ++i) {
+            const bool inLoop = i < 2 * numLoopConstraints;
+            const double sign = inLoop && i % 2 == 1 ? -1 : 1;
+            const double phase = 0.5 * (inLoop ? i / 2 : i);
+            const double angle =
+                    sign * amplitude * std::sin(omega * time + phase);
+            const double angularVelocity =
+                    sign * amplitude * omega * std::cos(omega * time + phase);
+            // The coordinates are the angles relative to the previous link.
+            data(itime, i) = angle - prevAngle;
+            data(itime, numLinks + i) = angularVelocity - prevAngularVelocity;
+            prevAngle = angle;
+            prevAngularVelocity = angularVelocity;
+        }
+    }
+    return TimeSeriesTable(times, data, labels);
+}
+
+MocoStudy MocoStudyFactory::createSyntheticTrackingStudy(int numLinks,
+        int numMusclesPerJoint, int numLoopConstraints, int numContactStations,
+        int numMeshIntervals) {
+    const Model model = ModelFactory::createSyntheticModel(numLinks,
+            numMusclesPerJoint, numLoopConstraints, numContactStations);
+    const TimeSeriesTable reference =
+            createSyntheticReference(numLinks, numLoopConstraints);
+
+    MocoStudy study;
+    study.setName(model.getName() + "_tracking");
+    auto& problem = study.updProblem();
+    problem.setModelCopy(model);
+    problem.setTimeBounds(0, reference.getIndependentColumn().back());
+    for (int i = 0; i < numLinks; ++i) {
+        const std::string istr = std::to_string(i);
+        const std::string path = "/jointset/j" + istr + "/q" + istr;
+        problem.setStateInfo(path + "/value", {-0.5 * SimTK::Pi,
+                                                      0.5 * SimTK::Pi});
+        problem.setStateInfo(path + "/speed", {-20, 20});
+    }
+
+    auto* tracking = problem.addGoal<MocoStateTrackingGoal>("tracking", 10);
+    tracking->setReference(TableProcessor(reference));
+    problem.addGoal<MocoControlGoal>("effort", 0.1);
+
+    auto& solver = study.initCasADiSolver();
+    solver.set_num_mesh_intervals(numMeshIntervals);
+    if (numLoopConstraints) {
+        // The z component of each point-on-line constraint is redundant in
+        // this planar model; penalizing the multipliers keeps them bounded.
+        solver.set_minimize_lagrange_multipliers(true);
+        solver.set_lagrange_multiplier_weight(10);
+    }
+    MocoTrajectory guess = solver.createGuess();
+    guess.setStatesTrajectory(reference, true);
+    solver.setGuess(std::move(guess));
+
+    return study;
+}
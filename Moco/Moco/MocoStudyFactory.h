@@ -36,6 +36,30 @@ public:
     /// New York‐London‐Sydney‐Toronto. John Wiley & Sons. 1975.
     static MocoStudy createLinearTangentSteeringStudy(
             double acceleration, double finalTime, double finalHeight);
+
+    /// Create a reference trajectory for the model from
+    /// ModelFactory::createSyntheticModel() with the same number of links and
+    /// loop constraints. Each link swings sinusoidally (amplitude 0.2 rad,
+    /// period `duration`) with a phase that depends on the link, and the
+    /// links in each loop swing symmetrically so that the reference satisfies
+    /// the loop constraints. The table contains the values and speeds of all
+    /// coordinates at `numTimes` evenly spaced times in [0, duration].
+    static TimeSeriesTable createSyntheticReference(int numLinks,
+            int numLoopConstraints, double duration = 1.0, int numTimes = 101);
+
+    /// Create a study that tracks createSyntheticReference() with the model
+    /// from ModelFactory::createSyntheticModel(), for measuring how solver
+    /// performance scales with the size of the model, the number of mesh
+    /// intervals, and the number of threads. The problem has a fixed duration
+    /// of 1 second, a MocoStateTrackingGoal "tracking" (weight 10) and a
+    /// MocoControlGoal "effort" (weight 0.1). The solver is a
+    /// MocoCasADiSolver with `numMeshIntervals` mesh intervals (and with
+    /// minimize_lagrange_multipliers enabled if there are loop constraints),
+    /// and the guess is the reference. The study depends only on the
+    /// arguments, so results are reproducible across machines.
+    static MocoStudy createSyntheticTrackingStudy(int numLinks,
+            int numMusclesPerJoint, int numLoopConstraints = 0,
+            int numContactStations = 0, int numMeshIntervals = 50);
 };
 
 } // namespace OpenSim
@@ -0,0 +1,173 @@
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: MocoThreadBudget.cpp                                         *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "MocoThreadBudget.h"
+
+#include "MocoUtilities.h"
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#    include <dlfcn.h>
+#endif
+
+using namespace OpenSim;
+
+namespace {
+using SetNumThreads = void (*)(int);
+using GetNumThreads = int (*)();
+struct Budget {
+    std::mutex mutex;
+    // -1 means the default (see getDefaultNumCores()).
+    int numCores = -1;
+    int numLeasedCores = 0;
+    int numActiveLeases = 0;
+    // The thread counts of the linear algebra libraries before they were
+    // first limited, restored when the last lease is released.
+    bool linearAlgebraThreadsLimited = false;
+    std::vector<std::pair<SetNumThreads, int>> previousLinearAlgebraThreads;
+};
+Budget& getBudget() {
+    static Budget budget;
+    return budget;
+}
+int getDefaultNumCores() {
+    const int parallel = getMocoParallelEnvironmentVariable();
+    if (parallel > 1) return parallel;
+    return std::max(1, (int)std::thread::hardware_concurrency());
+}
+// The caller must hold the budget's mutex.
+int getNumCoresLocked(const Budget& budget) {
+    return budget.numCores == -1 ? getDefaultNumCores() : budget.numCores;
+}
+// The caller must hold the budget's mutex.
+void restoreLinearAlgebraThreadsLocked(Budget& budget) {
+    if (!budget.linearAlgebraThreadsLimited) return;
+    for (const auto& previous : budget.previousLinearAlgebraThreads) {
+        previous.first(previous.second);
+    }
+    budget.previousLinearAlgebraThreads.clear();
+    budget.linearAlgebraThreadsLimited = false;
+}
+} // anonymous namespace
+
+void MocoThreadBudget::setNumCores(int numCores) {
+    OPENSIM_THROW_IF(numCores < 1 && numCores != -1, Exception,
+            format("Expected numCores to be -1 or >= 1, but got %i.",
+                    numCores));
+    auto& budget = getBudget();
+    std::lock_guard<std::mutex> lock(budget.mutex);
+    budget.numCores = numCores;
+}
+
+int MocoThreadBudget::getNumCores() {
+    auto& budget = getBudget();
+    std::lock_guard<std::mutex> lock(budget.mutex);
+    return getNumCoresLocked(budget);
+}
+
+int MocoThreadBudget::getNumAvailableCores() {
+    auto& budget = getBudget();
+    std::lock_guard<std::mutex> lock(budget.mutex);
+    return std::max(0, getNumCoresLocked(budget) - budget.numLeasedCores);
+}
+
+int MocoThreadBudget::getNumActiveLeases() {
+    auto& budget = getBudget();
+    std::lock_guard<std::mutex> lock(budget.mutex);
+    return budget.numActiveLeases;
+}
+
+MocoThreadBudget::Lease MocoThreadBudget::acquire(int numThreads) {
+    OPENSIM_THROW_IF(numThreads < 1 && numThreads != -1, Exception,
+            format("Expected numThreads to be -1 or >= 1, but got %i.",
+                    numThreads));
+    auto& budget = getBudget();
+    std::lock_guard<std::mutex> lock(budget.mutex);
+    const int numCores = getNumCoresLocked(budget);
+    if (numThreads == -1) numThreads = numCores;
+    const int numAvailable = std::max(0, numCores - budget.numLeasedCores);
+    const int numGranted = std::max(1, std::min(numThreads, numAvailable));
+    // A lease that is granted a single thread even though no cores are
+    // available still counts against the budget so that the cores it uses
+    // are not promised to another solve.
+    budget.numLeasedCores += numGranted;
+    ++budget.numActiveLeases;
+    return Lease(numGranted);
+}
+
+MocoThreadBudget::Lease::Lease(Lease&& other)
+        : m_numThreads(other.m_numThreads) {
+    other.m_numThreads = 0;
+}
+
+MocoThreadBudget::Lease& MocoThreadBudget::Lease::operator=(Lease&& other) {
+    if (this != &other) {
+        release();
+        m_numThreads = other.m_numThreads;
+        other.m_numThreads = 0;
+    }
+    return *this;
+}
+
+MocoThreadBudget::Lease::~Lease() { release(); }
+
+void MocoThreadBudget::Lease::release() {
+    if (m_numThreads == 0) return;
+    auto& budget = getBudget();
+    std::lock_guard<std::mutex> lock(budget.mutex);
+    budget.numLeasedCores -= m_numThreads;
+    --budget.numActiveLeases;
+    m_numThreads = 0;
+    if (budget.numActiveLeases == 0) restoreLinearAlgebraThreadsLocked(budget);
+}
+
+void MocoThreadBudget::limitLinearAlgebraThreads(int numThreads) {
+    OPENSIM_THROW_IF(numThreads < 1, Exception,
+            format("Expected numThreads to be >= 1, but got %i.",
+                    numThreads));
+    auto& budget = getBudget();
+    std::lock_guard<std::mutex> lock(budget.mutex);
+    if (budget.numActiveLeases > 1) numThreads = 1;
+#ifndef _WIN32
+    // Look up the libraries' functions at runtime so that Moco does not
+    // depend on a specific OpenMP or BLAS implementation.
+    const std::pair<const char*, const char*> functionNames[] = {
+            {"omp_set_num_threads", "omp_get_max_threads"},
+            {"openblas_set_num_threads", "openblas_get_num_threads"},
+            {"MKL_Set_Num_Threads", "MKL_Get_Max_Threads"}};
+    const bool firstLimit = !budget.linearAlgebraThreadsLimited;
+    for (const auto& names : functionNames) {
+        auto setNumThreads = reinterpret_cast<SetNumThreads>(
+                dlsym(RTLD_DEFAULT, names.first));
+        if (!setNumThreads) continue;
+        if (firstLimit) {
+            if (auto getNumThreads = reinterpret_cast<GetNumThreads>(
+                        dlsym(RTLD_DEFAULT, names.second))) {
+                budget.previousLinearAlgebraThreads.emplace_back(
+                        setNumThreads, getNumThreads());
+            }
+        }
+        setNumThreads(numThreads);
+    }
+    budget.linearAlgebraThreadsLimited = true;
+#endif
+}
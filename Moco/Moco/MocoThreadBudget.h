@@ -0,0 +1,100 @@
+#ifndef MOCO_MOCOTHREADBUDGET_H
+#define MOCO_MOCOTHREADBUDGET_H
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: MocoThreadBudget.h                                           *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimMocoDLL.h"
+
+namespace OpenSim {
+
+/// A process-wide budget of cores shared by all of Moco's parallel work.
+/// A solver evaluates the problem's functions in parallel (e.g., with
+/// CasADi's map), and the NLP solver's linear solver (MUMPS) and BLAS may
+/// also spawn threads. Without coordination, these layers, and multiple
+/// MocoStudy::solve() calls running concurrently, each assume they own the
+/// entire machine and oversubscribe it.
+///
+/// Before solving, a solver acquires a Lease for the number of threads it
+/// would like to use. The lease grants at most the number of cores not
+/// currently leased by other solves (but always at least 1), and the cores
+/// are returned to the budget when the lease is destroyed. The linear solver
+/// and the function evaluations do not run at the same time during an
+/// IPOPT iteration, so they reuse the same leased cores; see
+/// limitLinearAlgebraThreads().
+///
+/// By default, the budget contains the number of cores given by the
+/// OPENSIM_MOCO_PARALLEL environment variable (if greater than 1) or,
+/// otherwise, the number of hardware threads. This budget is also the
+/// default number of threads used by Moco's utilities (see
+/// getMocoNumThreads()).
+class OSIMMOCO_API MocoThreadBudget {
+public:
+    /// Set the total number of cores that Moco may use across all concurrent
+    /// solves. Use -1 to restore the default. Leases that are already
+    /// acquired are not affected.
+    static void setNumCores(int numCores);
+    /// The total number of cores in the budget.
+    static int getNumCores();
+    /// The number of cores not held by any lease (never negative).
+    static int getNumAvailableCores();
+    /// The number of leases that have not yet been released.
+    static int getNumActiveLeases();
+
+    /// Holds cores from the budget until destroyed. Leases can be moved but
+    /// not copied.
+    class OSIMMOCO_API Lease {
+    public:
+        Lease(Lease&& other);
+        Lease& operator=(Lease&& other);
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+        /// The number of threads granted by this lease (at least 1).
+        int getNumThreads() const { return m_numThreads; }
+        /// Return the cores to the budget before the lease is destroyed.
+        void release();
+
+    private:
+        explicit Lease(int numThreads) : m_numThreads(numThreads) {}
+        int m_numThreads;
+        friend class MocoThreadBudget;
+    };
+
+    /// Lease up to `numThreads` cores from the budget. This never blocks: if
+    /// fewer cores are available, the lease grants what is available, and if
+    /// no cores are available, the lease grants a single thread. Use -1 to
+    /// request all cores in the budget.
+    static Lease acquire(int numThreads);
+
+    /// Limit the number of threads used by OpenMP (e.g., MUMPS), OpenBLAS,
+    /// and MKL, if these libraries are loaded into the process; otherwise,
+    /// this does nothing. The OpenBLAS and MKL settings are process-wide, so
+    /// when more than one lease is active, each linear solver is restricted
+    /// to a single thread. The OpenMP setting (omp_set_num_threads()) applies
+    /// only to parallel regions started by the calling thread, so call this
+    /// from the thread that runs the linear solver.
+    ///
+    /// The thread counts from before the first call are restored when the
+    /// last active lease is released. The OpenMP count is restored for the
+    /// thread that releases the lease.
+    static void limitLinearAlgebraThreads(int numThreads);
+};
+
+} // namespace OpenSim
+
+#endif // MOCO_MOCOTHREADBUDGET_H
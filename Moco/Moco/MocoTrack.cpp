@@ -31,6 +31,7 @@
 #include <OpenSim/Common/FileAdapter.h>
 #include <OpenSim/Common/GCVSpline.h>
 #include <OpenSim/Common/GCVSplineSet.h>
+#include <OpenSim/Common/IO.h>
 #include <OpenSim/Simulation/MarkersReference.h>
 
 using namespace OpenSim;
@@ -49,6 +50,9 @@ void MocoTrack::constructProperties() {
     constructProperty_apply_tracked_states_to_guess(false);
     constructProperty_minimize_control_effort(true);
     constructProperty_control_effort_weight(0.001);
+    constructProperty_stages();
+    constructProperty_window_duration(-1);
+    constructProperty_window_step(-1);
 }
 
 MocoStudy MocoTrack::initialize() {
@@ -128,6 +132,10 @@ MocoStudy MocoTrack::initialize() {
         solver.setGuess(guess);
     }
 
+    for (int i = 0; i < getProperty_stages().size(); ++i) {
+        study.append_stages(get_stages(i));
+    }
+
     return study;
 }
 
@@ -137,12 +145,263 @@ MocoSolution MocoTrack::solve(bool visualize) {
 
     // Solve!
     // ------
-    MocoSolution solution = study.solve();
+    MocoSolution solution = get_window_duration() > 0
+                                    ? solveWindows(study, {})
+                                    : study.solve();
     if (visualize) { study.visualize(solution); }
 
     return solution;
 }
 
+MocoSolution MocoTrack::solveRecedingHorizon(
+        std::function<void(const MocoTrajectory&)> callback) {
+    OPENSIM_THROW_IF_FRMOBJ(get_window_duration() <= 0, Exception,
+            format("Expected window_duration to be positive, but got %g.",
+                    get_window_duration()));
+    MocoStudy study = initialize();
+    return solveWindows(study, callback);
+}
+
+namespace {
+/// Create a guess for the time range [initialTime, finalTime] from a
+/// trajectory (e.g., the solution of the previous window) by linearly
+/// interpolating the trajectory, and by holding its first or last values
+/// outside of its time range.
+MocoTrajectory createShiftedGuess(const MocoTrajectory& source,
+        double initialTime, double finalTime, int numTimes) {
+    const SimTK::Vector& sourceTime = source.getTime();
+    const SimTK::Vector time =
+            createVectorLinspace(numTimes, initialTime, finalTime);
+    SimTK::Vector clampedTime(numTimes);
+    for (int itime = 0; itime < numTimes; ++itime) {
+        clampedTime[itime] = SimTK::clamp(sourceTime[0], time[itime],
+                sourceTime[sourceTime.size() - 1]);
+    }
+    auto shift = [&](const SimTK::Matrix& values) {
+        SimTK::Matrix shifted(numTimes, values.ncol());
+        for (int icol = 0; icol < values.ncol(); ++icol) {
+            shifted.updCol(icol) = interpolate(sourceTime,
+                    SimTK::Vector(values.col(icol)), clampedTime, true);
+        }
+        return shifted;
+    };
+    return MocoTrajectory(time, source.getStateNames(),
+            source.getControlNames(), source.getMultiplierNames(),
+            source.getDerivativeNames(), source.getParameterNames(),
+            shift(source.getStatesTrajectory()),
+            shift(source.getControlsTrajectory()),
+            shift(source.getMultipliersTrajectory()),
+            shift(source.getDerivativesTrajectory()),
+            source.getParameters());
+}
+
+/// Copy the rows [begin, end) of a trajectory, excluding slack variables.
+MocoTrajectory extractRows(const MocoTrajectory& traj, int begin, int end) {
+    const int numTimes = end - begin;
+    auto rows = [&](const SimTK::Matrix& values) {
+        return SimTK::Matrix(values.block(begin, 0, numTimes, values.ncol()));
+    };
+    return MocoTrajectory(SimTK::Vector(traj.getTime()(begin, numTimes)),
+            traj.getStateNames(), traj.getControlNames(),
+            traj.getMultiplierNames(), traj.getDerivativeNames(),
+            traj.getParameterNames(), rows(traj.getStatesTrajectory()),
+            rows(traj.getControlsTrajectory()),
+            rows(traj.getMultipliersTrajectory()),
+            rows(traj.getDerivativesTrajectory()), traj.getParameters());
+}
+
+/// Concatenate trajectories with the same variables, in time order. The
+/// parameters are those of the last trajectory.
+MocoTrajectory concatenate(const std::vector<MocoTrajectory>& segments) {
+    int numTimes = 0;
+    for (const auto& segment : segments) numTimes += segment.getNumTimes();
+    const MocoTrajectory& last = segments.back();
+    SimTK::Vector time(numTimes);
+    SimTK::Matrix states(numTimes, (int)last.getStateNames().size());
+    SimTK::Matrix controls(numTimes, (int)last.getControlNames().size());
+    SimTK::Matrix multipliers(numTimes, (int)last.getMultiplierNames().size());
+    SimTK::Matrix derivatives(numTimes, (int)last.getDerivativeNames().size());
+    int offset = 0;
+    for (const auto& segment : segments) {
+        const int n = segment.getNumTimes();
+        time(offset, n) = segment.getTime();
+        states.updBlock(offset, 0, n, states.ncol()) =
+                segment.getStatesTrajectory();
+        controls.updBlock(offset, 0, n, controls.ncol()) =
+                segment.getControlsTrajectory();
+        multipliers.updBlock(offset, 0, n, multipliers.ncol()) =
+                segment.getMultipliersTrajectory();
+        derivatives.updBlock(offset, 0, n, derivatives.ncol()) =
+                segment.getDerivativesTrajectory();
+        offset += n;
+    }
+    return MocoTrajectory(time, last.getStateNames(), last.getControlNames(),
+            last.getMultiplierNames(), last.getDerivativeNames(),
+            last.getParameterNames(), states, controls, multipliers,
+            derivatives, last.getParameters());
+}
+} // anonymous namespace
+
+MocoSolution MocoTrack::solveWindows(MocoStudy& study,
+        const std::function<void(const MocoTrajectory&)>& callback) const {
+    const double initialTime = m_timeInfo.initial;
+    const double finalTime = m_timeInfo.final;
+    OPENSIM_THROW_IF_FRMOBJ(get_window_step() > get_window_duration(),
+            Exception,
+            format("Expected window_step to be at most window_duration (%g), "
+                   "but got %g.",
+                    get_window_duration(), get_window_step()));
+
+    // All windows (except possibly the last) have the same duration and
+    // mesh, so the cost of solving a window does not depend on the length of
+    // the trial. The windows share the processed model and reference data
+    // (and the reference splines) of the study.
+    const double duration =
+            std::min(get_window_duration(), finalTime - initialTime);
+    const int numMeshIntervals =
+            std::max(1, (int)std::ceil(duration / get_mesh_interval()));
+    const double meshInterval = duration / numMeshIntervals;
+    // Shift by whole mesh intervals so that the committed part of each
+    // window ends on a mesh point, and so that the previous solution
+    // provides the guess exactly where the windows overlap.
+    const double desiredStep =
+            get_window_step() > 0 ? get_window_step() : 0.5 * duration;
+    const int numStepIntervals = std::max(1,
+            std::min(numMeshIntervals,
+                    (int)std::round(desiredStep / meshInterval)));
+    const double step = numStepIntervals * meshInterval;
+    const double tol = 1e-6 * meshInterval;
+
+    // Only the stitched solution is written (as for a study without windows).
+    const std::string writeSolution = study.get_write_solution();
+    study.set_write_solution("false");
+    auto& solver = study.updSolver<MocoCasADiSolver>();
+    const bool verbose = isVerbose(solver);
+    // The first window is warm-started from the guess for the entire trial.
+    MocoTrajectory previous = solver.getGuess();
+
+    // Each window after the first starts from the state of the previous
+    // window at the window's initial time, so that the stitched solution is
+    // continuous. The other bounds of the states are unchanged.
+    std::vector<MocoVariableInfo> stateInfos;
+    {
+        const MocoProblemRep rep = study.getProblem().createRep();
+        for (const auto& name : rep.createStateInfoNames()) {
+            stateInfos.push_back(rep.getStateInfo(name));
+        }
+    }
+
+    std::vector<MocoTrajectory> segments;
+    MocoSolution windowSolution;
+    bool success = true;
+    std::string status;
+    double objective = 0;
+    int numIterations = 0;
+    double solverDuration = 0;
+    double committedTime = -SimTK::Infinity;
+    double start = initialTime;
+    bool lastWindow = false;
+    for (int iwindow = 0; !lastWindow; ++iwindow) {
+        double end = start + duration;
+        int windowMeshIntervals = numMeshIntervals;
+        if (end >= finalTime - tol) {
+            // The last window ends at the final time; it may be shorter than
+            // the other windows, and has (about) the same mesh interval.
+            end = finalTime;
+            windowMeshIntervals = std::max(1,
+                    (int)std::ceil((end - start) / meshInterval - 1e-6));
+            lastWindow = true;
+        }
+        if (verbose) {
+            std::cout << format("MocoTrack: solving window %i [%g, %g].",
+                                 iwindow, start, end)
+                      << std::endl;
+        }
+        study.updProblem().setTimeBounds(start, end);
+        if (iwindow > 0) {
+            // The window starts on a mesh point of the previous window.
+            const SimTK::Vector& previousTime = previous.getTime();
+            int istart = 0;
+            while (istart < previousTime.size() &&
+                    std::abs(previousTime[istart] - start) > tol) {
+                ++istart;
+            }
+            OPENSIM_THROW_IF_FRMOBJ(istart == previousTime.size(), Exception,
+                    "Internal error: the window does not start on a mesh "
+                    "point of the previous window.");
+            for (const auto& info : stateInfos) {
+                study.updProblem().setStateInfo(info.getName(),
+                        info.getBounds(),
+                        previous.getState(info.getName())[istart],
+                        info.getFinalBounds());
+            }
+        }
+        solver.set_num_mesh_intervals(windowMeshIntervals);
+        solver.setGuess(createShiftedGuess(
+                previous, start, end, 2 * windowMeshIntervals + 1));
+        windowSolution = study.solve();
+        if (!windowSolution.success() && success) {
+            success = false;
+            status = windowSolution.getStatus();
+        }
+        windowSolution.unseal();
+        objective += windowSolution.getObjective();
+        numIterations += windowSolution.getNumIterations();
+        solverDuration += windowSolution.getSolverDuration();
+
+        // Commit the part of this window before the start of the next
+        // window.
+        const SimTK::Vector& time = windowSolution.getTime();
+        const double commitEnd = lastWindow ? SimTK::Infinity : start + step;
+        int begin = 0;
+        while (begin < time.size() && time[begin] <= committedTime + tol) {
+            ++begin;
+        }
+        int endIndex = begin;
+        while (endIndex < time.size() && time[endIndex] < commitEnd - tol) {
+            ++endIndex;
+        }
+        if (endIndex > begin) {
+            segments.push_back(extractRows(windowSolution, begin, endIndex));
+            committedTime = time[endIndex - 1];
+            if (callback) callback(segments.back());
+        }
+
+        previous = windowSolution;
+        start += step;
+    }
+
+    const MocoTrajectory stitched = concatenate(segments);
+    MocoSolution solution(stitched.getTime(), stitched.getStateNames(),
+            stitched.getControlNames(), stitched.getMultiplierNames(),
+            stitched.getDerivativeNames(), stitched.getParameterNames(),
+            stitched.getStatesTrajectory(), stitched.getControlsTrajectory(),
+            stitched.getMultipliersTrajectory(),
+            stitched.getDerivativesTrajectory(), stitched.getParameters());
+    solution.setObjective(objective);
+    solution.setStatus(success ? windowSolution.getStatus() : status);
+    solution.setNumIterations(numIterations);
+    solution.setSolverDuration(solverDuration);
+    solution.setNumThreads(windowSolution.getNumThreads());
+    solution.setSuccess(success);
+
+    study.set_write_solution(writeSolution);
+    if (writeSolution != "false") {
+        OpenSim::IO::makeDir(writeSolution);
+        const std::string prefix =
+                study.getName().empty() ? "MocoStudy" : study.getName();
+        try {
+            solution.write(writeSolution +
+                           SimTK::Pathname::getPathSeparator() + prefix +
+                           "_solution.sto");
+        } catch (const TimestampGreaterThanEqualToNext&) {
+            std::cout << "Could not write solution to file...skipping."
+                      << std::endl;
+        }
+    }
+    return solution;
+}
+
 TimeSeriesTable MocoTrack::configureStateTracking(
         MocoProblem& problem, Model& model) {
 
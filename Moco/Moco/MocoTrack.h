@@ -27,6 +27,8 @@
 
 #include <OpenSim/Simulation/Model/Model.h>
 
+#include <functional>
+
 namespace OpenSim {
 
 class MocoWeightSet;
@@ -153,6 +155,59 @@ class MocoTrajectory;
 /// MocoSolution solution = study.solve();
 /// @endcode
 ///
+/// Solving in stages
+/// -----------------
+/// Tracking problems with compliant tendons can be solved faster by first
+/// solving cheaper variants of the problem (see MocoStage):
+///
+/// @code
+/// MocoStage rigid;
+/// rigid.append_model_operators(ModOpIgnoreTendonCompliance());
+/// rigid.set_num_mesh_intervals(25);
+/// MocoStage excitations(rigid);
+/// excitations.append_model_operators(ModOpIgnoreActivationDynamics());
+/// excitations.append_model_operators(ModOpIgnorePassiveFiberForcesDGF());
+/// excitations.set_num_mesh_intervals(10);
+/// track.append_stages(excitations);
+/// track.append_stages(rigid);
+/// MocoSolution solution = track.solve();
+/// @endcode
+///
+/// Receding horizon
+/// ----------------
+/// Long trials can be solved as a sequence of smaller problems by setting
+/// the `window_duration` property. Each window is a tracking problem over
+/// `window_duration` seconds of the reference data, and consecutive windows
+/// are shifted by `window_step`. Each window is warm-started from the
+/// previous window's solution (shifted in time), and the part of each
+/// window's solution up to the start of the next window is committed to the
+/// solution. Each window after the first starts from the previous window's
+/// state at the window's initial time, so the states of the solution are
+/// continuous. Since all windows (except possibly the shorter last window)
+/// have the same duration and mesh, the time and memory required to solve
+/// each window do not depend on the length of the trial. However, each
+/// window is solved as a separate MocoStudy::solve(), so the problem's
+/// MocoProblemRep (including the model's initSystem()) and the solver's
+/// transcription are rebuilt for every window; only the processed model and
+/// reference data are shared. Use solveRecedingHorizon() to obtain each
+/// committed segment of the solution as soon as it is available:
+///
+/// @code
+/// track.set_window_duration(0.5);
+/// track.set_window_step(0.1);
+/// MocoSolution solution = track.solveRecedingHorizon(
+///         [](const MocoTrajectory& segment) {
+///             std::cout << "Solved until " << segment.getFinalTime()
+///                       << " s." << std::endl;
+///         });
+/// @endcode
+///
+/// The objective, iterations, and solver duration of the resulting
+/// solution are the sums over the windows. The solution is successful only
+/// if all windows were solved successfully; if a window fails, the
+/// remaining windows are still solved, and the solution's status is that of
+/// the first window that failed.
+///
 /// @underdevelopment
 class OSIMMOCO_API MocoTrack : public MocoTool {
     OpenSim_DECLARE_CONCRETE_OBJECT(MocoTrack, MocoTool);
@@ -235,6 +290,23 @@ public:
             "The weight on the control effort minimization cost term, if it "
             "exists. Default: 0.001");
 
+    OpenSim_DECLARE_LIST_PROPERTY(stages, MocoStage,
+            "Cheaper variants of the tracking problem to solve, in order, "
+            "before solving the tracking problem; each stage provides the "
+            "guess for the next (see MocoStudy). Default: none.");
+
+    OpenSim_DECLARE_PROPERTY(window_duration, double,
+            "Solve the problem as a receding horizon: a sequence of "
+            "overlapping windows of this duration (seconds) that slide over "
+            "the time range. Default: -1, which means to solve the entire "
+            "time range as a single problem.");
+
+    OpenSim_DECLARE_PROPERTY(window_step, double,
+            "The time (seconds) by which consecutive receding-horizon windows "
+            "are shifted, rounded to a multiple of the window's mesh interval. "
+            "Must not exceed 'window_duration'. Default: -1, which means half "
+            "of 'window_duration'.");
+
     MocoTrack() { constructProperties(); }
 
     /// Set the states reference TableProcessor.
@@ -266,7 +338,17 @@ public:
     }
 
     MocoStudy initialize();
+    /// If `window_duration` is set, this solves the problem as a receding
+    /// horizon (see solveRecedingHorizon()).
     MocoSolution solve(bool visualize = false);
+    /// Solve the problem as a receding horizon (see `window_duration`). The
+    /// MocoProblemRep and the transcription are rebuilt for each window
+    /// rather than reused. The callback, if provided, is invoked with each
+    /// segment of the solution as soon as the window containing the segment
+    /// is solved. The segments are in order and do not overlap, and the
+    /// returned solution is their concatenation.
+    MocoSolution solveRecedingHorizon(
+            std::function<void(const MocoTrajectory&)> callback = {});
 
 private:
     Model m_model;
@@ -274,6 +356,11 @@ private:
 
     void constructProperties();
 
+    // Solve the windows of the receding horizon, using the study created by
+    // initialize().
+    MocoSolution solveWindows(MocoStudy& study,
+            const std::function<void(const MocoTrajectory&)>& callback) const;
+
     // Cost configuration methods.
     TimeSeriesTable configureStateTracking(MocoProblem& problem, Model& model);
     void configureMarkerTracking(MocoProblem& problem, Model& model);
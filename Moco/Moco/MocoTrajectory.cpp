@@ -1347,6 +1347,26 @@ void MocoTrajectory::ensureUnsealed() const {
     OPENSIM_THROW_IF(m_sealed, MocoTrajectoryIsSealed);
 }
 
+std::vector<std::string> MocoSolution::getFunctionEvaluationNames() const {
+    ensureUnsealed();
+    std::vector<std::string> names;
+    for (const auto& entry : m_numFunctionEvaluations) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+int MocoSolution::getNumFunctionEvaluations(const std::string& name) const {
+    ensureUnsealed();
+    for (const auto& entry : m_numFunctionEvaluations) {
+        if (entry.first == name) {
+            return entry.second;
+        }
+    }
+    OPENSIM_THROW(Exception,
+            format("No function evaluation count for '%s'.", name));
+}
+
 std::vector<std::string> MocoSolution::getObjectiveTermNames() const {
     ensureUnsealed();
     std::vector<std::string> names;
@@ -1400,9 +1420,18 @@ void MocoSolution::convertToTableImpl(TimeSeriesTable& table) const {
             "num_iterations", std::to_string(m_numIterations));
     table.updTableMetaData().setValueForKey(
             "solver_duration", std::to_string(m_solverDuration));
+    if (m_numThreads != -1) {
+        table.updTableMetaData().setValueForKey(
+                "num_threads", std::to_string(m_numThreads));
+    }
     for (const auto& entry : m_objectiveBreakdown) {
         table.updTableMetaData().setValueForKey(
                 "objective_" + entry.first, std::to_string(entry.second));
 
     }
+    for (const auto& entry : m_numFunctionEvaluations) {
+        table.updTableMetaData().setValueForKey(
+                "num_evaluations_" + entry.first,
+                std::to_string(entry.second));
+    }
 }
@@ -768,6 +768,28 @@ public:
         ensureUnsealed();
         return m_solverDuration;
     }
+    /// Number of threads the solver used to evaluate the problem's functions
+    /// in parallel across the grid (1 if evaluated serially; -1 if not set).
+    int getNumThreads() const {
+        ensureUnsealed();
+        return m_numThreads;
+    }
+
+    /// @name Function evaluations
+    /// Some solvers report how many times the optimizer evaluated each
+    /// function of the nonlinear program. For example, MocoCasADiSolver
+    /// reports "nlp_f" (objective), "nlp_grad_f" (objective gradient),
+    /// "nlp_g" (constraints), and "nlp_jac_g" (constraint Jacobian).
+    /// @{
+
+    /// Get the names of the functions whose evaluations were counted. If the
+    /// solver did not provide these counts, then this returns an empty
+    /// vector.
+    std::vector<std::string> getFunctionEvaluationNames() const;
+    /// Get the number of times a function was evaluated, by name. See
+    /// getFunctionEvaluationNames().
+    int getNumFunctionEvaluations(const std::string& name) const;
+    /// @}
 
     /// @name Breakdown of objective
     /// Some solvers provide a breakdown of the terms in the objective. Use
@@ -842,6 +864,11 @@ private:
         m_numIterations = numIterations;
     };
     void setSolverDuration(double duration) { m_solverDuration = duration; }
+    void setNumThreads(int numThreads) { m_numThreads = numThreads; }
+    void setNumFunctionEvaluations(
+            std::vector<std::pair<std::string, int>> numEvaluations) {
+        m_numFunctionEvaluations = std::move(numEvaluations);
+    }
     void convertToTableImpl(TimeSeriesTable&) const override;
     bool m_success = true;
     double m_objective = -1;
@@ -849,8 +876,12 @@ private:
     std::string m_status;
     int m_numIterations = -1;
     double m_solverDuration = -1;
+    int m_numThreads = -1;
+    std::vector<std::pair<std::string, int>> m_numFunctionEvaluations;
     // Allow solvers to set success, status, and construct a solution.
     friend class MocoSolver;
+    // MocoTrack stitches the solutions of its receding-horizon windows.
+    friend class MocoTrack;
 };
 
 } // namespace OpenSim
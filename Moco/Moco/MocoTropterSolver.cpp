@@ -156,6 +156,9 @@ MocoTropterSolver::createTropterSolver(
                 get_exact_hessian_block_sparsity_mode());
     }
 
+    dircol->set_scaling(get_scale_variables_and_constraints(),
+            createVariableScalesMap());
+
     // Get optimization solver to check the remaining property settings.
     auto& optsolver = dircol->get_opt_solver();
 
@@ -394,7 +397,7 @@ MocoSolution MocoTropterSolver::solveImpl() const {
     const long long elapsed = stopwatch.getElapsedTimeInNs();
     MocoSolver::setSolutionStats(mocoSolution, tropSolution.success,
             tropSolution.objective, tropSolution.status,
-            tropSolution.num_iterations, SimTK::nsToSec(elapsed));
+            tropSolution.num_iterations, SimTK::nsToSec(elapsed), {}, 1);
 
     if (get_verbosity()) {
         std::cout << std::string(79, '-') << "\n";
@@ -18,12 +18,29 @@
 
 #include "MocoUtilities.h"
 
+#include "Common/TableProcessor.h"
+#include "MocoDirectCollocationSolver.h"
+#include "MocoGoal/MocoAccelerationTrackingGoal.h"
+#include "MocoGoal/MocoAngularVelocityTrackingGoal.h"
+#include "MocoGoal/MocoMarkerTrackingGoal.h"
+#include "MocoGoal/MocoOrientationTrackingGoal.h"
+#include "MocoGoal/MocoTranslationTrackingGoal.h"
 #include "MocoProblem.h"
+#include "MocoThreadBudget.h"
 #include "MocoTrajectory.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdarg>
 #include <cstdio>
+#include <exception>
+#include <fstream>
+#include <future>
 #include <iomanip>
+#include <mutex>
 #include <regex>
+#include <sstream>
+#include <thread>
 
 #include <simbody/internal/Visualizer_InputListener.h>
 
@@ -33,6 +50,7 @@
 #include <OpenSim/Common/TimeSeriesTable.h>
 #include <OpenSim/Simulation/Control/PrescribedController.h>
 #include <OpenSim/Simulation/Manager/Manager.h>
+#include <OpenSim/Simulation/Model/ExternalLoads.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/StatesTrajectory.h>
 #include <OpenSim/Simulation/StatesTrajectoryReporter.h>
@@ -139,6 +157,161 @@ SimTK::Vector OpenSim::interpolate(const SimTK::Vector& x,
     return newY;
 }
 
+namespace {
+/// An entry in the store used by createSharedGCVSplineSet(). We keep a copy of
+/// the data so that hash collisions cannot return the wrong splines.
+struct SharedGCVSplineSetEntry {
+    std::vector<std::string> labels;
+    std::vector<double> time;
+    SimTK::Matrix data;
+    int degree;
+    /// Ready once the splines are fit (or fitting failed).
+    std::shared_future<void> fitted;
+    std::weak_ptr<const GCVSplineSet> splines;
+};
+std::size_t hashTable(const TimeSeriesTable& table, int degree) {
+    std::size_t seed = std::hash<int>()(degree);
+    auto combine = [&seed](std::size_t value) {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    };
+    for (const auto& label : table.getColumnLabels()) {
+        combine(std::hash<std::string>()(label));
+    }
+    for (const auto& time : table.getIndependentColumn()) {
+        combine(std::hash<double>()(time));
+    }
+    const auto& matrix = table.getMatrix();
+    for (int irow = 0; irow < matrix.nrow(); ++irow) {
+        for (int icol = 0; icol < matrix.ncol(); ++icol) {
+            combine(std::hash<double>()(matrix(irow, icol)));
+        }
+    }
+    return seed;
+}
+bool isEqual(const SimTK::Matrix& a, const SimTK::Matrix& b) {
+    if (a.nrow() != b.nrow() || a.ncol() != b.ncol()) return false;
+    for (int irow = 0; irow < a.nrow(); ++irow) {
+        for (int icol = 0; icol < a.ncol(); ++icol) {
+            if (a(irow, icol) != b(irow, icol)) return false;
+        }
+    }
+    return true;
+}
+} // anonymous namespace
+
+std::shared_ptr<const GCVSplineSet> OpenSim::createSharedGCVSplineSet(
+        const TimeSeriesTable& table, int degree) {
+    using Entry = SharedGCVSplineSetEntry;
+    static std::mutex storeMutex;
+    static std::unordered_multimap<std::size_t, std::shared_ptr<Entry>> store;
+
+    const auto key = hashTable(table, degree);
+    const auto& labels = table.getColumnLabels();
+    const auto& time = table.getIndependentColumn();
+    const auto& matrix = table.getMatrix();
+
+    auto isFitted = [](const Entry& entry) {
+        return entry.fitted.wait_for(std::chrono::seconds(0)) ==
+               std::future_status::ready;
+    };
+
+    // The lock is held only while accessing the store. Threads that request
+    // splines that another thread is fitting (e.g., while creating
+    // MocoProblemReps concurrently) wait for that thread to finish rather
+    // than fitting the splines again.
+    std::shared_ptr<Entry> entry;
+    std::promise<void> fitted;
+    while (!entry) {
+        std::shared_future<void> pending;
+        {
+            std::lock_guard<std::mutex> lock(storeMutex);
+            // Remove the entries for splines that are no longer in use, so
+            // that the copies of their data are freed.
+            for (auto it = store.begin(); it != store.end();) {
+                if (isFitted(*it->second) && it->second->splines.expired()) {
+                    it = store.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            auto range = store.equal_range(key);
+            for (auto it = range.first; it != range.second; ++it) {
+                const auto& candidate = *it->second;
+                if (candidate.degree == degree && candidate.labels == labels &&
+                        candidate.time == time &&
+                        isEqual(candidate.data, matrix)) {
+                    if (auto splines = candidate.splines.lock()) {
+                        return splines;
+                    }
+                    pending = candidate.fitted;
+                    break;
+                }
+            }
+            if (!pending.valid()) {
+                entry = std::make_shared<Entry>();
+                entry->labels = labels;
+                entry->time = time;
+                entry->data = matrix;
+                entry->degree = degree;
+                entry->fitted = fitted.get_future().share();
+                store.emplace(key, entry);
+            }
+        }
+        // Wait for the other thread, then look up its splines again. This
+        // rethrows the exception if the other thread failed.
+        if (pending.valid()) pending.get();
+    }
+
+    try {
+        // Fit the splines in parallel across columns.
+        const int numColumns = (int)table.getNumColumns();
+        const int numRows = (int)table.getNumRows();
+        std::vector<std::unique_ptr<GCVSpline>> columnSplines(numColumns);
+        std::vector<std::vector<double>> columnData(numColumns);
+        auto fitColumns = [&](int begin, int end) {
+            for (int icol = begin; icol < end; ++icol) {
+                auto& y = columnData[icol];
+                y.resize(numRows);
+                for (int irow = 0; irow < numRows; ++irow) {
+                    y[irow] = matrix(irow, icol);
+                }
+                columnSplines[icol] = OpenSim::make_unique<GCVSpline>(
+                        degree, numRows, time.data(), y.data(), labels[icol]);
+                // Functions create their underlying SimTK::Function lazily;
+                // do so now, before the splines are shared across threads.
+                columnSplines[icol]->calcValue(SimTK::Vector(1, time[0]));
+            }
+        };
+        parallelForBlocks(numColumns, getMocoNumThreads(-1, numColumns),
+                [&](int, int begin, int end) { fitColumns(begin, end); });
+
+        auto set = std::make_shared<GCVSplineSet>();
+        for (auto& spline : columnSplines) {
+            set->adoptAndAppend(spline.release());
+        }
+        std::shared_ptr<const GCVSplineSet> splines = std::move(set);
+        {
+            std::lock_guard<std::mutex> lock(storeMutex);
+            entry->splines = splines;
+        }
+        fitted.set_value();
+        return splines;
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(storeMutex);
+            auto range = store.equal_range(key);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == entry) {
+                    store.erase(it);
+                    break;
+                }
+            }
+        }
+        fitted.set_exception(std::current_exception());
+        throw;
+    }
+}
+
 Storage OpenSim::convertTableToStorage(const TimeSeriesTable& table) {
 
     Storage sto;
@@ -195,16 +368,120 @@ void OpenSim::updateStateLabels40(const Model& model,
     }
 }
 
+namespace {
+/// Returns false, with a warning, if the signal cannot be filtered because
+/// the cutoff frequency is not less than half the sampling frequency. Like
+/// Storage::lowpassIIR(), the signal is then left unfiltered.
+bool checkCutoffFrequency(double samplingInterval, double cutoffFreq) {
+    if (cutoffFreq < 0.5 / samplingInterval) return true;
+    std::cout << format("Warning: the cutoff frequency (%g Hz) is not less "
+                        "than half the sampling frequency (%g Hz); the signal "
+                        "was not filtered.",
+                         cutoffFreq, 0.5 / samplingInterval)
+              << std::endl;
+    return false;
+}
+} // anonymous namespace
+
 TimeSeriesTable OpenSim::filterLowpass(
         const TimeSeriesTable& table, double cutoffFreq, bool padData) {
     OPENSIM_THROW_IF(cutoffFreq < 0, Exception,
             format("Cutoff frequency must be non-negative; got %g.",
                     cutoffFreq));
-    auto storage = convertTableToStorage(table);
-    if (padData) { storage.pad((int)table.getNumRows() / 2); }
-    storage.lowpassIIR(cutoffFreq);
+    const int numRows = (int)table.getNumRows();
+    const int numColumns = (int)table.getNumColumns();
+    if (numRows < 2) return table;
+    const int padSize = padData ? numRows / 2 : 0;
+    std::vector<double> time = table.getIndependentColumn();
+    padSignal(padSize, time);
+    double samplingInterval = SimTK::Infinity;
+    for (int i = 1; i < (int)time.size(); ++i) {
+        samplingInterval = std::min(samplingInterval, time[i] - time[i - 1]);
+    }
+    OPENSIM_THROW_IF(samplingInterval <= 0, Exception,
+            "Expected the times in the table to be strictly increasing.");
+
+    // Warn once (rather than for each column) if the data cannot be
+    // filtered; the (padded) data is returned unfiltered.
+    const bool filter = checkCutoffFrequency(samplingInterval, cutoffFreq);
+
+    const auto& matrix = table.getMatrix();
+    SimTK::Matrix filtered((int)time.size(), numColumns);
+    auto filterColumns = [&](int begin, int end) {
+        std::vector<double> signal;
+        for (int icol = begin; icol < end; ++icol) {
+            signal.resize(numRows);
+            for (int irow = 0; irow < numRows; ++irow) {
+                signal[irow] = matrix(irow, icol);
+            }
+            padSignal(padSize, signal);
+            if (filter) {
+                filterLowpassInPlace(samplingInterval, cutoffFreq, signal);
+            }
+            for (int irow = 0; irow < (int)signal.size(); ++irow) {
+                filtered(irow, icol) = signal[irow];
+            }
+        }
+    };
+    parallelForBlocks(numColumns,
+            getMocoNumThreadsForColumns((int)time.size(), numColumns),
+            [&](int, int begin, int end) { filterColumns(begin, end); });
+
+    TimeSeriesTable out(time, filtered, table.getColumnLabels());
+    out.updTableMetaData() = table.getTableMetaData();
+    return out;
+}
 
-    return storage.exportToTable();
+void OpenSim::padSignal(int padSize, std::vector<double>& signal) {
+    if (padSize == 0 || signal.empty()) return;
+    const int size = (int)signal.size();
+    OPENSIM_THROW_IF(padSize < 0 || padSize > size - 1, Exception,
+            format("Expected padSize to be between 0 and %i, but got %i.",
+                    size - 1, padSize));
+    std::vector<double> padded(size + 2 * padSize);
+    for (int i = 0; i < padSize; ++i) {
+        padded[i] = 2 * signal[0] - signal[padSize - i];
+        padded[padSize + size + i] =
+                2 * signal[size - 1] - signal[size - 2 - i];
+    }
+    std::copy(signal.begin(), signal.end(), padded.begin() + padSize);
+    signal = std::move(padded);
+}
+
+void OpenSim::filterLowpassInPlace(double samplingInterval,
+        double cutoffFreq, std::vector<double>& signal) {
+    OPENSIM_THROW_IF(samplingInterval <= 0, Exception,
+            format("Expected a positive sampling interval, but got %g.",
+                    samplingInterval));
+    if (!checkCutoffFrequency(samplingInterval, cutoffFreq)) return;
+    // Third-order Butterworth coefficients from the bilinear transform.
+    const double wa = std::tan(SimTK::Pi * cutoffFreq * samplingInterval);
+    const double wa2 = wa * wa;
+    const double wa3 = wa2 * wa;
+    const double denom = 1.0 + 2.0 * wa + 2.0 * wa2 + wa3;
+    const double a0 = wa3 / denom;
+    const double a1 = 3.0 * a0;
+    const double b1 = (-3.0 - 2.0 * wa + 2.0 * wa2 + 3.0 * wa3) / denom;
+    const double b2 = (3.0 - 2.0 * wa - 2.0 * wa2 + 3.0 * wa3) / denom;
+    const double b3 = (-1.0 + 2.0 * wa - 2.0 * wa2 + wa3) / denom;
+
+    // Filter forward into `out`, then backward into `signal`. The first three
+    // samples of each pass are copied unfiltered.
+    const int size = (int)signal.size();
+    std::vector<double> out(signal);
+    for (int i = 3; i < size; ++i) {
+        out[i] = a0 * (signal[i] + signal[i - 3]) +
+                 a1 * (signal[i - 1] + signal[i - 2]) - b1 * out[i - 1] -
+                 b2 * out[i - 2] - b3 * out[i - 3];
+    }
+    std::reverse(out.begin(), out.end());
+    signal = out;
+    for (int i = 3; i < size; ++i) {
+        signal[i] = a0 * (out[i] + out[i - 3]) +
+                    a1 * (out[i - 1] + out[i - 2]) - b1 * signal[i - 1] -
+                    b2 * signal[i - 2] - b3 * signal[i - 3];
+    }
+    std::reverse(signal.begin(), signal.end());
 }
 
 void OpenSim::writeTableToFile(
@@ -488,6 +765,152 @@ MocoTrajectory OpenSim::simulateTrajectoryWithTimeStepping(
     return forwardSolution;
 }
 
+std::vector<MocoTrajectory> OpenSim::simulateTrajectoriesWithTimeStepping(
+        const std::vector<MocoTrajectory>& trajectories, Model model,
+        double integratorAccuracy, bool reportAtTrajectoryTimes,
+        int numThreads) {
+    const int numCases = (int)trajectories.size();
+    std::vector<MocoTrajectory> results(numCases);
+    if (!numCases) return results;
+    for (int icase = 0; icase < numCases; ++icase) {
+        OPENSIM_THROW_IF(trajectories[icase].getNumTimes() < 2, Exception,
+                format("Expected trajectory %i to have at least 2 times, "
+                       "but it has %i.",
+                        icase, trajectories[icase].getNumTimes()));
+    }
+
+    // Configure the model once. The control functions of the prescribed
+    // controller are replaced for each case.
+    prescribeControlsToModel(
+            trajectories[0], model, "PiecewiseLinearFunction");
+    model.initSystem();
+    std::vector<std::string> actuNames;
+    for (const auto& actu : model.getComponentList<Actuator>()) {
+        actuNames.push_back(actu.getAbsolutePathString());
+    }
+    std::unordered_map<int, int> yIndexMap;
+    const auto stateNames =
+            createStateVariableNamesInSystemOrder(model, yIndexMap);
+    const auto sysYIndices = createSystemYIndexMap(model);
+    std::vector<int> modelControlIndices;
+    const auto controlNames =
+            createControlNamesFromModel(model, modelControlIndices);
+    const int numStates = (int)stateNames.size();
+    const int numControls = (int)controlNames.size();
+
+    // Each thread takes the next unsimulated case until all cases are done.
+    std::atomic<int> nextCase(0);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto simulateCases = [&]() {
+        try {
+            // Each thread owns its own copy of the model and state.
+            Model localModel(model);
+            SimTK::State state = localModel.initSystem();
+            auto& controller = dynamic_cast<PrescribedController&>(
+                    localModel.updControllerSet().get(
+                            "prescribed_controller"));
+            SimTK::State defaultState = state;
+
+            int icase;
+            while ((icase = nextCase++) < numCases) {
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (error) return;
+                }
+                const auto& trajectory = trajectories[icase];
+                const SimTK::Vector& time = trajectory.getTime();
+                for (const auto& actuName : actuNames) {
+                    const auto& actu =
+                            localModel.getComponent<Actuator>(actuName);
+                    controller.prescribeControlForActuator(actu.getName(),
+                            createFunction<PiecewiseLinearFunction>(time,
+                                    trajectory.getControl(actuName))
+                                    .release());
+                }
+
+                SimTK::Vector reportTimes;
+                if (reportAtTrajectoryTimes) {
+                    reportTimes = time;
+                } else {
+                    const double initialTime = time[0];
+                    const double finalTime = time[time.size() - 1];
+                    const double interval = 0.001;
+                    const int numIntervals = (int)std::floor(
+                            (finalTime - initialTime) / interval + 1e-9);
+                    const bool includeFinal =
+                            initialTime + numIntervals * interval <
+                            finalTime - 1e-9;
+                    reportTimes.resize(numIntervals + 1 + includeFinal);
+                    for (int i = 0; i <= numIntervals; ++i) {
+                        reportTimes[i] = initialTime + i * interval;
+                    }
+                    if (includeFinal) {
+                        reportTimes[reportTimes.size() - 1] = finalTime;
+                    }
+                }
+
+                // Set the initial state.
+                state = defaultState;
+                state.setTime(time[0]);
+                const auto& initialStates =
+                        trajectory.getStatesTrajectory().row(0);
+                const auto& trajStateNames = trajectory.getStateNames();
+                for (int is = 0; is < (int)trajStateNames.size(); ++is) {
+                    const auto it = sysYIndices.find(trajStateNames[is]);
+                    OPENSIM_THROW_IF(it == sysYIndices.end(), Exception,
+                            format("State '%s' does not exist in the model.",
+                                    trajStateNames[is]));
+                    state.updY()[it->second] = initialStates[is];
+                }
+
+                Manager manager(localModel);
+                if (integratorAccuracy != -1) {
+                    manager.getIntegrator().setAccuracy(integratorAccuracy);
+                }
+                manager.initialize(state);
+
+                const int numReportTimes = reportTimes.size();
+                SimTK::Matrix states(numReportTimes, numStates);
+                SimTK::Matrix controls(numReportTimes, numControls);
+                for (int itime = 0; itime < numReportTimes; ++itime) {
+                    const SimTK::State& reportState =
+                            itime == 0 ? manager.getState()
+                                       : manager.integrate(reportTimes[itime]);
+                    const auto& y = reportState.getY();
+                    for (int is = 0; is < numStates; ++is) {
+                        states(itime, is) = y[yIndexMap.at(is)];
+                    }
+                    localModel.realizeVelocity(reportState);
+                    const auto& modelControls =
+                            localModel.getControls(reportState);
+                    for (int ic = 0; ic < numControls; ++ic) {
+                        controls(itime, ic) =
+                                modelControls[modelControlIndices[ic]];
+                    }
+                }
+                results[icase] = MocoTrajectory(reportTimes,
+                        {{"states", {stateNames, states}},
+                                {"controls", {controlNames, controls}}});
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+    };
+
+    const int numWorkers = getMocoNumThreads(numThreads, numCases);
+    std::vector<std::thread> workers;
+    for (int ithread = 1; ithread < numWorkers; ++ithread) {
+        workers.emplace_back(simulateCases);
+    }
+    simulateCases();
+    for (auto& worker : workers) worker.join();
+    if (error) std::rethrow_exception(error);
+
+    return results;
+}
+
 std::vector<std::string> OpenSim::createStateVariableNamesInSystemOrder(
         const Model& model) {
     std::unordered_map<int, int> yIndexMap;
@@ -796,6 +1219,197 @@ int OpenSim::getMocoParallelEnvironmentVariable() {
     return -1;
 }
 
+int OpenSim::getMocoNumThreads(int numThreads, int numTasks) {
+    OPENSIM_THROW_IF(numThreads < 1 && numThreads != -1, Exception,
+            format("Expected numThreads to be -1 or >= 1, but got %i.",
+                    numThreads));
+    if (numThreads == -1) {
+        const int parallel = getMocoParallelEnvironmentVariable();
+        if (parallel == 0) {
+            numThreads = 1;
+        } else {
+            numThreads = MocoThreadBudget::getNumCores();
+        }
+    }
+    return std::max(1, std::min(numThreads, numTasks));
+}
+
+int OpenSim::getMocoNumThreadsForColumns(int numRows, int numColumns) {
+    const int minValuesPerThread = 10000;
+    const long long numValues = (long long)numRows * numColumns;
+    const int numTasks = (int)std::min<long long>(
+            numColumns, numValues / minValuesPerThread);
+    return getMocoNumThreads(-1, numTasks);
+}
+
+void OpenSim::parallelForBlocks(int size, int numWorkers,
+        const std::function<void(int, int, int)>& function) {
+    if (size <= 0) return;
+    numWorkers = std::max(1, std::min(numWorkers, size));
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(numWorkers);
+    auto processBlock = [&](int worker) {
+        try {
+            function(worker, worker * size / numWorkers,
+                    (worker + 1) * size / numWorkers);
+        } catch (...) { errors[worker] = std::current_exception(); }
+    };
+    for (int worker = 1; worker < numWorkers; ++worker) {
+        workers.emplace_back(processBlock, worker);
+    }
+    processBlock(0);
+    for (auto& worker : workers) worker.join();
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+bool OpenSim::isVerbose(const MocoSolver& solver) {
+    const auto* dircol =
+            dynamic_cast<const MocoDirectCollocationSolver*>(&solver);
+    return !dircol || dircol->get_verbosity();
+}
+
+void ContentHasher::update(const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        m_hash ^= bytes[i];
+        m_hash *= 1099511628211ull;
+    }
+}
+
+void ContentHasher::update(const std::string& string) {
+    const std::size_t size = string.size();
+    update(&size, sizeof(size));
+    update(string.data(), size);
+}
+
+void ContentHasher::update(const TimeSeriesTable& table) {
+    for (const auto& label : table.getColumnLabels()) update(label);
+    const auto& time = table.getIndependentColumn();
+    update(time.data(), time.size() * sizeof(double));
+    const auto& matrix = table.getMatrix();
+    for (int icol = 0; icol < matrix.ncol(); ++icol) {
+        for (int irow = 0; irow < matrix.nrow(); ++irow) {
+            const double value = matrix(irow, icol);
+            update(&value, sizeof(value));
+        }
+    }
+}
+
+void ContentHasher::updateFromFile(const std::string& filepath) {
+    update(filepath);
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) {
+        update(std::string("<missing>"));
+        return;
+    }
+    char buffer[65536];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount()) {
+        update(buffer, (std::size_t)file.gcount());
+    }
+}
+
+void ContentHasher::updateFromSerialization(const Object& obj) {
+    SimTK::Xml::Document doc;
+    SimTK::Xml::Element root = doc.getRootElement();
+    obj.updateXMLNode(root);
+    SimTK::String xml;
+    doc.writeToString(xml);
+    update(xml);
+}
+
+void ContentHasher::updateFromReferencedData(const Object& obj) {
+    if (const auto* proc = dynamic_cast<const TableProcessor*>(&obj)) {
+        if (proc->hasInMemoryTable()) update(proc->getInMemoryTable());
+    }
+    if (const auto* extLoads = dynamic_cast<const ExternalLoads*>(&obj)) {
+        // The data file is located relative to the ExternalLoads file (if
+        // any), as in MocoContactTrackingGoal.
+        if (!extLoads->getDataFileName().empty()) {
+            updateFromFile(getAbsolutePathnameFromXMLDocument(
+                    extLoads->getDocumentFileName(),
+                    extLoads->getDataFileName()));
+        }
+    }
+    for (int iprop = 0; iprop < obj.getNumProperties(); ++iprop) {
+        const auto& prop = obj.getPropertyByIndex(iprop);
+        if (prop.isObjectProperty()) {
+            for (int i = 0; i < prop.size(); ++i) {
+                updateFromReferencedData(prop.getValueAsObject(i));
+            }
+        } else if (prop.getTypeName() == "string" &&
+                   (prop.getName() == "filepath" ||
+                           endsWith(prop.getName(), "_file"))) {
+            for (int i = 0; i < prop.size(); ++i) {
+                const auto& path = prop.getValue<std::string>(i);
+                if (path.empty()) continue;
+                updateFromFile(path);
+                // Hash the data files referenced from within XML files (e.g.,
+                // an ExternalLoads file given to ModOpAddExternalLoads or
+                // MocoContactTrackingGoal).
+                if (!endsWith(path, ".xml")) continue;
+                std::unique_ptr<Object> fileObj;
+                try {
+                    fileObj.reset(Object::makeObjectFromFile(path));
+                } catch (const std::exception&) {}
+                if (fileObj) updateFromReferencedData(*fileObj);
+            }
+        }
+    }
+}
+
+std::string ContentHasher::getHexDigest() const {
+    std::ostringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << m_hash;
+    return ss.str();
+}
+
+bool OpenSim::hasUnhashedReferenceData(const Object& obj) {
+    if (const auto* goal = dynamic_cast<const MocoGoal*>(&obj)) {
+        if (!goal->get_enabled()) return false;
+    }
+    auto isEmpty = [](const TableProcessor& proc) {
+        return proc.get_filepath().empty() && !proc.hasInMemoryTable();
+    };
+    if (const auto* goal =
+                    dynamic_cast<const MocoOrientationTrackingGoal*>(&obj)) {
+        if (goal->get_rotation_reference_file().empty() &&
+                isEmpty(goal->get_states_reference())) {
+            return true;
+        }
+    } else if (const auto* goal = dynamic_cast<
+                       const MocoTranslationTrackingGoal*>(&obj)) {
+        if (goal->get_translation_reference_file().empty() &&
+                isEmpty(goal->get_states_reference())) {
+            return true;
+        }
+    } else if (const auto* goal = dynamic_cast<
+                       const MocoAngularVelocityTrackingGoal*>(&obj)) {
+        if (goal->get_angular_velocity_reference_file().empty() &&
+                isEmpty(goal->get_states_reference())) {
+            return true;
+        }
+    } else if (const auto* goal = dynamic_cast<
+                       const MocoAccelerationTrackingGoal*>(&obj)) {
+        if (goal->get_acceleration_reference_file().empty()) return true;
+    } else if (const auto* ref = dynamic_cast<const MarkersReference*>(&obj)) {
+        if (ref->get_marker_file().empty() && ref->getNumRefs() > 0) {
+            return true;
+        }
+    }
+    for (int iprop = 0; iprop < obj.getNumProperties(); ++iprop) {
+        const auto& prop = obj.getPropertyByIndex(iprop);
+        if (!prop.isObjectProperty()) continue;
+        for (int i = 0; i < prop.size(); ++i) {
+            if (hasUnhashedReferenceData(prop.getValueAsObject(i))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 TimeSeriesTable OpenSim::createExternalLoadsTableForGait(Model model,
         const StatesTrajectory& trajectory,
         const std::vector<std::string>& forcePathsRightFoot,
@@ -32,9 +32,13 @@
 #include <Simulation/Model/Model.h>
 #include <Simulation/StatesTrajectory.h>
 #include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <regex>
 #include <set>
 #include <stack>
+#include <thread>
 
 #include <OpenSim/Common/GCVSplineSet.h>
 #include <OpenSim/Common/PiecewiseLinearFunction.h>
@@ -46,6 +50,7 @@ class StatesTrajectory;
 class Model;
 class MocoTrajectory;
 class MocoProblem;
+class MocoSolver;
 
 /// Since Moco does not require C++14 (which contains std::make_unique()),
 /// here is an implementation of make_unique().
@@ -212,6 +217,21 @@ inline std::unique_ptr<FunctionSet> createFunctionSet<GCVSpline>(
     return std::unique_ptr<GCVSplineSet>(new GCVSplineSet(table,
             std::vector<std::string>{}, std::min((int)time.size() - 1, 5)));
 }
+
+/// Obtain an immutable GCVSplineSet fit to the columns of the table (one
+/// spline per column, named after the column label). Sets are stored in a
+/// process-wide, reference-counted store keyed by the table's contents: if a
+/// set for an identical table (same labels, times, and data) and degree is
+/// still in use elsewhere (e.g., by a goal in another MocoProblemRep), that
+/// set is returned instead of fitting the splines again. Otherwise, the
+/// splines are fit in parallel across columns (see getMocoNumThreads()); if
+/// another thread is already fitting splines for an identical table, this
+/// waits for that thread instead. The store releases its copy of a table
+/// once the splines for the table are no longer in use. The returned set is
+/// safe to evaluate from multiple threads.
+/// @ingroup moconumutil
+OSIMMOCO_API std::shared_ptr<const GCVSplineSet> createSharedGCVSplineSet(
+        const TimeSeriesTable& table, int degree = 5);
 #endif // SWIG
 
 /// Resample (interpolate) the table at the provided times. In general, a
@@ -291,12 +311,32 @@ OSIMMOCO_API void updateStateLabels40(
         const Model& model, std::vector<std::string>& labels);
 
 /// Lowpass filter the data in a TimeSeriesTable at a provided cutoff frequency.
-/// The table is converted to a Storage object to use the lowpassIIR() method
-/// to filter, and then converted back to TimeSeriesTable.
+/// The columns of large tables are filtered in parallel (see
+/// getMocoNumThreadsForColumns()) with filterLowpassInPlace(). If padData is
+/// true, each column (and the time column) is first padded with half the
+/// number of rows at each end using padSignal(), and the padded rows are kept
+/// in the returned table. This gives the same result as Storage::pad() and
+/// Storage::lowpassIIR() without converting the table to a Storage.
 /// @ingroup moconumutil
 OSIMMOCO_API TimeSeriesTable filterLowpass(
         const TimeSeriesTable& table, double cutoffFreq, bool padData = false);
 
+/// Extend a signal by padSize points at each end by reflecting the signal
+/// about its end points and negating it (an odd extension), as
+/// Storage::pad() does. For a uniformly-sampled time column, this extends the
+/// time column with the same sampling interval.
+/// @ingroup moconumutil
+OSIMMOCO_API void padSignal(int padSize, std::vector<double>& signal);
+
+/// Filter a signal, sampled with the provided interval, with a zero-phase
+/// (forward and backward) third-order Butterworth lowpass filter, as
+/// Storage::lowpassIIR() does. If the cutoff frequency is not less than half
+/// the sampling frequency, this prints a warning and leaves the signal
+/// unfiltered (as Storage::lowpassIIR() does).
+/// @ingroup moconumutil
+OSIMMOCO_API void filterLowpassInPlace(double samplingInterval,
+        double cutoffFreq, std::vector<double>& signal);
+
 /// Write a single TimeSeriesTable to a file, using the FileAdapter associated
 /// with the provided file extension.
 /// @ingroup moconumutil
@@ -315,81 +355,69 @@ OSIMMOCO_API void visualize(Model, Storage);
 /// @ingroup mocomodelutil
 OSIMMOCO_API void visualize(Model, TimeSeriesTable);
 
-/// Calculate the requested outputs using the model in the problem and the
-/// states and controls in the MocoTrajectory.
-/// The output paths can be regular expressions. For example,
-/// ".*activation" gives the activation of all muscles.
-/// Constraints are not enforced but prescribed motion (e.g.,
-/// PositionMotion) is.
-/// The output paths must correspond to outputs that match the type provided in
-/// the template argument, otherwise they are not included in the report.
-/// @note Parameters and Lagrange multipliers in the MocoTrajectory are **not**
-///       applied to the model.
-/// @ingroup mocomodelutil
-template <typename T>
-TimeSeriesTable_<T> analyze(Model model, const MocoTrajectory& trajectory,
-        std::vector<std::string> outputPaths) {
-
-    // Initialize the system so we can access the outputs.
-    model.initSystem();
-    // Create the reporter object to which we'll add the output data to create
-    // the report.
-    auto* reporter = new TableReporter_<T>();
-    // Loop through all the outputs for all components in the model, and if
-    // the output path matches one provided in the argument and the output type
-    // agrees with the template argument type, add it to the report.
-    for (const auto& comp : model.getComponentList()) {
-        for (const auto& outputName : comp.getOutputNames()) {
-            const auto& output = comp.getOutput(outputName);
-            auto thisOutputPath = output.getPathName();
-            for (const auto& outputPathArg : outputPaths) {
-                if (std::regex_match(
-                            thisOutputPath, std::regex(outputPathArg))) {
-                    // Make sure the output type agrees with the template.
-                    if (dynamic_cast<const Output<T>*>(&output)) {
-                        reporter->addToReport(output);
-                    } else {
-                        std::cout << format("Warning: ignoring output %s of "
-                                            "type %s.",
-                                             output.getPathName(),
-                                             output.getTypeName())
-                                  << std::endl;
-                    }
-                }
-            }
-        }
-    }
-    model.addComponent(reporter);
-    model.initSystem();
-
-    // Get states trajectory.
-    Storage storage = trajectory.exportToStatesStorage();
-    auto statesTraj = StatesTrajectory::createFromStatesStorage(model, storage);
-
-    // Loop through the states trajectory to create the report.
-    for (int i = 0; i < (int)statesTraj.getSize(); ++i) {
-        // Get the current state.
-        auto state = statesTraj[i];
-
-        // Enforce any SimTK::Motion's included in the model.
-        model.getSystem().prescribe(state);
-
-        // Create a SimTK::Vector of the control values for the current state.
-        SimTK::RowVector controlsRow =
-                trajectory.getControlsTrajectory().row(i);
-        SimTK::Vector controls(controlsRow.size(),
-                controlsRow.getContiguousScalarData(), true);
+/// Determine the number of threads to use for numTasks independent tasks.
+/// - numThreads >= 1: use this number of threads.
+/// - numThreads == -1: use the OPENSIM_MOCO_PARALLEL environment variable
+///   (see getMocoParallelEnvironmentVariable()), or all cores in the
+///   MocoThreadBudget if the environment variable is not set.
+/// The result is at least 1 and never exceeds numTasks.
+/// @ingroup mocogenutil
+OSIMMOCO_API int getMocoNumThreads(int numThreads, int numTasks);
+
+/// For internal use. Determine the number of threads with which to process
+/// the columns of a table with the provided size (see getMocoNumThreads()).
+/// Each thread processes at least about 10000 values, since starting a
+/// thread costs more than filtering a small table.
+OSIMMOCO_API int getMocoNumThreadsForColumns(int numRows, int numColumns);
+
+/// For internal use. Divide the indices [0, size) into numWorkers contiguous
+/// blocks and invoke `function(worker, begin, end)` for each block; block 0
+/// is processed on the calling thread and each other block on its own
+/// thread. numWorkers is clamped to [1, size]. After all blocks are
+/// processed, the exception from the first block that threw (if any) is
+/// rethrown.
+OSIMMOCO_API void parallelForBlocks(int size, int numWorkers,
+        const std::function<void(int worker, int begin, int end)>& function);
+
+/// For internal use. Progress messages from MocoStudy and MocoTrack follow
+/// the solver's verbosity; solvers without a verbosity setting are verbose.
+/// @ingroup mocogenutil
+OSIMMOCO_API bool isVerbose(const MocoSolver& solver);
 
-        // Set the controls on the state object.
-        model.realizeVelocity(state);
-        model.setControls(state, controls);
+/// For internal use. Hash (64-bit FNV-1a) an object's serialization and the
+/// data it references (e.g., files), to identify solutions in MocoStudy's
+/// cache and problems in MocoCasADiSolver's checkpoints. Unlike std::hash,
+/// the result does not depend on the standard library implementation, so it
+/// is stable across builds.
+/// @ingroup mocogenutil
+class OSIMMOCO_API ContentHasher {
+public:
+    void update(const void* data, std::size_t size);
+    /// The length is included so that consecutive strings are delimited.
+    void update(const std::string& string);
+    void update(const TimeSeriesTable& table);
+    /// Hash the path and the contents of the file.
+    void updateFromFile(const std::string& filepath);
+    /// Hash the object's XML serialization.
+    void updateFromSerialization(const Object& obj);
+    /// Hash the data referenced by the object's properties that is not part
+    /// of the object's serialization: files given by `filepath` and `*_file`
+    /// properties, the data referenced by objects in XML files given by these
+    /// properties (e.g., the data file of an ExternalLoads file), the data
+    /// files of ExternalLoads, and the in-memory tables of TableProcessors.
+    void updateFromReferencedData(const Object& obj);
+    std::string getHexDigest() const;
 
-        // Generate report results for the current state.
-        model.realizeReport(state);
-    }
+private:
+    std::uint64_t m_hash = 14695981039346656037ull;
+};
 
-    return reporter->getTable();
-}
+/// For internal use. Returns true if an enabled goal in the object holds
+/// reference data in memory outside of its properties (e.g., a
+/// MarkersReference created from a TimeSeriesTable_<SimTK::Vec3>). This data
+/// is not hashed by ContentHasher.
+/// @ingroup mocogenutil
+OSIMMOCO_API bool hasUnhashedReferenceData(const Object& obj);
 
 /// Given a MocoTrajectory and the associated OpenSim model, return the model
 /// with a prescribed controller appended that will compute the control values
@@ -411,6 +439,30 @@ OSIMMOCO_API MocoTrajectory simulateTrajectoryWithTimeStepping(
         const MocoTrajectory& trajectory, Model model,
         double integratorAccuracy = -1);
 
+/// Simulate a batch of trajectories with time stepping. This is equivalent to
+/// calling simulateTrajectoryWithTimeStepping() on each trajectory, but the
+/// model (with its prescribed controller) is configured only once and the
+/// cases are integrated concurrently, with each thread owning its own copy of
+/// the model and its own SimTK::State. Every trajectory must contain controls
+/// for all actuators in the model; the initial state of each simulation is
+/// taken from the first row of the trajectory's states (states missing from
+/// the trajectory keep their default values). To simulate N control sets for
+/// one model, provide N trajectories that share the same initial state.
+///
+/// If reportAtTrajectoryTimes is true, the states and controls are reported
+/// only at the times of each input trajectory (e.g., the solution grid);
+/// otherwise, they are reported every millisecond, as in
+/// simulateTrajectoryWithTimeStepping(). The controls in the returned
+/// trajectories are computed by the model's controllers at the reported
+/// states.
+///
+/// See getMocoNumThreads() for the meaning of numThreads.
+/// @ingroup mocomodelutil
+OSIMMOCO_API std::vector<MocoTrajectory> simulateTrajectoriesWithTimeStepping(
+        const std::vector<MocoTrajectory>& trajectories, Model model,
+        double integratorAccuracy = -1, bool reportAtTrajectoryTimes = false,
+        int numThreads = -1);
+
 /// The map provides the index of each state variable in
 /// SimTK::State::getY() from its each state variable path string.
 /// Empty slots in Y (e.g., for quaternions) are ignored.
@@ -435,6 +487,147 @@ OSIMMOCO_API
 std::unordered_map<std::string, int> createSystemYIndexMap(const Model& model);
 #endif
 
+/// Calculate the requested outputs using the model in the problem and the
+/// states and controls in the MocoTrajectory.
+/// The output paths can be regular expressions. For example,
+/// ".*activation" gives the activation of all muscles.
+/// Constraints are not enforced but prescribed motion (e.g.,
+/// PositionMotion) is.
+/// The output paths must correspond to outputs that match the type provided in
+/// the template argument, otherwise they are not included in the report.
+/// The states are realized only to the latest stage on which the requested
+/// outputs depend. By default, the time points are analyzed on the calling
+/// thread. To divide them among threads, each of which uses its own copy of
+/// the model, pass numThreads > 1, or -1 to use the thread budget (see
+/// getMocoNumThreads()).
+/// @note Parameters and Lagrange multipliers in the MocoTrajectory are **not**
+///       applied to the model.
+/// @ingroup mocomodelutil
+template <typename T>
+TimeSeriesTable_<T> analyze(Model model, const MocoTrajectory& trajectory,
+        std::vector<std::string> outputPaths, int numThreads = 1) {
+
+    // Initialize the system so we can access the outputs.
+    const SimTK::State defaultState = model.initSystem();
+
+    // Loop through all the outputs for all components in the model, and if
+    // the output path matches one provided in the argument and the output type
+    // agrees with the template argument type, add it to the report.
+    std::vector<std::regex> patterns;
+    for (const auto& outputPathArg : outputPaths) {
+        patterns.emplace_back(outputPathArg);
+    }
+    // Pairs of component path and output name.
+    std::vector<std::pair<std::string, std::string>> outputs;
+    std::vector<std::string> labels;
+    SimTK::Stage stage = SimTK::Stage::Model;
+    for (const auto& comp : model.getComponentList()) {
+        for (const auto& outputName : comp.getOutputNames()) {
+            const auto& output = comp.getOutput(outputName);
+            auto thisOutputPath = output.getPathName();
+            for (const auto& pattern : patterns) {
+                if (std::regex_match(thisOutputPath, pattern)) {
+                    // Make sure the output type agrees with the template.
+                    if (dynamic_cast<const Output<T>*>(&output)) {
+                        outputs.emplace_back(
+                                comp.getAbsolutePathString(), outputName);
+                        labels.push_back(thisOutputPath);
+                        if (output.getDependsOnStage() > stage) {
+                            stage = output.getDependsOnStage();
+                        }
+                    } else {
+                        std::cout << format("Warning: ignoring output %s of "
+                                            "type %s.",
+                                             output.getPathName(),
+                                             output.getTypeName())
+                                  << std::endl;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    // Map the trajectory's states directly to indices in SimTK::State::getY().
+    const auto sysYIndices = createSystemYIndexMap(model);
+    const auto& stateNames = trajectory.getStateNames();
+    std::vector<int> yIndices;
+    for (const auto& stateName : stateNames) {
+        const auto it = sysYIndices.find(stateName);
+        OPENSIM_THROW_IF(it == sysYIndices.end(), Exception,
+                format("State '%s' does not exist in the model.", stateName));
+        yIndices.push_back(it->second);
+    }
+    OPENSIM_THROW_IF(yIndices.size() != sysYIndices.size(), Exception,
+            format("Expected the trajectory to contain all %i states in the "
+                   "model, but it contains %i states.",
+                    sysYIndices.size(), yIndices.size()));
+
+    const int numTimes = trajectory.getNumTimes();
+    const auto& time = trajectory.getTime();
+    const auto& statesTraj = trajectory.getStatesTrajectory();
+    const auto& controlsTraj = trajectory.getControlsTrajectory();
+    SimTK::Matrix_<T> data(numTimes, (int)outputs.size());
+
+    // Each thread fills a contiguous block of rows of the preallocated
+    // matrix.
+    // The state must belong to localModel's System.
+    auto analyzeTimes = [&](const Model& localModel, SimTK::State state,
+                                int begin, int end) {
+        std::vector<const Output<T>*> localOutputs;
+        for (const auto& output : outputs) {
+            localOutputs.push_back(dynamic_cast<const Output<T>*>(
+                    &localModel.getComponent(output.first)
+                             .getOutput(output.second)));
+        }
+        SimTK::Vector controls(controlsTraj.ncol());
+        for (int i = begin; i < end; ++i) {
+            state.setTime(time[i]);
+            for (int is = 0; is < (int)yIndices.size(); ++is) {
+                state.updY()[yIndices[is]] = statesTraj(i, is);
+            }
+
+            // Enforce any SimTK::Motion's included in the model.
+            localModel.getSystem().prescribe(state);
+
+            if (stage >= SimTK::Stage::Velocity) {
+                // Set the controls on the state object.
+                localModel.realizeVelocity(state);
+                for (int ic = 0; ic < controls.size(); ++ic) {
+                    controls[ic] = controlsTraj(i, ic);
+                }
+                localModel.setControls(state, controls);
+            }
+            localModel.getSystem().realize(state, stage);
+
+            for (int io = 0; io < (int)localOutputs.size(); ++io) {
+                data(i, io) = localOutputs[io]->getValue(state);
+            }
+        }
+    };
+
+    const int numWorkers = getMocoNumThreads(numThreads, numTimes);
+    // Copy the model for each worker before any thread realizes the model.
+    std::vector<std::unique_ptr<Model>> localModels;
+    for (int ithread = 1; ithread < numWorkers; ++ithread) {
+        localModels.push_back(OpenSim::make_unique<Model>(model));
+    }
+    parallelForBlocks(numTimes, numWorkers, [&](int worker, int begin,
+                                                    int end) {
+        if (worker == 0) {
+            analyzeTimes(model, defaultState, begin, end);
+        } else {
+            Model& localModel = *localModels[worker - 1];
+            SimTK::State localState = localModel.initSystem();
+            analyzeTimes(localModel, localState, begin, end);
+        }
+    });
+
+    std::vector<double> timeVec(time.getContiguousScalarData(),
+            time.getContiguousScalarData() + numTimes);
+    return TimeSeriesTable_<T>(timeVec, data, labels);
+}
+
 /// Create a vector of control names based on the actuators in the model for
 /// which appliesForce == True. For actuators with one control (e.g.
 /// ScalarActuator) the control name is simply the actuator name. For actuators
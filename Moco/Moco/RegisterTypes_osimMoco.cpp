@@ -50,6 +50,7 @@
 #include "MocoInverse.h"
 #include "MocoParameter.h"
 #include "MocoProblem.h"
+#include "MocoStage.h"
 #include "MocoStudy.h"
 #include "MocoTrack.h"
 #include "MocoTropterSolver.h"
@@ -94,6 +95,7 @@ OSIMMOCO_API void RegisterTypes_osimMoco() {
         Object::registerType(MocoParameter());
         Object::registerType(MocoPhase());
         Object::registerType(MocoProblem());
+        Object::registerType(MocoStage());
         Object::registerType(MocoStudy());
 
         Object::registerType(MocoInverse());
@@ -126,6 +128,7 @@ OSIMMOCO_API void RegisterTypes_osimMoco() {
         Object::registerType(AckermannVanDenBogert2010Force());
         Object::registerType(MeyerFregly2016Force());
         Object::registerType(EspositoMiller2018Force());
+        Object::registerType(StationPlaneContactForceGroup());
         Object::registerType(PositionMotion());
         Object::registerType(DeGrooteFregly2016Muscle());
         Object::registerType(MultivariatePolynomialFunction());
@@ -52,10 +52,12 @@
 #include "MocoParameter.h"
 #include "MocoProblem.h"
 #include "MocoSolver.h"
+#include "MocoStage.h"
 #include "MocoStudy.h"
 #include "MocoStudyFactory.h"
 #include "MocoTrack.h"
 #include "MocoTrajectory.h"
+#include "MocoThreadBudget.h"
 #include "MocoTropterSolver.h"
 #include "MocoUtilities.h"
 #include "MocoWeightSet.h"
@@ -534,6 +534,67 @@ TEST_CASE("testStationPlaneContactForce EspositoMiller2018Force") {
     testStationPlaneContactForce(createEspositoMiller);
 }
 
+TEST_CASE("StationPlaneContactForceGroup") {
+    Model model(create2DPointMassModel(createEspositoMiller));
+    auto* station = new Station();
+    station->setName("contact_point2");
+    station->connectSocket_parent_frame(
+            model.getComponent<PhysicalFrame>("body"));
+    station->set_location(Vec3(0.1, -0.05, 0));
+    model.addComponent(station);
+    auto* force = createEspositoMiller();
+    force->setName("contact2");
+    model.addComponent(force);
+    force->connectSocket_station(*station);
+
+    auto* group = new StationPlaneContactForceGroup();
+    group->setName("contact_group");
+    group->addContactForce("/contact");
+    group->addContactForce("/contact2");
+    model.addComponent(group);
+
+    SimTK::State state = model.initSystem();
+    model.setStateVariableValue(state, "ty/ty/value", -0.01);
+    model.setStateVariableValue(state, "tx/tx/speed", 0.3);
+    model.setStateVariableValue(state, "ty/ty/speed", -0.2);
+    model.realizeVelocity(state);
+
+    const auto& contact1 =
+            model.getComponent<StationPlaneContactForce>("contact");
+    const auto& contact2 =
+            model.getComponent<StationPlaneContactForce>("contact2");
+    const Vec3 expected1 = contact1.calcContactForceOnStation(state);
+    const Vec3 expected2 = contact2.calcContactForceOnStation(state);
+    CHECK(expected1[1] > 0);
+    CHECK(expected2[1] > expected1[1]);
+
+    const auto& forces = group->getContactForces(state);
+    REQUIRE(forces.size() == 2);
+    SimTK_TEST_EQ(forces[0], expected1);
+    SimTK_TEST_EQ(forces[1], expected2);
+    SimTK_TEST_EQ(group->getNetContactForce(state), expected1 + expected2);
+    // The group stored the forces in each contact force's cache.
+    SimTK_TEST_EQ(contact1.getContactForceOnStation(state), expected1);
+    SimTK_TEST_EQ(
+            contact2.getOutputValue<Vec3>(state, "force_on_station"),
+            expected2);
+
+    // Changing the state invalidates the cached forces.
+    model.setStateVariableValue(state, "ty/ty/speed", 0);
+    model.realizeVelocity(state);
+    SimTK_TEST_EQ(group->getContactForces(state)[0],
+            contact1.calcContactForceOnStation(state));
+
+    // Applying the forces evaluates the group.
+    model.setStateVariableValue(state, "ty/ty/speed", -0.1);
+    model.realizeVelocity(state);
+    CHECK(!group->isCacheVariableValid(state, "contact_forces"));
+    model.realizeDynamics(state);
+    CHECK(group->isCacheVariableValid(state, "contact_forces"));
+    SimTK_TEST_EQ(group->getContactForces(state)[1],
+            contact2.calcContactForceOnStation(state));
+}
+
 // TODO does not pass:
 // TEST_CASE("testStationPlaneContactForce MeyerFregly2016Force") {
 //     testStationPlaneContactForce(createMeyerFregly);
@@ -639,3 +700,64 @@ TEST_CASE("MocoContactTrackingGoal") {
             externalLoadsTimeStepping, "ground_force_r_vy",
             0.5);
 }
+
+TEST_CASE("MocoContactTrackingGoal with StationPlaneContactForce") {
+    Model model(create2DPointMassModel(createEspositoMiller));
+    SimTK::State state = model.initSystem();
+    model.setStateVariableValue(state, "ty/ty/value", -0.01);
+    model.setStateVariableValue(state, "tx/tx/speed", 0.3);
+    model.setStateVariableValue(state, "ty/ty/speed", -0.2);
+    model.realizeVelocity(state);
+    // The force on the body, expressed in ground.
+    const Vec3 force = model.getComponent<StationPlaneContactForce>("contact")
+                               .calcContactForceOnStation(state);
+    REQUIRE(force[0] != 0);
+    REQUIRE(force[1] > 0);
+
+    const std::string dataFileName =
+            "testContact_MocoContactTrackingGoal_station_external_loads.sto";
+    auto calcIntegrand = [&](const std::string& appliedToBody,
+                                 const Vec3& refForce,
+                                 const std::string& projection) {
+        TimeSeriesTable data;
+        data.setColumnLabels(
+                {"ground_force_vx", "ground_force_vy", "ground_force_vz"});
+        for (int i = 0; i <= 10; ++i) {
+            data.appendRow(0.1 * i, {refForce[0], refForce[1], refForce[2]});
+        }
+        STOFileAdapter::write(data, dataFileName);
+
+        ExternalLoads extLoads;
+        extLoads.setDataFileName(dataFileName);
+        auto extForce = make_unique<ExternalForce>();
+        extForce->setName("contact");
+        extForce->set_applied_to_body(appliedToBody);
+        extForce->set_force_identifier("ground_force_v");
+        extLoads.adoptAndAppend(extForce.release());
+
+        MocoContactTrackingGoal goal;
+        goal.setExternalLoads(extLoads);
+        goal.addContactGroup({"/contact"}, "contact");
+        if (projection != "none") {
+            goal.setProjection(projection);
+            goal.setProjectionVector(Vec3(0, 1, 0));
+        }
+        goal.initializeOnModel(model);
+        return goal.calcIntegrand(state);
+    };
+
+    const double normSqr = force.normSqr();
+    // ExternalForce applied to the station's body.
+    CHECK(calcIntegrand("body", Vec3(0), "none") == Approx(normSqr));
+    CHECK(calcIntegrand("body", force, "none") ==
+            Approx(0).margin(1e-6 * normSqr));
+    // ExternalForce applied to ground (the plane): the sign flips.
+    CHECK(calcIntegrand("ground", -force, "none") ==
+            Approx(0).margin(1e-6 * normSqr));
+    CHECK(calcIntegrand("ground", force, "none") == Approx(4 * normSqr));
+    // Projections.
+    CHECK(calcIntegrand("body", Vec3(0), "vector") ==
+            Approx(SimTK::square(force[1])));
+    CHECK(calcIntegrand("body", Vec3(0), "plane") ==
+            Approx(SimTK::square(force[0]) + SimTK::square(force[2])));
+}
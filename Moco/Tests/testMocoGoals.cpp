@@ -669,6 +669,190 @@ TEMPLATE_TEST_CASE("Endpoint constraint with integral", "", MocoCasADiSolver) {
     CHECK(solution.getControlsTrajectory().norm() < 1e-3);
 }
 
+/// Evaluate a goal or path constraint through the model (callbacks), even
+/// though it has an algebraic form.
+template <typename T>
+class WithoutAlgebraicForm : public T {
+    OpenSim_DECLARE_CONCRETE_OBJECT_T(WithoutAlgebraicForm, T, T);
+
+protected:
+    bool getAlgebraicFormImpl(MocoAlgebraicForm&) const override {
+        return false;
+    }
+};
+
+template <typename T>
+T* addGoal(MocoProblem& problem, bool algebraic) {
+    if (algebraic) return problem.addGoal<T>();
+    return problem.addGoal<WithoutAlgebraicForm<T>>();
+}
+
+template <typename T>
+T* addPathConstraint(MocoProblem& problem, bool algebraic) {
+    if (algebraic) return problem.addPathConstraint<T>();
+    return problem.addPathConstraint<WithoutAlgebraicForm<T>>();
+}
+
+TEMPLATE_TEST_CASE("Goals with an algebraic form", "", MocoCasADiSolver) {
+    auto createStudy = []() {
+        MocoStudy study;
+        MocoProblem& problem = study.updProblem();
+        problem.setModel(createSlidingMassModel());
+        problem.setTimeBounds(0, 2);
+        problem.setStateInfo("/slider/position/value", {0, 1}, 0, 1);
+        problem.setStateInfo("/slider/position/speed", {-100, 100}, 0, 0);
+        problem.setControlInfo("/actuator", MocoBounds(-10, 10));
+        auto& solver = study.initSolver<TestType>();
+        solver.set_num_mesh_intervals(20);
+        return study;
+    };
+
+    SECTION("Availability") {
+        auto study = createStudy();
+        auto& problem = study.updProblem();
+        auto* effort = problem.addGoal<MocoControlGoal>("effort");
+        problem.addGoal<MocoControlGoalWithEndpointConstraint>("custom");
+        {
+            MocoProblemRep rep = problem.createRep();
+            MocoAlgebraicForm form;
+            CHECK(rep.getCost("effort").getAlgebraicForm(form));
+            CHECK(form.integrand.size() == 1);
+            CHECK(form.outputs.size() == 1);
+            CHECK_FALSE(rep.getCost("custom").getAlgebraicForm(form));
+        }
+        // Dividing by displacement requires the model.
+        effort->setDivideByDisplacement(true);
+        {
+            MocoProblemRep rep = problem.createRep();
+            MocoAlgebraicForm form;
+            CHECK_FALSE(rep.getCost("effort").getAlgebraicForm(form));
+        }
+    }
+
+    SECTION("Symbolic and callback goals give the same solution") {
+        // MocoControlGoal is evaluated symbolically, while
+        // MocoControlGoalWithEndpointConstraint computes the same cost using
+        // the model.
+        MocoSolution solutionAlgebraic;
+        {
+            auto study = createStudy();
+            study.updProblem().addGoal<MocoControlGoal>();
+            solutionAlgebraic = study.solve();
+        }
+        MocoSolution solutionCallback;
+        {
+            auto study = createStudy();
+            auto* goal = study.updProblem().addGoal<
+                    MocoControlGoalWithEndpointConstraint>();
+            goal->setMode("cost");
+            solutionCallback = study.solve();
+        }
+        CHECK(solutionAlgebraic.getObjective() ==
+                Approx(solutionCallback.getObjective()).epsilon(1e-5));
+        CHECK(solutionAlgebraic.compareContinuousVariablesRMS(
+                      solutionCallback) < 1e-4);
+    }
+
+    // Solve each problem with its goals and path constraints evaluated
+    // symbolically and with the same terms evaluated through the model.
+    auto compare = [](const std::function<MocoStudy(bool)>& createProblem) {
+        MocoSolution solutionAlgebraic = createProblem(true).solve();
+        MocoSolution solutionCallback = createProblem(false).solve();
+        REQUIRE(solutionAlgebraic.success());
+        REQUIRE(solutionCallback.success());
+        CHECK(solutionAlgebraic.getObjective() ==
+                Approx(solutionCallback.getObjective()).epsilon(1e-5));
+        CHECK(solutionAlgebraic.compareContinuousVariablesRMS(
+                      solutionCallback) < 1e-4);
+    };
+
+    SECTION("MocoControlGoal") {
+        compare([&](bool algebraic) {
+            auto study = createStudy();
+            addGoal<MocoControlGoal>(study.updProblem(), algebraic)
+                    ->setExponent(4);
+            return study;
+        });
+    }
+
+    SECTION("MocoSumSquaredStateGoal") {
+        compare([&](bool algebraic) {
+            auto study = createStudy();
+            auto& problem = study.updProblem();
+            addGoal<MocoControlGoal>(problem, algebraic);
+            addGoal<MocoSumSquaredStateGoal>(problem, algebraic)
+                    ->setWeightForState("/slider/position/speed", 0.5);
+            return study;
+        });
+    }
+
+    SECTION("MocoPeriodicityGoal") {
+        compare([&](bool algebraic) {
+            auto study = createStudy();
+            auto& problem = study.updProblem();
+            problem.setStateInfo("/slider/position/speed", {-100, 100}, 0);
+            addGoal<MocoControlGoal>(problem, algebraic);
+            auto* periodic = addGoal<MocoPeriodicityGoal>(problem, algebraic);
+            periodic->addStatePair(
+                    MocoPeriodicityGoalPair("/slider/position/speed"));
+            periodic->addControlPair(MocoPeriodicityGoalPair("/actuator"));
+            return study;
+        });
+    }
+
+    SECTION("MocoFinalTimeGoal") {
+        compare([&](bool algebraic) {
+            auto study = createStudy();
+            auto& problem = study.updProblem();
+            problem.setTimeBounds(0, {1, 3});
+            addGoal<MocoControlGoal>(problem, algebraic)->setWeight(0.1);
+            addGoal<MocoFinalTimeGoal>(problem, algebraic);
+            return study;
+        });
+    }
+
+    SECTION("MocoControlBoundConstraint") {
+        compare([&](bool algebraic) {
+            auto study = createStudy();
+            auto& problem = study.updProblem();
+            addGoal<MocoControlGoal>(problem, algebraic);
+            // The minimum-effort control exceeds these bounds.
+            auto* bounds = addPathConstraint<MocoControlBoundConstraint>(
+                    problem, algebraic);
+            bounds->addControlPath("/actuator");
+            bounds->setLowerBound(Constant(-1.2));
+            bounds->setUpperBound(Constant(1.2));
+            return study;
+        });
+    }
+
+    SECTION("Prescribed kinematics") {
+        // The CasOC problem has no coordinates or speeds, so the remaining
+        // states (here, muscle activations) must be offset correctly.
+        Model model = ModelFactory::createSyntheticModel(1, 2);
+        model.initSystem();
+        auto* motion = new PositionMotion();
+        motion->setPositionForCoordinate(
+                model.getCoordinateSet().get(0), LinearFunction(0.5, 0.1));
+        model.addModelComponent(motion);
+        compare([&](bool algebraic) {
+            MocoStudy study;
+            auto& problem = study.updProblem();
+            problem.setModelCopy(model);
+            problem.setTimeBounds(0, 0.5);
+            addGoal<MocoControlGoal>(problem, algebraic);
+            addGoal<MocoSumSquaredStateGoal>(problem, algebraic)
+                    ->setPattern(".*activation");
+            addGoal<MocoInitialActivationGoal>(problem, algebraic);
+            auto& solver = study.initSolver<TestType>();
+            solver.set_multibody_dynamics_mode("implicit");
+            solver.set_interpolate_control_midpoints(false);
+            solver.set_num_mesh_intervals(10);
+            return study;
+        });
+    }
+}
+
 class MySumSquaredControls : public ModelComponent {
     OpenSim_DECLARE_CONCRETE_OBJECT(MySumSquaredControls, ModelComponent);
 public:
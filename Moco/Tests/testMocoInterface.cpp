@@ -19,7 +19,10 @@
 #define CATCH_CONFIG_MAIN
 #include "Testing.h"
 #include <Moco/osimMoco.h>
+#include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <thread>
 
 #include <OpenSim/Actuators/BodyActuator.h>
 #include <OpenSim/Actuators/CoordinateActuator.h>
@@ -29,6 +32,12 @@
 #include <OpenSim/Simulation/SimbodyEngine/PinJoint.h>
 #include <OpenSim/Simulation/SimbodyEngine/SliderJoint.h>
 
+#ifndef _WIN32
+#include <dirent.h>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#endif
+
 using namespace OpenSim;
 
 // TODO
@@ -1752,6 +1761,283 @@ TEMPLATE_TEST_CASE("Sliding mass", "", MocoTropterSolver, MocoCasADiSolver) {
     }
 }
 
+TEST_CASE("MocoCasADiSolver sx_transcription_formulas") {
+    std::string scheme = GENERATE(as<std::string>{}, "trapezoidal",
+            "hermite-simpson");
+    MocoStudy study = createSlidingMassMocoStudy<MocoCasADiSolver>();
+    auto& solver = study.updSolver<MocoCasADiSolver>();
+    solver.set_transcription_scheme(scheme);
+    solver.set_sx_transcription_formulas(false);
+    MocoSolution solutionMX = study.solve();
+    solver.set_sx_transcription_formulas(true);
+    MocoSolution solutionSX = study.solve();
+    CHECK(solutionSX.isNumericallyEqual(solutionMX, 1e-6));
+    CHECK(solutionSX.getNumIterations() == solutionMX.getNumIterations());
+}
+
+TEST_CASE("MocoCasADiSolver eliminate_interpolated_control_midpoints") {
+    MocoStudy study = createSlidingMassMocoStudy<MocoCasADiSolver>();
+    auto& solver = study.updSolver<MocoCasADiSolver>();
+    solver.set_transcription_scheme("hermite-simpson");
+    solver.set_interpolate_control_midpoints(true);
+    solver.set_eliminate_interpolated_control_midpoints(false);
+    MocoSolution solutionConstrained = study.solve();
+    solver.set_eliminate_interpolated_control_midpoints(true);
+    MocoSolution solutionEliminated = study.solve();
+    CHECK(solutionEliminated.isNumericallyEqual(solutionConstrained, 1e-5));
+
+    // The midpoint controls are exactly the average of the mesh point
+    // controls.
+    const auto controls = solutionEliminated.getControlsTrajectory();
+    for (int i = 1; i < controls.nrow() - 1; i += 2) {
+        CHECK(controls(i, 0) ==
+                Approx(0.5 * (controls(i - 1, 0) + controls(i + 1, 0)))
+                        .epsilon(1e-12));
+    }
+}
+
+TEST_CASE("MocoCasADiSolver compile_sx_functions") {
+    MocoStudy study = createSlidingMassMocoStudy<MocoCasADiSolver>();
+    auto& solver = study.updSolver<MocoCasADiSolver>();
+    solver.set_sx_transcription_formulas(true);
+    MocoSolution uncompiled = study.solve();
+    const std::string cacheDir = "testMocoInterface_compiled_functions";
+    solver.set_compile_sx_functions(true);
+    solver.set_compiled_functions_cache_dir(cacheDir);
+#ifdef _WIN32
+    CHECK_THROWS_WITH(study.solve(), Catch::Contains("not supported"));
+#else
+    MocoSolution compiled = study.solve();
+    REQUIRE(compiled.success());
+    CHECK(compiled.isNumericallyEqual(uncompiled, 1e-6));
+    // The second solve loads the cached libraries.
+    MocoSolution cached = study.solve();
+    CHECK(cached.isNumericallyEqual(compiled, 1e-6));
+
+    // A library is not used if its source does not match the generated code.
+    std::vector<std::string> sources;
+    DIR* dir = opendir(cacheDir.c_str());
+    REQUIRE(dir);
+    while (dirent* entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name.size() > 2 && name.substr(name.size() - 2) == ".c") {
+            sources.push_back(cacheDir + "/" + name);
+        }
+    }
+    closedir(dir);
+    REQUIRE(!sources.empty());
+    for (const auto& source : sources) {
+        std::ofstream(source) << "/* modified */";
+    }
+    MocoSolution rebuilt = study.solve();
+    CHECK(rebuilt.isNumericallyEqual(compiled, 1e-6));
+    for (const auto& source : sources) {
+        std::ifstream stream(source);
+        std::string firstLine;
+        std::getline(stream, firstLine);
+        CHECK(firstLine != "/* modified */");
+    }
+
+    // Libraries are not loaded from a directory that others can modify.
+    chmod(cacheDir.c_str(), 0777);
+    CHECK_THROWS_WITH(study.solve(),
+            Catch::Contains("not be writable by other users"));
+    chmod(cacheDir.c_str(), 0700);
+#endif
+}
+
+TEST_CASE("MocoCasADiSolver parallel_auto_tune") {
+    MocoStudy study = createSlidingMassMocoStudy<MocoCasADiSolver>();
+    auto& solver = study.updSolver<MocoCasADiSolver>();
+    solver.set_parallel(0);
+    MocoSolution serial = study.solve();
+    CHECK(serial.getNumThreads() == 1);
+    solver.set_parallel(2);
+    solver.set_parallel_auto_tune(true);
+    MocoSolution tuned = study.solve();
+    CHECK(tuned.getNumThreads() >= 1);
+    CHECK(tuned.getNumThreads() <= 2);
+    CHECK(tuned.isNumericallyEqual(serial, 1e-6));
+    // The choice is written to the solution file's header.
+    tuned.write("testMocoInterface_parallel_auto_tune.sto");
+    TimeSeriesTable table("testMocoInterface_parallel_auto_tune.sto");
+    CHECK(std::stoi(table.getTableMetaData<std::string>("num_threads")) ==
+            tuned.getNumThreads());
+}
+
+/// A force that applies no force but takes a while to compute, so that
+/// evaluating the multibody system is expensive.
+class SlowForce : public Force {
+    OpenSim_DECLARE_CONCRETE_OBJECT(SlowForce, Force);
+
+public:
+    void computeForce(const SimTK::State&,
+            SimTK::Vector_<SimTK::SpatialVec>&,
+            SimTK::Vector&) const override {
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+};
+
+TEST_CASE("MocoCasADiSolver parallel_auto_tune chooses threads") {
+    // Evaluating the multibody system takes much longer than creating a
+    // thread, so the tuning must choose all the threads it is given. The
+    // threads sleep, so this holds regardless of the number of hardware
+    // threads.
+    MocoThreadBudget::setNumCores(2);
+    MocoStudy study = createSlidingMassMocoStudy<MocoCasADiSolver>();
+    auto& problem = study.updProblem();
+    auto model = createSlidingMassModel();
+    model->addForce(new SlowForce());
+    problem.setModel(std::move(model));
+    auto& solver = study.updSolver<MocoCasADiSolver>();
+    solver.set_num_mesh_intervals(5);
+    solver.set_optim_max_iterations(1);
+    solver.set_parallel(2);
+    solver.set_parallel_auto_tune(true);
+    MocoSolution solution = study.solve();
+    solution.unseal();
+    CHECK(solution.getNumThreads() == 2);
+    MocoThreadBudget::setNumCores(-1);
+}
+
+TEST_CASE("MocoSolution function evaluation counts") {
+    MocoStudy study = createSlidingMassMocoStudy<MocoCasADiSolver>();
+    MocoSolution solution = study.solve();
+    REQUIRE(solution.success());
+    const auto names = solution.getFunctionEvaluationNames();
+    REQUIRE(!names.empty());
+    CHECK(std::find(names.begin(), names.end(), "nlp_f") != names.end());
+    CHECK(solution.getNumFunctionEvaluations("nlp_f") > 0);
+    CHECK_THROWS_WITH(solution.getNumFunctionEvaluations("nonexistent"),
+            Catch::Contains("No function evaluation count for 'nonexistent'"));
+
+    // The counts are written to the header as num_evaluations_<name>, and
+    // are read back when MocoStudy loads a solution from its cache.
+    const std::string cacheDir = "testMocoInterface_function_evaluations";
+    study.setCacheDir(cacheDir);
+    const std::string cacheFile =
+            cacheDir + "/" + study.calcCacheKey() + ".sto";
+    std::remove(cacheFile.c_str());
+    study.solve();
+    REQUIRE(std::ifstream(cacheFile).good());
+    MocoSolution deserialized = study.solve();
+    REQUIRE(deserialized.success());
+    REQUIRE(deserialized.getFunctionEvaluationNames().size() == names.size());
+    for (const auto& name : names) {
+        CHECK(deserialized.getNumFunctionEvaluations(name) ==
+                solution.getNumFunctionEvaluations(name));
+    }
+}
+
+TEST_CASE("MocoStudy solution cache") {
+    MocoStudy study = createSlidingMassMocoStudy<MocoCasADiSolver>();
+    const std::string cacheDir = "testMocoInterface_cache";
+    study.setCacheDir(cacheDir);
+    const std::string key = study.calcCacheKey();
+    const std::string cacheFile = cacheDir + "/" + key + ".sto";
+    std::remove(cacheFile.c_str());
+
+    MocoSolution solved = study.solve();
+    REQUIRE(std::ifstream(cacheFile).good());
+    MocoSolution cached = study.solve();
+    CHECK(cached.success());
+    CHECK(cached.isNumericallyEqual(solved, 1e-6));
+    CHECK(cached.getStatus() == solved.getStatus());
+    CHECK(cached.getNumIterations() == solved.getNumIterations());
+    CHECK(cached.getObjective() == Approx(solved.getObjective()));
+    CHECK(cached.getObjectiveTermNames() == solved.getObjectiveTermNames());
+
+    // Where the solution is written is not part of the key, but the solver
+    // settings and the guess are.
+    study.set_write_solution("testMocoInterface_cache_output");
+    CHECK(study.calcCacheKey() == key);
+    auto& solver = study.updSolver<MocoCasADiSolver>();
+    solver.set_num_mesh_intervals(20);
+    const std::string meshKey = study.calcCacheKey();
+    CHECK(meshKey != key);
+    solver.setGuess(solved);
+    CHECK(study.calcCacheKey() != meshKey);
+
+    // Reference data held in memory outside of properties is not part of
+    // the key, so such studies are not cached.
+    {
+        auto model = createSlidingMassModel();
+        model->addMarker(new Marker("marker",
+                model->getComponent<Body>("body"), SimTK::Vec3(0)));
+        TimeSeriesTable_<SimTK::Vec3> markers;
+        markers.setColumnLabels({"marker"});
+        for (int i = 0; i <= 10; ++i) {
+            markers.appendRow(0.1 * i, SimTK::RowVector_<SimTK::Vec3>(
+                                               1, SimTK::Vec3(0.05 * i, 0, 0)));
+        }
+        MocoStudy markerStudy;
+        markerStudy.set_write_solution("false");
+        MocoProblem& problem = markerStudy.updProblem();
+        problem.setModel(std::move(model));
+        problem.setTimeBounds(0, 1);
+        problem.setStateInfo("/slider/position/value", {-5, 5});
+        problem.setStateInfo("/slider/position/speed", {-50, 50});
+        auto* tracking = problem.addGoal<MocoMarkerTrackingGoal>();
+        tracking->setMarkersReference(
+                MarkersReference(markers, Set<MarkerWeight>()));
+        markerStudy.initCasADiSolver().set_num_mesh_intervals(10);
+        markerStudy.setCacheDir(cacheDir);
+        const std::string markerCacheFile =
+                cacheDir + "/" + markerStudy.calcCacheKey() + ".sto";
+        std::remove(markerCacheFile.c_str());
+        CHECK(markerStudy.solve().success());
+        CHECK_FALSE(std::ifstream(markerCacheFile).good());
+    }
+
+    // The key includes data files referenced from within other files.
+    {
+        const std::string dataFile = "testMocoInterface_cache_loads.mot";
+        const std::string loadsFile = "testMocoInterface_cache_loads.xml";
+        auto writeData = [&dataFile](double value) {
+            std::ofstream stream(dataFile);
+            stream << value << std::endl;
+        };
+        writeData(1);
+        ExternalLoads loads;
+        loads.setDataFileName(dataFile);
+        loads.print(loadsFile);
+        MocoStudy loadsStudy = createSlidingMassMocoStudy<MocoCasADiSolver>();
+        loadsStudy.updProblem().setModelProcessor(
+                ModelProcessor(*createSlidingMassModel()) |
+                ModOpAddExternalLoads(loadsFile));
+        const std::string loadsKey = loadsStudy.calcCacheKey();
+        writeData(2);
+        CHECK(loadsStudy.calcCacheKey() != loadsKey);
+    }
+}
+
+TEMPLATE_TEST_CASE("scale_variables_and_constraints", "", MocoTropterSolver,
+        MocoCasADiSolver) {
+    MocoStudy study = createSlidingMassMocoStudy<TestType>();
+    auto& solver = study.updSolver<TestType>();
+    solver.set_scale_variables_and_constraints(false);
+    MocoSolution unscaled = study.solve();
+    REQUIRE(unscaled.success());
+    solver.set_scale_variables_and_constraints(true);
+    MocoSolution scaled = study.solve();
+    REQUIRE(scaled.success());
+    // Scaling changes how the optimizer reaches the solution, not the
+    // solution itself. The number of iterations depends on the problem and
+    // the optimizer, so it is not checked.
+    CHECK(scaled.isNumericallyEqual(unscaled, 1e-5));
+    CHECK(scaled.getObjective() == Approx(unscaled.getObjective()));
+    CHECK(scaled.compareContinuousVariablesRMS(unscaled) < 1e-3);
+
+    // Overriding the scale of a variable does not change the solution.
+    MocoWeightSet scales;
+    scales.cloneAndAppend({"/slider/position/value", 10.0});
+    solver.set_variable_scales(scales);
+    MocoSolution overridden = study.solve();
+    REQUIRE(overridden.success());
+    CHECK(overridden.isNumericallyEqual(unscaled, 1e-5));
+    CHECK(overridden.getObjective() == Approx(unscaled.getObjective()));
+}
+
 TEMPLATE_TEST_CASE("Solving an empty MocoProblem", "", MocoTropterSolver,
         MocoCasADiSolver) {
     MocoStudy study;
@@ -1968,6 +2254,188 @@ TEST_CASE("solveBisection()") {
     }
 }
 
+TEST_CASE("simulateTrajectoriesWithTimeStepping()") {
+    // The sliding mass (10 kg) starts from rest under a constant force, so
+    // x(t) = 0.5 * (F / m) * t^2.
+    auto model = createSlidingMassModel();
+    const double mass = 10.0;
+    const std::vector<double> forces{1.0, -2.5, 4.0};
+    std::vector<MocoTrajectory> trajectories;
+    for (const auto& force : forces) {
+        const int N = 11;
+        trajectories.emplace_back(createVectorLinspace(N, 0, 1),
+                std::map<std::string,
+                        MocoTrajectory::NamesAndData<SimTK::Matrix>>{
+                        {"states", {{"/slider/position/value",
+                                            "/slider/position/speed"},
+                                           SimTK::Matrix(N, 2, 0.0)}},
+                        {"controls",
+                                {{"/actuator"}, SimTK::Matrix(N, 1, force)}}});
+    }
+
+    SECTION("Report at trajectory times") {
+        const auto results = simulateTrajectoriesWithTimeStepping(
+                trajectories, *model, 1e-8, true, 2);
+        REQUIRE(results.size() == forces.size());
+        for (int i = 0; i < (int)forces.size(); ++i) {
+            const auto& time = results[i].getTime();
+            SimTK_TEST_EQ(time, trajectories[i].getTime());
+            const auto position =
+                    results[i].getState("/slider/position/value");
+            for (int itime = 0; itime < time.size(); ++itime) {
+                CHECK(position[itime] ==
+                        Approx(0.5 * forces[i] / mass *
+                                SimTK::square(time[itime]))
+                                .margin(1e-6));
+            }
+            SimTK_TEST_EQ(results[i].getControl("/actuator"),
+                    SimTK::Vector(time.size(), forces[i]));
+        }
+    }
+
+    SECTION("Batch matches a single simulation") {
+        const auto results = simulateTrajectoriesWithTimeStepping(
+                trajectories, *model);
+        for (int i = 0; i < (int)forces.size(); ++i) {
+            const auto single =
+                    simulateTrajectoryWithTimeStepping(trajectories[i], *model);
+            CHECK(results[i].compareContinuousVariablesRMS(
+                          single, {{"states", {}}}) < 1e-6);
+        }
+    }
+}
+
+TEST_CASE("analyze() in parallel") {
+    auto model = createSlidingMassModel();
+    const int N = 23;
+    const auto time = createVectorLinspace(N, 0, 1);
+    SimTK::Matrix states(N, 2);
+    states.updCol(0) = createVectorLinspace(N, 0.1, 0.7);
+    states.updCol(1) = createVectorLinspace(N, -1.0, 2.0);
+    MocoTrajectory traj(time,
+            {{"states",
+                     {{"/slider/position/value", "/slider/position/speed"},
+                             states}},
+                    {"controls", {{"/actuator"},
+                                         SimTK::Matrix(createVectorLinspace(
+                                                 N, -3.0, 5.0))}}});
+    const std::vector<std::string> outputPaths{
+            ".*position\\|value", ".*position\\|speed", ".*actuation"};
+
+    const auto serial = analyze<double>(*model, traj, outputPaths, 1);
+    const auto parallel = analyze<double>(*model, traj, outputPaths, 4);
+    const auto budget = analyze<double>(*model, traj, outputPaths, -1);
+    REQUIRE(serial.getNumColumns() == 3);
+    REQUIRE(serial.getNumRows() == N);
+    CHECK(serial.getColumnLabels() == parallel.getColumnLabels());
+    CHECK(serial.getIndependentColumn() == parallel.getIndependentColumn());
+    SimTK_TEST_EQ(serial.getMatrix(), parallel.getMatrix());
+    SimTK_TEST_EQ(serial.getMatrix(), budget.getMatrix());
+    SimTK_TEST_EQ(serial.getDependentColumn("/slider/position|value"),
+            states.col(0));
+    SimTK_TEST_EQ(serial.getDependentColumn("/actuator|actuation"),
+            createVectorLinspace(N, -3.0, 5.0));
+}
+
+TEST_CASE("MocoThreadBudget") {
+    MocoThreadBudget::setNumCores(4);
+    CHECK(MocoThreadBudget::getNumCores() == 4);
+    if (getMocoParallelEnvironmentVariable() != 0) {
+        CHECK(getMocoNumThreads(-1, 100) == 4);
+    }
+    {
+        auto first = MocoThreadBudget::acquire(3);
+        CHECK(first.getNumThreads() == 3);
+        CHECK(MocoThreadBudget::getNumAvailableCores() == 1);
+        // Later leases get the remaining cores, but always at least 1.
+        auto second = MocoThreadBudget::acquire(-1);
+        CHECK(second.getNumThreads() == 1);
+        auto third = MocoThreadBudget::acquire(2);
+        CHECK(third.getNumThreads() == 1);
+        CHECK(MocoThreadBudget::getNumAvailableCores() == 0);
+        CHECK(MocoThreadBudget::getNumActiveLeases() == 3);
+        third.release();
+        second.release();
+        CHECK(MocoThreadBudget::getNumAvailableCores() == 1);
+        // Moving a lease does not return its cores.
+        auto moved = std::move(first);
+        CHECK(moved.getNumThreads() == 3);
+        CHECK(MocoThreadBudget::getNumAvailableCores() == 1);
+        CHECK(MocoThreadBudget::getNumActiveLeases() == 1);
+    }
+    CHECK(MocoThreadBudget::getNumAvailableCores() == 4);
+    CHECK(MocoThreadBudget::getNumActiveLeases() == 0);
+    CHECK_THROWS(MocoThreadBudget::acquire(0));
+    CHECK_THROWS(MocoThreadBudget::setNumCores(0));
+
+#ifndef _WIN32
+    // The OpenMP thread count is restored when the last lease is released.
+    using GetNumThreads = int (*)();
+    if (auto getOpenMPThreads = reinterpret_cast<GetNumThreads>(
+                dlsym(RTLD_DEFAULT, "omp_get_max_threads"))) {
+        const int previous = getOpenMPThreads();
+        {
+            auto first = MocoThreadBudget::acquire(2);
+            MocoThreadBudget::limitLinearAlgebraThreads(2);
+            auto second = MocoThreadBudget::acquire(2);
+            MocoThreadBudget::limitLinearAlgebraThreads(2);
+            CHECK(getOpenMPThreads() == 1);
+            second.release();
+            CHECK(getOpenMPThreads() == 1);
+        }
+        CHECK(getOpenMPThreads() == previous);
+    }
+#endif
+    MocoThreadBudget::setNumCores(-1);
+}
+
+TEST_CASE("createSharedGCVSplineSet()") {
+    const int N = 20;
+    const auto time = createVectorLinspace(N, 0, 1);
+    SimTK::Matrix data(N, 3);
+    for (int icol = 0; icol < data.ncol(); ++icol) {
+        for (int irow = 0; irow < N; ++irow) {
+            data(irow, icol) = std::sin((icol + 1) * time[irow]);
+        }
+    }
+    const std::vector<double> timeVec(time.getContiguousScalarData(),
+            time.getContiguousScalarData() + N);
+    TimeSeriesTable table(timeVec, data, {"a", "b", "c"});
+
+    const auto splines = createSharedGCVSplineSet(table);
+    // Identical data shares the same splines.
+    CHECK(createSharedGCVSplineSet(TimeSeriesTable(table)) == splines);
+
+    // The splines match those from GCVSplineSet.
+    const GCVSplineSet expected(table);
+    REQUIRE(splines->getSize() == expected.getSize());
+    const SimTK::Vector x(1, 0.37);
+    for (int i = 0; i < expected.getSize(); ++i) {
+        CHECK(splines->get(i).getName() == expected.get(i).getName());
+        CHECK(splines->get(i).calcValue(x) ==
+                Approx(expected.get(i).calcValue(x)));
+    }
+
+    // A different degree or different data gives different splines.
+    CHECK(createSharedGCVSplineSet(table, 3) != splines);
+    table.updMatrix()(3, 1) += 0.1;
+    CHECK(createSharedGCVSplineSet(table) != splines);
+
+    // Threads that request the same splines concurrently share one set.
+    table.updMatrix()(4, 2) += 0.1;
+    std::vector<std::shared_ptr<const GCVSplineSet>> concurrent(4);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < (int)concurrent.size(); ++i) {
+        threads.emplace_back([&concurrent, &table, i]() {
+            concurrent[i] = createSharedGCVSplineSet(table);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (const auto& shared : concurrent) {
+        CHECK(shared == concurrent[0]);
+    }
+}
+
 TEST_CASE("Objective breakdown") {
     class MocoConstantGoal : public MocoGoal {
         OpenSim_DECLARE_CONCRETE_OBJECT(MocoConstantGoal, MocoGoal);
@@ -2001,3 +2469,166 @@ TEST_CASE("Objective breakdown") {
     CHECK(solution.getObjectiveTerm("goal_b") == Approx(0.01 * 7.3));
 }
 
+
+TEST_CASE("Synthetic tracking study") {
+    const int numLinks = 5;
+    Model model = ModelFactory::createSyntheticModel(numLinks, 3, 2, 4);
+    SimTK::State state = model.initSystem();
+    CHECK(model.getCoordinateSet().getSize() == numLinks);
+    CHECK(model.getMuscles().getSize() == 3 * numLinks);
+    CHECK(model.getConstraintSet().getSize() == 2);
+    CHECK(model.countNumComponents<Station>() == 4);
+    CHECK(model.countNumComponents<AckermannVanDenBogert2010Force>() == 4);
+    CHECK_THROWS(ModelFactory::createSyntheticModel(numLinks, 1, 3));
+
+    // The chain's tip touches the ground plane in the default pose.
+    model.realizePosition(state);
+    CHECK(model.getBodySet().get(numLinks - 1).findStationLocationInGround(
+                  state, SimTK::Vec3(0))[1] == Approx(0).margin(1e-10));
+
+    // The reference satisfies the loop constraints.
+    const TimeSeriesTable reference =
+            MocoStudyFactory::createSyntheticReference(numLinks, 2, 1.0, 11);
+    CHECK(reference.getNumColumns() == 2 * numLinks);
+    for (int irow = 0; irow < (int)reference.getNumRows(); ++irow) {
+        for (int i = 0; i < numLinks; ++i) {
+            state.updQ()[i] = reference.getMatrix()(irow, i);
+        }
+        model.realizePosition(state);
+        CHECK(state.getQErr().normInf() == Approx(0).margin(1e-10));
+    }
+
+    MocoStudy study =
+            MocoStudyFactory::createSyntheticTrackingStudy(2, 1, 1, 2, 5);
+    MocoProblemRep rep = study.getProblem().createRep();
+    // 2 coordinates with speeds, and 2 muscle activations.
+    CHECK(rep.getNumStates() == 6);
+    CHECK(rep.getNumKinematicConstraintEquations() > 0);
+}
+
+TEST_CASE("MocoStudy stages") {
+    MocoStudy study =
+            MocoStudyFactory::createSyntheticTrackingStudy(2, 2, 0, 0, 10);
+    study.set_write_solution("false");
+    MocoSolution expected = study.solve();
+    REQUIRE(expected.success());
+
+    MocoStage stage;
+    stage.append_model_operators(ModOpIgnoreActivationDynamics());
+    stage.set_num_mesh_intervals(5);
+    study.append_stages(stage);
+    MocoSolution solution = study.solve();
+    REQUIRE(solution.success());
+    CHECK(solution.getObjective() ==
+            Approx(expected.getObjective()).epsilon(1e-3));
+    CHECK(solution.getNumTimes() == expected.getNumTimes());
+    CHECK(solution.getStateNames() == expected.getStateNames());
+
+    // Stages are serialized.
+    study.print("testMocoInterface_stages.omoco");
+    MocoStudy deserialized("testMocoInterface_stages.omoco");
+    REQUIRE(deserialized.getProperty_stages().size() == 1);
+    CHECK(deserialized.get_stages(0).get_num_mesh_intervals() == 5);
+
+    // With a free final time, each stage's guess spans the duration of the
+    // previous stage's solution (rather than the midpoint of the final time
+    // bounds).
+    {
+        MocoStudy freeTime = createSlidingMassMocoStudy<MocoCasADiSolver>();
+        MocoSolution freeExpected = freeTime.solve();
+        REQUIRE(freeExpected.success());
+        MocoStage coarse;
+        coarse.set_num_mesh_intervals(10);
+        freeTime.append_stages(coarse);
+        freeTime.append_stages(MocoStage());
+        MocoSolution freeSolution = freeTime.solve();
+        REQUIRE(freeSolution.success());
+        CHECK(freeSolution.getFinalTime() ==
+                Approx(freeExpected.getFinalTime()).epsilon(1e-3));
+        CHECK(freeSolution.getObjective() ==
+                Approx(freeExpected.getObjective()).epsilon(1e-3));
+    }
+}
+
+TEST_CASE("MocoCasADiSolver checkpoints") {
+    MocoStudy study = createSlidingMassMocoStudy<MocoCasADiSolver>();
+    study.set_write_solution("false");
+    MocoSolution expected = study.solve();
+    REQUIRE(expected.success());
+
+    // Interrupt the solve with a small iteration limit.
+    const std::string checkpoint = "testMocoInterface_checkpoint.bin";
+    std::remove(checkpoint.c_str());
+    auto& solver = study.updSolver<MocoCasADiSolver>();
+    solver.set_checkpoint_path(checkpoint);
+    solver.set_checkpoint_interval(1);
+    solver.set_optim_max_iterations(3);
+    CHECK(!study.solve().success());
+    REQUIRE(std::ifstream(checkpoint).good());
+
+    SECTION("Resume") {
+        solver.set_optim_max_iterations(-1);
+        solver.set_resume_from_checkpoint(true);
+        MocoSolution resumed = study.solve();
+        REQUIRE(resumed.success());
+        CHECK(resumed.getObjective() ==
+                Approx(expected.getObjective()).epsilon(1e-4));
+        CHECK(resumed.compareContinuousVariablesRMS(expected) < 1e-3);
+        // The checkpoint is removed after a successful solve.
+        CHECK(!std::ifstream(checkpoint).good());
+    }
+
+    SECTION("Different mesh") {
+        solver.set_num_mesh_intervals(solver.get_num_mesh_intervals() + 5);
+        solver.set_resume_from_checkpoint(true);
+        CHECK_THROWS_WITH(study.solve(),
+                Catch::Contains("was created for a different problem"));
+    }
+
+    SECTION("checkpoint_interval is only used with checkpoint_path") {
+        solver.set_optim_max_iterations(-1);
+        solver.set_checkpoint_interval(0);
+        CHECK_THROWS_WITH(study.solve(),
+                Catch::Contains("Expected checkpoint_interval to be positive"));
+        solver.set_checkpoint_path("");
+        CHECK(study.solve().success());
+        std::remove(checkpoint.c_str());
+    }
+}
+
+TEST_CASE("MocoCasADiSolver parallel jar with file-backed goal") {
+    // Each thread's MocoProblemRep initializes its own copy of the tracking
+    // goal, which reads and filters the reference file.
+    const std::string fname = "testMocoInterface_parallel_jar_ref.sto";
+    {
+        TimeSeriesTable ref;
+        ref.setColumnLabels({"/slider/position/value"});
+        for (double time = -0.01; time < 1.02; time += 0.01) {
+            ref.appendRow(time, {time});
+        }
+        STOFileAdapter::write(ref, fname);
+    }
+    auto solve = [&fname](int parallel) {
+        MocoStudy study;
+        study.setName("parallel_jar");
+        study.set_write_solution("false");
+        MocoProblem& mp = study.updProblem();
+        mp.setModel(createSlidingMassModel());
+        mp.setTimeBounds(0, 1);
+        mp.setStateInfo("/slider/position/value", {-1, 1});
+        mp.setStateInfo("/slider/position/speed", {-100, 100});
+        mp.setControlInfo("/actuator", {-50, 50});
+        auto* tracking = mp.addGoal<MocoStateTrackingGoal>();
+        tracking->setReference(TableProcessor(fname) | TabOpLowPassFilter(6));
+        auto& solver = study.initCasADiSolver();
+        solver.set_num_mesh_intervals(10);
+        solver.set_parallel(parallel);
+        return study.solve();
+    };
+    MocoSolution serial = solve(0);
+    MocoSolution parallel = solve(4);
+    REQUIRE(serial.success());
+    REQUIRE(parallel.success());
+    CHECK(parallel.getNumThreads() == 4);
+    CHECK(parallel.isNumericallyEqual(serial, 1e-6));
+}
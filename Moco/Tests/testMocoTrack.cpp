@@ -69,4 +69,78 @@ TEST_CASE("MocoTrack gait10dof18musc") {
     const auto expected = std.getControlsTrajectory();
     CHECK(std.compareContinuousVariablesRMS(
             solution, {{"controls",{}}}) < 1e-2);
-}
\ No newline at end of file
+}
+
+TEST_CASE("MocoTrack receding horizon") {
+    MocoTrack track;
+    track.setName("testMocoTrack_receding_horizon");
+    track.setModel(ModelProcessor(ModelFactory::createSyntheticModel(2, 1)));
+    track.setStatesReference(
+            MocoStudyFactory::createSyntheticReference(2, 0, 1.0, 51));
+    track.set_mesh_interval(0.05);
+    track.set_window_duration(0.3);
+    track.set_window_step(0.1);
+
+    const std::string solutionFile =
+            "testMocoTrack_receding_horizon_solution.sto";
+    std::remove(solutionFile.c_str());
+    std::vector<MocoTrajectory> segments;
+    MocoSolution solution = track.solveRecedingHorizon(
+            [&](const MocoTrajectory& segment) {
+                segments.push_back(segment);
+            });
+    REQUIRE(solution.success());
+
+    // Windows start at 0, 0.1, ..., 0.7; the last window ends at 1.
+    REQUIRE(segments.size() == 8);
+    int numTimes = 0;
+    for (int i = 0; i < (int)segments.size(); ++i) {
+        numTimes += segments[i].getNumTimes();
+        if (i > 0) {
+            CHECK(segments[i].getInitialTime() >
+                    segments[i - 1].getFinalTime());
+        }
+    }
+    CHECK(solution.getNumTimes() == numTimes);
+    CHECK(solution.getInitialTime() == Approx(0));
+    CHECK(solution.getFinalTime() == Approx(1));
+
+    // Each window starts from the state of the previous window, so the
+    // states are continuous across the boundaries between segments: the
+    // coordinate values and speeds satisfy the Hermite-Simpson kinematic
+    // relation over the mesh interval that ends at each boundary.
+    const SimTK::Vector& time = solution.getTime();
+    int boundary = 0;
+    for (int i = 0; i + 1 < (int)segments.size(); ++i) {
+        boundary += segments[i].getNumTimes();
+        const double h = time[boundary] - time[boundary - 2];
+        for (const auto& name : solution.getStateNames()) {
+            if (!endsWith(name, "/value")) continue;
+            const SimTK::Vector q = solution.getState(name);
+            const SimTK::Vector u = solution.getState(
+                    name.substr(0, name.size() - 6) + "/speed");
+            CHECK(q[boundary] - q[boundary - 2] ==
+                    Approx(h / 6 * (u[boundary - 2] + 4 * u[boundary - 1] +
+                                           u[boundary]))
+                            .margin(1e-3));
+        }
+    }
+
+    // Only the stitched solution is written.
+    MocoTrajectory written(solutionFile);
+    CHECK(written.getNumTimes() == numTimes);
+    CHECK(written.compareContinuousVariablesRMS(solution) < 1e-6);
+
+    // The stitched solution tracks the reference about as well as solving
+    // the entire trial at once.
+    MocoTrack full(track);
+    full.set_window_duration(-1);
+    MocoSolution expected = full.solve();
+    REQUIRE(expected.success());
+    CHECK(solution.compareContinuousVariablesRMS(
+                  expected, {{"states", {}}}) < 1e-2);
+
+    track.set_window_step(0.5);
+    CHECK_THROWS_WITH(track.solve(),
+            Catch::Contains("Expected window_step to be at most"));
+}
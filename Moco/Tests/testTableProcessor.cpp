@@ -60,6 +60,72 @@ TEST_CASE("TableProcessor") {
         CHECK(proc.process().getNumRows() == 4);
     }
 
+    SECTION("TabOpLowPassFilter matches Storage::lowpassIIR()") {
+        const int N = 200;
+        const auto time = createVectorLinspace(N, 0, 0.199);
+        SimTK::Matrix data(N, 5);
+        for (int icol = 0; icol < data.ncol(); ++icol) {
+            for (int irow = 0; irow < N; ++irow) {
+                data(irow, icol) = std::sin(2 * SimTK::Pi * (icol + 1) *
+                                           time[irow]) +
+                                   0.1 * std::sin(2 * SimTK::Pi * 150 *
+                                                 time[irow]);
+            }
+        }
+        const std::vector<double> timeVec(time.getContiguousScalarData(),
+                time.getContiguousScalarData() + N);
+        TimeSeriesTable noisy(timeVec, data, {"a", "b", "c", "d", "e"});
+
+        Storage sto = convertTableToStorage(noisy);
+        sto.pad(N / 2);
+        sto.lowpassIIR(6);
+        const TimeSeriesTable expected = sto.exportToTable();
+
+        const TimeSeriesTable filtered =
+                (TableProcessor(noisy) | TabOpLowPassFilter(6)).process();
+        REQUIRE(filtered.getNumRows() == expected.getNumRows());
+        SimTK_TEST_EQ_TOL(filtered.getMatrix(), expected.getMatrix(), 1e-10);
+        SimTK_TEST_EQ_TOL(SimTK::Vector((int)filtered.getNumRows(),
+                                  filtered.getIndependentColumn().data()),
+                SimTK::Vector((int)expected.getNumRows(),
+                        expected.getIndependentColumn().data()),
+                1e-10);
+        SimTK_TEST_EQ_TOL(filterLowpass(noisy, 6, true).getMatrix(),
+                expected.getMatrix(), 1e-10);
+
+        // Consecutive filters are fused into a single pass but give the same
+        // result as filtering twice.
+        const TimeSeriesTable twice =
+                (TableProcessor(noisy) | TabOpLowPassFilter(6) |
+                        TabOpLowPassFilter(6))
+                        .process();
+        SimTK_TEST_EQ_TOL(twice.getMatrix(),
+                filterLowpass(filterLowpass(noisy, 6, true), 6, true)
+                        .getMatrix(),
+                1e-10);
+
+        // As with Storage::lowpassIIR(), a cutoff frequency at or above half
+        // the sampling frequency only warns, and the (padded) data is left
+        // unfiltered.
+        SimTK::Matrix unfiltered(2 * N, data.ncol());
+        for (int icol = 0; icol < data.ncol(); ++icol) {
+            std::vector<double> column(N);
+            for (int irow = 0; irow < N; ++irow) {
+                column[irow] = data(irow, icol);
+            }
+            padSignal(N / 2, column);
+            for (int irow = 0; irow < 2 * N; ++irow) {
+                unfiltered(irow, icol) = column[irow];
+            }
+        }
+        const TimeSeriesTable highCutoff =
+                (TableProcessor(noisy) | TabOpLowPassFilter(600)).process();
+        REQUIRE(highCutoff.getNumRows() == 2 * N);
+        SimTK_TEST_EQ_TOL(highCutoff.getMatrix(), unfiltered, 1e-10);
+        SimTK_TEST_EQ_TOL(
+                filterLowpass(noisy, 600, true).getMatrix(), unfiltered, 1e-10);
+    }
+
     SECTION("Serialization") {
         writeTableToFile(table, "testTableProcessor_table.sto");
         {
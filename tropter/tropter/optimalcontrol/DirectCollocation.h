@@ -20,6 +20,7 @@
 #include "Problem.h"
 #include "Iterate.h"
 #include <fstream>
+#include <map>
 #include <memory>
 
 namespace tropter {
@@ -100,6 +101,15 @@ public:
     bool get_interpolate_control_midpoints() const
     { return m_interpolate_control_midpoints; }
 
+    /// Scale the optimization variables and defect constraints; scales are
+    /// computed from the variable bounds and the initial guess, and
+    /// `variable_scales` overrides the scales of the variables with the
+    /// given names. This setting is copied into the underlying transcription
+    /// scheme (see transcription::Base::calc_scaling()). Only IPOPT supports
+    /// scaling. Default: false.
+    void set_scaling(bool scale_variables_and_constraints,
+            std::map<std::string, double> variable_scales = {});
+
     /// Solve the problem using an initial guess that is based on the bounds
     /// on the variables.
     Solution solve() const;
@@ -92,6 +92,14 @@ void DirectCollocationSolver<T>::set_interpolate_control_midpoints(bool tf) {
     m_interpolate_control_midpoints = tf;
 }
 
+template<typename T>
+void DirectCollocationSolver<T>::set_scaling(
+        bool scale_variables_and_constraints,
+        std::map<std::string, double> variable_scales) {
+    m_transcription->set_scaling(
+            scale_variables_and_constraints, std::move(variable_scales));
+}
+
 template<typename T>
 Solution DirectCollocationSolver<T>::solve() const
 {
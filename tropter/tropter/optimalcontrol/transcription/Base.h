@@ -21,6 +21,10 @@
 #include <tropter/optimization/ProblemDecorator_adouble.h>
 #include <tropter/optimalcontrol/Iterate.h>
 
+#include <cmath>
+#include <limits>
+#include <map>
+
 //namespace transcription {
 //
 //class Trapezoidal;
@@ -96,8 +100,114 @@ public:
     std::string get_exact_hessian_block_sparsity_mode () const
     {   return m_exact_hessian_block_sparsity_mode; }
 
+    /// Scale the variables and the defect constraints (see
+    /// calc_scaling()). Scales in `variable_scales`, keyed by the name of a
+    /// state, control, adjunct, diffuse, or parameter (or "initial_time" or
+    /// "final_time"), override the computed scales.
+    void set_scaling(bool scale_variables_and_constraints,
+            std::map<std::string, double> variable_scales = {}) {
+        m_scale_variables_and_constraints = scale_variables_and_constraints;
+        m_variable_scales = std::move(variable_scales);
+    }
+    /// @copydoc set_scaling()
+    bool get_scale_variables_and_constraints() const
+    {   return m_scale_variables_and_constraints; }
+
+    /// If scaling is enabled, the scale of a variable is the range of its
+    /// bounds (across the trajectory) if the bounds are finite; otherwise,
+    /// it is the largest magnitude of the variable in the guess (or 1 if
+    /// that magnitude is 0). Defect constraints are scaled by the scales of
+    /// their states, and other constraints are not scaled.
+    void calc_scaling(const Eigen::VectorXd& guess,
+            Eigen::VectorXd& variable_scales,
+            Eigen::VectorXd& constraint_scales) const override {
+        if (!m_scale_variables_and_constraints) return;
+        const Iterate lower =
+                deconstruct_iterate(this->get_variable_lower_bounds());
+        const Iterate upper =
+                deconstruct_iterate(this->get_variable_upper_bounds());
+        const Iterate values = deconstruct_iterate(guess);
+        Iterate scales = values;
+        auto set_row_scales = [this](const std::vector<std::string>& names,
+                const Eigen::MatrixXd& lower, const Eigen::MatrixXd& upper,
+                const Eigen::MatrixXd& values, Eigen::MatrixXd& scales) {
+            for (int i = 0; i < (int)scales.rows(); ++i) {
+                scales.row(i).setConstant(calc_scale(names[i],
+                        lower.row(i), upper.row(i), values.row(i)));
+            }
+        };
+        set_row_scales(values.state_names, lower.states, upper.states,
+                values.states, scales.states);
+        set_row_scales(values.control_names, lower.controls, upper.controls,
+                values.controls, scales.controls);
+        set_row_scales(values.adjunct_names, lower.adjuncts, upper.adjuncts,
+                values.adjuncts, scales.adjuncts);
+        set_row_scales(values.diffuse_names, lower.diffuses, upper.diffuses,
+                values.diffuses, scales.diffuses);
+        for (int i = 0; i < (int)scales.parameters.size(); ++i) {
+            scales.parameters[i] = calc_scale(values.parameter_names[i],
+                    lower.parameters.row(i), upper.parameters.row(i),
+                    values.parameters.row(i));
+        }
+        variable_scales = construct_iterate(scales);
+        // The first two variables are the initial and final time.
+        const auto& lower_bounds = this->get_variable_lower_bounds();
+        const auto& upper_bounds = this->get_variable_upper_bounds();
+        variable_scales[0] = calc_scale("initial_time",
+                lower_bounds.segment(0, 1), upper_bounds.segment(0, 1),
+                guess.segment(0, 1));
+        variable_scales[1] = calc_scale("final_time",
+                lower_bounds.segment(1, 1), upper_bounds.segment(1, 1),
+                guess.segment(1, 1));
+        constraint_scales = calc_constraint_scales(scales);
+    }
+
+protected:
+    /// Compute the scales for the constraints given the scales of the
+    /// variables (see calc_scaling()). The default implementation does not
+    /// scale the constraints.
+    virtual Eigen::VectorXd calc_constraint_scales(
+            const Iterate& /*variable_scales*/) const {
+        return Eigen::VectorXd::Ones(this->get_num_constraints());
+    }
+
 private:
+    /// The values may contain NaNs (e.g., diffuses at mesh points), which are
+    /// ignored.
+    template <typename TLower, typename TUpper, typename TValues>
+    double calc_scale(const std::string& name, const TLower& lower,
+            const TUpper& upper, const TValues& values) const {
+        const auto it = m_variable_scales.find(name);
+        if (it != m_variable_scales.end()) {
+            TROPTER_THROW_IF(it->second <= 0,
+                    "Expected the scale for variable '%s' to be positive, "
+                    "but got %g.", name, it->second);
+            return it->second;
+        }
+        const double inf = std::numeric_limits<double>::infinity();
+        double min_lower = inf;
+        double max_upper = -inf;
+        double magnitude = 0;
+        for (int i = 0; i < (int)values.size(); ++i) {
+            if (!std::isnan(lower[i])) {
+                min_lower = std::min(min_lower, lower[i]);
+            }
+            if (!std::isnan(upper[i])) {
+                max_upper = std::max(max_upper, upper[i]);
+            }
+            if (!std::isnan(values[i])) {
+                magnitude = std::max(magnitude, std::abs(values[i]));
+            }
+        }
+        const double range = max_upper - min_lower;
+        if (std::isfinite(range) && range > 0) return range;
+        if (std::isfinite(magnitude) && magnitude > 0) return magnitude;
+        return 1;
+    }
+
     std::string m_exact_hessian_block_sparsity_mode{"dense"};
+    bool m_scale_variables_and_constraints = false;
+    std::map<std::string, double> m_variable_scales;
 
 };
 
@@ -666,6 +666,25 @@ std::vector<std::string> HermiteSimpson<T>::get_constraint_names() const {
     return m_constraint_names;
 }
 
+template <typename T>
+Eigen::VectorXd HermiteSimpson<T>::calc_constraint_scales(
+        const Iterate& variable_scales) const {
+    Eigen::VectorXd scales = Eigen::VectorXd::Ones(this->get_num_constraints());
+    if (m_num_defects) {
+        // Each column of defects contains the Hermite interpolant defects
+        // followed by the Simpson integration defects for all states.
+        scales.head(m_num_dynamics_constraints) =
+                variable_scales.states.col(0).replicate(m_num_defects, 1);
+    }
+    if (m_num_controls && m_interpolate_control_midpoints) {
+        scales.segment(m_num_dynamics_constraints + m_num_path_traj_constraints,
+                m_num_controls * m_num_mesh_intervals) =
+                variable_scales.controls.col(0).replicate(
+                        m_num_mesh_intervals, 1);
+    }
+    return scales;
+}
+
 template <typename T>
 Eigen::RowVectorXd HermiteSimpson<T>::get_diffuse_times(
         const Eigen::RowVectorXd& time) const {
@@ -102,6 +102,9 @@ public:
             std::ostream& stream = std::cout) const override;
 
 protected:
+    Eigen::VectorXd calc_constraint_scales(
+            const Iterate& variable_scales) const override;
+
     /// Eigen::Map is a view on other data, and allows "slicing" so that we can
     /// view part of the vector of unknowns as a matrix of either (num_states x
     /// num_mesh_points) or (num_states x num_col_points).
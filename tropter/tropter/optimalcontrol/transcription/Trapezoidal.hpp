@@ -569,6 +569,18 @@ std::vector<std::string> Trapezoidal<T>::get_constraint_names() const {
     return m_constraint_names;
 }
 
+template <typename T>
+Eigen::VectorXd Trapezoidal<T>::calc_constraint_scales(
+        const Iterate& variable_scales) const {
+    Eigen::VectorXd scales = Eigen::VectorXd::Ones(this->get_num_constraints());
+    if (m_num_defects) {
+        // Each column of defects contains one defect for each state.
+        scales.head(m_num_dynamics_constraints) =
+                variable_scales.states.col(0).replicate(m_num_defects, 1);
+    }
+    return scales;
+}
+
 template <typename T>
 Eigen::VectorXd Trapezoidal<T>::construct_iterate(
         const Iterate& traj, bool interpolate) const {
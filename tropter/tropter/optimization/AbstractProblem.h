@@ -111,6 +111,16 @@ public:
 
     class CalcSparsityHessianLagrangianNotImplemented : public Exception {};
 
+    /// Compute the typical magnitude of each variable and constraint, for
+    /// solvers that support scaling the problem (IPOPT). The solver works
+    /// with each variable and constraint divided by its scale, and the
+    /// solution is unscaled. The guess is the initial guess for the
+    /// optimization. If the vectors are left empty (the default), the
+    /// problem is not scaled.
+    virtual void calc_scaling(const Eigen::VectorXd& guess,
+            Eigen::VectorXd& variable_scales,
+            Eigen::VectorXd& constraint_scales) const;
+
     virtual std::unique_ptr<ProblemDecorator>
     make_decorator() const = 0;
 
@@ -161,6 +171,8 @@ inline void AbstractProblem::calc_sparsity_hessian_lagrangian(
         SymmetricSparsityPattern&) const {
     throw CalcSparsityHessianLagrangianNotImplemented();
 }
+inline void AbstractProblem::calc_scaling(const Eigen::VectorXd&,
+        Eigen::VectorXd&, Eigen::VectorXd&) const {}
 inline Eigen::VectorXd
 AbstractProblem::make_initial_guess_from_bounds() const
 {
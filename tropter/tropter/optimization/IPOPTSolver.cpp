@@ -41,6 +41,13 @@ public:
     const double& get_optimal_objective_value() const
     {   return m_optimal_obj_value; }
     const int& get_num_iterations() const { return m_num_iterations; }
+    /// Use the scales from ProblemDecorator::calc_scaling(). This has an
+    /// effect only if the "nlp_scaling_method" option is "user-scaling".
+    void set_scaling(Eigen::VectorXd variable_scales,
+            Eigen::VectorXd constraint_scales) {
+        m_variable_scales = std::move(variable_scales);
+        m_constraint_scales = std::move(constraint_scales);
+    }
 private:
     // TODO move to Problem if more than one solver would need this.
     // TODO should use fancy arguments to avoid temporaries and to exploit
@@ -62,6 +69,10 @@ private:
 
     // z: multipliers for bound constraints on x.
     // warmstart will require giving initial values for the multipliers.
+    bool get_scaling_parameters(Number& obj_scaling, bool& use_x_scaling,
+            Index num_variables, Number* x_scaling, bool& use_g_scaling,
+            Index num_constraints, Number* g_scaling) override;
+
     bool get_starting_point(Index num_variables, bool init_x, Number* x,
                             bool init_z, Number* z_L, Number* z_U,
                             Index num_constraints, bool init_lambda,
@@ -117,6 +128,8 @@ private:
     unsigned m_num_constraints = std::numeric_limits<unsigned>::max();
 
     Eigen::VectorXd m_initial_guess;
+    Eigen::VectorXd m_variable_scales;
+    Eigen::VectorXd m_constraint_scales;
     Eigen::VectorXd m_solution;
     double m_optimal_obj_value = std::numeric_limits<double>::quiet_NaN();
     int m_num_iterations = -1;
@@ -270,6 +283,16 @@ Solution IPOPTSolver::optimize_impl(const VectorXd& guess) const {
             need_exact_hessian, hessian_sparsity);
     nlp->initialize(guess, std::move(jacobian_sparsity),
             std::move(hessian_sparsity));
+    {
+        VectorXd variable_scales;
+        VectorXd constraint_scales;
+        m_problem->calc_scaling(guess, variable_scales, constraint_scales);
+        if (variable_scales.size() || constraint_scales.size()) {
+            ipoptions->SetStringValue("nlp_scaling_method", "user-scaling");
+            nlp->set_scaling(
+                    std::move(variable_scales), std::move(constraint_scales));
+        }
+    }
 
     // Optimize!!!
     // -----------
@@ -334,6 +357,28 @@ void IPOPTSolver::TNLP::initialize(const VectorXd& guess,
     m_hessian_num_nonzeros = (unsigned)m_hessian_sparsity.row.size();
 }
 
+bool IPOPTSolver::TNLP::get_scaling_parameters(Number& obj_scaling,
+        bool& use_x_scaling, Index num_variables, Number* x_scaling,
+        bool& use_g_scaling, Index num_constraints, Number* g_scaling) {
+    // Ipopt multiplies each variable and constraint by its scaling factor.
+    obj_scaling = 1;
+    use_x_scaling = m_variable_scales.size() != 0;
+    if (use_x_scaling) {
+        assert(m_variable_scales.size() == num_variables);
+        for (Index ivar = 0; ivar < num_variables; ++ivar) {
+            x_scaling[ivar] = 1.0 / m_variable_scales[ivar];
+        }
+    }
+    use_g_scaling = m_constraint_scales.size() != 0;
+    if (use_g_scaling) {
+        assert(m_constraint_scales.size() == num_constraints);
+        for (Index icon = 0; icon < num_constraints; ++icon) {
+            g_scaling[icon] = 1.0 / m_constraint_scales[icon];
+        }
+    }
+    return true;
+}
+
 bool IPOPTSolver::TNLP::get_bounds_info(
         Index num_variables, Number* x_lower, Number* x_upper,
         Index num_constraints, Number* g_lower, Number* g_upper) {
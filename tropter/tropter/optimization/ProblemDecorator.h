@@ -67,6 +67,11 @@ public:
     /// @see AbstractOptimizationProblem::make_random_iterate_within_bounds()
     Eigen::VectorXd make_random_iterate_within_bounds() const
     {   return m_problem.make_random_iterate_within_bounds(); }
+    /// @see AbstractProblem::calc_scaling()
+    void calc_scaling(const Eigen::VectorXd& guess,
+            Eigen::VectorXd& variable_scales,
+            Eigen::VectorXd& constraint_scales) const
+    {   m_problem.calc_scaling(guess, variable_scales, constraint_scales); }
     /// This function determines the sparsity pattern of the Jacobian and
     /// Hessian, using the provided variables.
     /// You must call this function first before calling calc_objective(),